@@ -19,11 +19,13 @@ function(add_post_build_commands target glslDirectory spvDirectory assetsDirecto
         endif (symlinksSupported)
     endif (symlinks)
 
-    # shaders
-    make_shader_target("${target}_shaders"
-        ${target}
-        ${glslDirectory}
-        ${spvDirectory})
+    # shaders (targets without shaders, e.g. console tools, pass empty directories)
+    if (glslDirectory)
+        make_shader_target("${target}_shaders"
+            ${target}
+            ${glslDirectory}
+            ${spvDirectory})
+    endif (glslDirectory)
 
     # assets
     if (assets)
@@ -0,0 +1,233 @@
+#include <gvk.hpp>
+
+// Headless tool which inspects, verifies, and compacts cache files.
+// Usage: cache_tool <command> <file>
+//  info     Prints the header of a cache_file or of a serializer cache file
+//  list     Lists the entries of a cache_file with their sizes and descriptions, largest first
+//  verify   Checks the checksum of every entry of a cache_file, exits with 1 if an entry is corrupted
+//  stats    Measures how long reading and writing every entry of a cache_file takes
+//  compact  Drops unreferenced data of superseded entries from a cache_file
+
+namespace
+{
+	constexpr uint32_t sCacheFileMagic = 0x434B5647; // "GVKC"
+
+	struct file_header
+	{
+		bool mIsCacheFile;
+		uint32_t mVersion;
+		gvk::compression_codec mCodec;
+		bool mFooterIntact = true;
+		// Only serializer cache files store the hash of their inputs in the header
+		uint64_t mInputHash = 0;
+	};
+
+	// Version, codec, and input hash in front of the data of a serializer cache file
+	constexpr size_t sSerializerHeaderSize = 2 * sizeof(uint32_t) + sizeof(uint64_t);
+
+	std::string to_string(gvk::compression_codec aCodec)
+	{
+		switch (aCodec) {
+		case gvk::compression_codec::none: return "none";
+		case gvk::compression_codec::lz4:  return "lz4";
+		default:                           return fmt::format("unknown ({})", static_cast<uint32_t>(aCodec));
+		}
+	}
+
+	std::string format_bytes(double aBytes)
+	{
+		if (aBytes >= 1024.0 * 1024.0) {
+			return fmt::format("{:.2f} MiB", aBytes / (1024.0 * 1024.0));
+		}
+		if (aBytes >= 1024.0) {
+			return fmt::format("{:.2f} KiB", aBytes / 1024.0);
+		}
+		return fmt::format("{} B", static_cast<uint64_t>(aBytes));
+	}
+
+	// Reads the header without opening the file as a gvk::cache_file, which would recreate an outdated file
+	file_header read_header(const std::string& aPath)
+	{
+		std::ifstream file(aPath, std::ios::binary);
+		uint32_t values[4] = {};
+		file.read(reinterpret_cast<char*>(values), sizeof(values));
+		if (file.gcount() < static_cast<std::streamsize>(2 * sizeof(uint32_t))) {
+			throw gvk::runtime_error(fmt::format("'{}' is neither a cache_file nor a serializer cache file.", aPath));
+		}
+		if (sCacheFileMagic == values[0]) {
+			// A cache_file ends with the magic number, unless entries have been appended without writing a table of contents behind them:
+			uint32_t footerMagic = 0;
+			file.clear();
+			file.seekg(-static_cast<std::streamoff>(sizeof(uint32_t)), std::ios::end);
+			file.read(reinterpret_cast<char*>(&footerMagic), sizeof(footerMagic));
+			return { true, values[1], static_cast<gvk::compression_codec>(values[2]), sCacheFileMagic == footerMagic };
+		}
+		return { false, values[0], static_cast<gvk::compression_codec>(values[1]), true, static_cast<uint64_t>(values[2]) | (static_cast<uint64_t>(values[3]) << 32) };
+	}
+
+	int info(const std::string& aPath, const file_header& aHeader)
+	{
+		const auto fileSize = std::filesystem::file_size(aPath);
+		std::cout << fmt::format("file:     {}\ntype:     {}\nversion:  {}{}\ncodec:    {}\nsize:     {}\n",
+			aPath, aHeader.mIsCacheFile ? "cache_file" : "serializer cache file",
+			aHeader.mVersion, aHeader.mVersion == SERIALIZER_CACHE_FILE_VERSION ? "" : fmt::format(" (outdated, current version is {})", SERIALIZER_CACHE_FILE_VERSION),
+			to_string(aHeader.mCodec), format_bytes(static_cast<double>(fileSize)));
+
+		if (aHeader.mVersion != SERIALIZER_CACHE_FILE_VERSION) {
+			return 0;
+		}
+		if (!aHeader.mFooterIntact) {
+			std::cout << "footer:   MISSING, the entries written after the last table of contents would be dropped when used\n";
+			return 1;
+		}
+		if (aHeader.mIsCacheFile) {
+			gvk::cache_file cache(aPath);
+			const auto entries = cache.entries();
+			uint64_t serializedSize = 0;
+			for (const auto& entry : entries) {
+				serializedSize += entry.mUncompressedSize;
+			}
+			std::cout << fmt::format("entries:  {}\nserialized size:    {}\nunreferenced bytes: {}\n",
+				entries.size(), format_bytes(static_cast<double>(serializedSize)), format_bytes(static_cast<double>(cache.unreferenced_bytes())));
+		}
+		else {
+			std::cout << fmt::format("inputs:   {:016x}\n", aHeader.mInputHash);
+			if (gvk::compression_codec::none != aHeader.mCodec) {
+				const gvk::memory_mapped_file mapping(aPath);
+				const auto start = std::chrono::steady_clock::now();
+				const auto serializedSize = gvk::decompress_chunked(mapping.span().subspan(sSerializerHeaderSize), aHeader.mCodec).size();
+				const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				std::cout << fmt::format("serialized size:    {}, decompressed in {:.3f} ms ({}/s)\n",
+					format_bytes(static_cast<double>(serializedSize)), seconds * 1000.0, format_bytes(static_cast<double>(serializedSize) / std::max(seconds, 1e-9)));
+			}
+		}
+		return 0;
+	}
+
+	int list(gvk::cache_file& aCache)
+	{
+		auto entries = aCache.entries();
+		std::sort(std::begin(entries), std::end(entries), [](const auto& a, const auto& b) { return a.mSize > b.mSize; });
+
+		uint64_t storedSize = 0;
+		for (const auto& entry : entries) {
+			std::cout << fmt::format("{:>12} {:>12}  {:016x}  {}\n             {}\n",
+				format_bytes(static_cast<double>(entry.mSize)), format_bytes(static_cast<double>(entry.mUncompressedSize)), entry.mInputHash, entry.mKey, entry.mDescription);
+			storedSize += entry.mSize;
+		}
+		std::cout << fmt::format("\n{} entries, {} stored, {} unreferenced\n",
+			entries.size(), format_bytes(static_cast<double>(storedSize)), format_bytes(static_cast<double>(aCache.unreferenced_bytes())));
+		return 0;
+	}
+
+	int verify(gvk::cache_file& aCache)
+	{
+		const auto issues = aCache.verify();
+		for (const auto& issue : issues) {
+			std::cout << fmt::format("CORRUPTED: {}\n           {}\n", issue.mKey, issue.mProblem);
+		}
+		std::cout << fmt::format("{} of {} entries are intact\n", aCache.entries().size() - issues.size(), aCache.entries().size());
+		return issues.empty() ? 0 : 1;
+	}
+
+	int stats(gvk::cache_file& aCache)
+	{
+		// Read every entry, and measure the time per entry to find the ones which dominate load times
+		std::vector<std::tuple<double, std::string>> readSecondsPerEntry;
+		std::vector<std::tuple<std::string, std::vector<std::byte>>> serializedEntries;
+		for (const auto& entry : aCache.entries()) {
+			const auto start = std::chrono::steady_clock::now();
+			auto ser = aCache.read_entry(entry.mKey);
+			const auto serialized = ser->view_memory(entry.mUncompressedSize);
+			readSecondsPerEntry.emplace_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), entry.mKey);
+			serializedEntries.emplace_back(entry.mKey, std::vector<std::byte>(std::begin(serialized), std::end(serialized)));
+		}
+
+		// Write all entries again into a temporary cache file with the same codec
+		const auto tempPath = aCache.path() + ".stats";
+		{
+			gvk::cache_file temp(tempPath, aCache.codec());
+			for (const auto& [key, data] : serializedEntries) {
+				temp.write_entry(key, data);
+			}
+			const auto tempStats = temp.statistics();
+			std::cout << fmt::format("write: {} entries, {} serialized, {} written in {:.3f} ms => {}/s\n",
+				tempStats.mEntriesWritten, format_bytes(static_cast<double>(tempStats.mBytesSerialized)), format_bytes(static_cast<double>(tempStats.mBytesWritten)),
+				tempStats.mWriteSeconds * 1000.0, format_bytes(tempStats.write_throughput()));
+		}
+		std::filesystem::remove(tempPath);
+
+		const auto readStats = aCache.statistics();
+		std::cout << fmt::format("read:  {} entries, {} read, {} decompressed in {:.3f} ms (of which decompression {:.3f} ms) => {}/s\n",
+			readStats.mEntriesLoaded, format_bytes(static_cast<double>(readStats.mBytesRead)), format_bytes(static_cast<double>(readStats.mBytesDecompressed)),
+			readStats.mReadSeconds * 1000.0, readStats.mDecompressSeconds * 1000.0, format_bytes(readStats.read_throughput()));
+
+		std::sort(std::begin(readSecondsPerEntry), std::end(readSecondsPerEntry), std::greater<>{});
+		std::cout << "\nslowest entries to read:\n";
+		for (size_t i = 0; i < std::min(readSecondsPerEntry.size(), size_t{ 10 }); ++i) {
+			std::cout << fmt::format("{:>10.3f} ms  {}\n", std::get<double>(readSecondsPerEntry[i]) * 1000.0, std::get<std::string>(readSecondsPerEntry[i]));
+		}
+		return 0;
+	}
+
+	int compact(gvk::cache_file& aCache)
+	{
+		const auto savedBytes = aCache.compact();
+		std::cout << fmt::format("removed {} of unreferenced data, {} entries remain\n", format_bytes(static_cast<double>(savedBytes)), aCache.entries().size());
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		if (argc != 3) {
+			std::cout << "Usage: cache_tool <info|list|verify|stats|compact> <file>\n";
+			return 2;
+		}
+		const std::string command = argv[1];
+		const std::string path = argv[2];
+
+		const auto header = read_header(path);
+		if ("info" == command) {
+			return info(path, header);
+		}
+		if (!header.mIsCacheFile) {
+			std::cout << fmt::format("'{}' is a serializer cache file, which can only be inspected with 'info'.\n", path);
+			return 2;
+		}
+		if (header.mVersion != SERIALIZER_CACHE_FILE_VERSION) {
+			std::cout << fmt::format("'{}' has been written with version {}, the current version is {}. It would be recreated when used.\n", path, header.mVersion, SERIALIZER_CACHE_FILE_VERSION);
+			return 1;
+		}
+		if (!header.mFooterIntact) {
+			std::cout << fmt::format("'{}' does not end with a footer, most likely the process writing it has terminated before flushing it. "
+				"The entries written after its last table of contents would be dropped when used.\n", path);
+			return 1;
+		}
+
+		gvk::cache_file cache(path);
+		if ("list" == command) {
+			return list(cache);
+		}
+		if ("verify" == command) {
+			return verify(cache);
+		}
+		if ("stats" == command) {
+			return stats(cache);
+		}
+		if ("compact" == command) {
+			return compact(cache);
+		}
+		std::cout << fmt::format("Unknown command '{}'.\n", command);
+		return 2;
+	}
+	catch (gvk::logic_error&) {}
+	catch (gvk::runtime_error&) {}
+	catch (avk::logic_error&) {}
+	catch (avk::runtime_error&) {}
+	catch (std::filesystem::filesystem_error& e) {
+		std::cout << e.what() << "\n";
+	}
+	return 1;
+}
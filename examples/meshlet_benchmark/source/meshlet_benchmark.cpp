@@ -0,0 +1,53 @@
+#include <gvk.hpp>
+
+// Headless benchmark which reports the quality of meshlet divisions.
+// Usage: meshlet_benchmark [model files...]
+// If no model files are given, the sample assets used by the meshlet examples are evaluated.
+
+static constexpr uint32_t sNumVertices = 64;
+static constexpr uint32_t sNumIndices = 378;
+
+template <typename F>
+void benchmark_division(const std::string& aDivisionName, const gvk::model_t& aModel, const std::vector<gvk::mesh_index_t>& aMeshIndices, F aMeshletDivision)
+{
+	for (const bool combineSubmeshes : { true, false }) {
+		auto metrics = gvk::measure_meshlet_division(aModel, aMeshIndices, aMeshletDivision, combineSubmeshes, sNumVertices, sNumIndices);
+		std::cout << "--- " << aDivisionName << (combineSubmeshes ? " (submeshes combined)" : " (per submesh)") << " ---\n"
+			<< gvk::to_string(metrics) << "\n\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		std::vector<std::string> modelPaths;
+		for (int i = 1; i < argc; ++i) {
+			modelPaths.emplace_back(argv[i]);
+		}
+		if (modelPaths.empty()) {
+			modelPaths = { "assets/stanford_bunny.obj", "assets/crab.fbx" };
+		}
+
+		for (const auto& path : modelPaths) {
+			std::cout << "=========== " << path << " ===========\n";
+			auto model = gvk::model_t::load_from_file(path, aiProcess_Triangulate | aiProcess_PreTransformVertices);
+			auto meshIndices = model->select_all_meshes();
+
+			benchmark_division("basic_meshlets_divider", model.get(), meshIndices, gvk::basic_meshlets_divider);
+
+			// Compare the GPU representations of the default division
+			auto selection = gvk::make_selection_of_shared_models_and_mesh_indices(model, meshIndices);
+			auto meshlets = gvk::divide_into_meshlets(selection, true, sNumVertices, sNumIndices);
+			for (const auto encoding : { gvk::meshlet_index_encoding::triangle_list, gvk::meshlet_index_encoding::triangle_strip }) {
+				auto report = gvk::report_meshlet_compression<sNumVertices, sNumIndices>(meshlets, encoding);
+				std::cout << "--- compressed meshlets (" << (encoding == gvk::meshlet_index_encoding::triangle_strip ? "triangle strips" : "triangle lists") << ") ---\n"
+					<< fmt::format("fixed layout:      {} bytes\nredirected layout: {} bytes\ncompressed:        {} bytes ({:.1f}% of redirected)\nround trip:        {}\n\n",
+						report.mFixedLayoutBytes, report.mRedirectedLayoutBytes, report.mCompressedBytes, 100.0 * report.ratio_to_redirected_layout(), report.mRoundTripValid ? "valid" : "INVALID");
+			}
+		}
+	}
+	catch (gvk::logic_error&) {}
+	catch (gvk::runtime_error&) {}
+	catch (avk::logic_error&) {}
+	catch (avk::runtime_error&) {}
+}
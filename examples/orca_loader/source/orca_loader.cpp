@@ -196,10 +196,12 @@ auto [gpuMaterials, imageSamplers] = gvk::convert_for_gpu_usage<gvk::material_gp
 		std::unordered_map<gvk::material_config, std::vector<gvk::model_and_mesh_indices>> distinctMaterialsOrca;
 
 		const std::string cacheFilePath(aPathToOrcaScene + ".cache");
-		// If a cache file exists, i.e. the scene was serialized during a previous load, initialize the serializer in deserialize mode,
+		// The cache file is only up to date if the scene file has not been modified since the cache file has been written:
+		const auto inputHash = gvk::content_hash{}.add_file(aPathToOrcaScene, gvk::file_hash_mode::timestamp_and_size).value();
+		// If an up to date cache file exists, i.e. the scene was serialized during a previous load, initialize the serializer in deserialize mode,
 		// else initialize the serializer in serialize mode to create the cache file while processing the scene.
-		auto serializer = gvk::serializer(cacheFilePath, gvk::does_cache_file_exist(cacheFilePath) ?
-			gvk::serializer::mode::deserialize : gvk::serializer::mode::serialize);
+		auto serializer = gvk::serializer(cacheFilePath, gvk::is_cache_file_up_to_date(cacheFilePath, inputHash) ?
+			gvk::serializer::mode::deserialize : gvk::serializer::mode::serialize, gvk::compression_codec::none, inputHash);
 
 		auto start = gvk::context().get_time();
 		auto startPart = start;
@@ -95,6 +95,25 @@ class skinned_meshlets_app : public gvk::invokee
 #endif
 	};
 
+	/** Transforms the animated bounds of a meshlet into world space.
+	 *	@param	aBounds			The bounds of the meshlet in mesh space
+	 *	@param	aMeshToWorld	The transformation from mesh space into world space
+	 *	@returns				The bounding sphere of the transformed bounds: center in xyz, radius in w
+	 */
+	static glm::vec4 bounding_sphere_in_world_space(const gvk::skinned_meshlet_bounds_gpu_data& aBounds, const glm::mat4& aMeshToWorld)
+	{
+		gvk::meshlet_bounding_box box;
+		for (int corner = 0; corner < 8; ++corner) {
+			const glm::vec3 cornerMshSp{
+				(corner & 1) ? aBounds.mMax.x : aBounds.mMin.x,
+				(corner & 2) ? aBounds.mMax.y : aBounds.mMin.y,
+				(corner & 4) ? aBounds.mMax.z : aBounds.mMin.z
+			};
+			box.extend(glm::vec3(aMeshToWorld * glm::vec4(cornerMshSp, 1.0f)));
+		}
+		return glm::vec4(box.center(), box.radius());
+	}
+
 public: // v== avk::invokee overrides which will be invoked by the framework ==v
 	skinned_meshlets_app(avk::queue& aQueue)
 		: mQueue{ &aQueue }
@@ -188,6 +207,7 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 		std::vector<gvk::material_config> allMatConfigs; // <-- Gather the material config from all models to be loaded
 		std::vector<loaded_data_for_draw_call> dataForDrawCall;
 		std::vector<meshlet> meshletsGeometry;
+		std::vector<glm::vec4> meshletBoundingSpheres;
 		std::vector<animated_model_data> animatedModels;
 
 		// Crab-specific animation config: (Needs to be adapted for other models)
@@ -262,14 +282,14 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 				auto cpuMeshlets = gvk::divide_into_meshlets(meshletSelection);
 #if !USE_REDIRECTED_GPU_DATA
 #if USE_CACHE
-				gvk::serializer serializer("direct_meshlets-" + meshname + "-" + std::to_string(mpos) + ".cache");
+				gvk::serializer serializer("direct_meshlets-" + meshname + "-" + std::to_string(mpos) + ".cache", gvk::content_hash{}.add_file("assets/crab.fbx", gvk::file_hash_mode::timestamp_and_size).value());
 				auto [gpuMeshlets, _] = gvk::convert_for_gpu_usage_cached<gvk::meshlet_gpu_data<sNumVertices, sNumIndices>>(serializer, cpuMeshlets);
 #else
 				auto [gpuMeshlets, _] = gvk::convert_for_gpu_usage<gvk::meshlet_gpu_data<sNumVertices, sNumIndices>, sNumVertices, sNumIndices>(cpuMeshlets);
 #endif
 #else
 #if USE_CACHE
-				gvk::serializer serializer("indirect_meshlets-" + meshname + "-" + std::to_string(mpos) + ".cache");
+				gvk::serializer serializer("indirect_meshlets-" + meshname + "-" + std::to_string(mpos) + ".cache", gvk::content_hash{}.add_file("assets/crab.fbx", gvk::file_hash_mode::timestamp_and_size).value());
 				auto [gpuMeshlets, generatedMeshletData] = gvk::convert_for_gpu_usage_cached<gvk::meshlet_redirected_gpu_data, sNumVertices, sNumIndices>(serializer, cpuMeshlets);
 #else
 				auto [gpuMeshlets, generatedMeshletData] = gvk::convert_for_gpu_usage<gvk::meshlet_redirected_gpu_data, sNumVertices, sNumIndices>(cpuMeshlets);
@@ -277,6 +297,20 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 				drawCallData.mMeshletData = std::move(generatedMeshletData.value());
 #endif
 
+				// Compute bounds which enclose each meshlet in every pose of the animation clip, to cull meshlets in the task shader:
+#if USE_CACHE
+				auto meshletBounds = gvk::compute_skinned_meshlet_bounds_cached(serializer, cpuMeshlets, drawCallData.mPositions, drawCallData.mBoneIndices, drawCallData.mBoneWeights, curEntry.mAnimation, { curEntry.mClip });
+				auto [gpuBounds, boneIndices, boneBoxes] = gvk::convert_for_gpu_usage_cached(serializer, meshletBounds);
+#else
+				auto meshletBounds = gvk::compute_skinned_meshlet_bounds(cpuMeshlets, drawCallData.mPositions, drawCallData.mBoneIndices, drawCallData.mBoneWeights, curEntry.mAnimation, { curEntry.mClip });
+				auto [gpuBounds, boneIndices, boneBoxes] = gvk::convert_for_gpu_usage(meshletBounds);
+#endif
+				// The bounds are given in mesh space, but the bone matrices used for rendering (see render()) transform into model space:
+				const auto meshToWorld = drawCallData.mModelMatrix * curModel->mesh_root_matrix(meshIndex);
+				for (const auto& bounds : gpuBounds) {
+					meshletBoundingSpheres.push_back(bounding_sphere_in_world_space(bounds, meshToWorld));
+				}
+
 				// fill our own meshlets with the loaded/generated data
 				for (size_t mshltidx = 0; mshltidx < gpuMeshlets.size(); ++mshltidx) {
 					auto& genMeshlet = gpuMeshlets[mshltidx];
@@ -317,7 +351,14 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			avk::storage_buffer_meta::create_from_data(meshletsGeometry)
 		);
 		mMeshletsBuffer->fill(meshletsGeometry.data(), 0, avk::sync::wait_idle(true));
-		mNumMeshletWorkgroups = meshletsGeometry.size();
+		// Every task shader workgroup processes 32 meshlets:
+		mNumMeshletWorkgroups = (meshletsGeometry.size() + 31) / 32;
+
+		mMeshletBoundsBuffer = gvk::context().create_buffer(
+			avk::memory_usage::device, {},
+			avk::storage_buffer_meta::create_from_data(meshletBoundingSpheres)
+		);
+		mMeshletBoundsBuffer->fill(meshletBoundingSpheres.data(), 0, avk::sync::wait_idle(true));
 
 		// For all the different materials, transfer them in structs which are well
 		// suited for GPU-usage (proper alignment, and containing only the relevant data),
@@ -375,7 +416,8 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 #endif
 			avk::descriptor_binding(3, 5, avk::as_uniform_texel_buffer_views(mBoneIndicesBuffers)),
 			avk::descriptor_binding(3, 6, avk::as_uniform_texel_buffer_views(mBoneWeightsBuffers)),
-			avk::descriptor_binding(4, 0, mMeshletsBuffer)
+			avk::descriptor_binding(4, 0, mMeshletsBuffer),
+			avk::descriptor_binding(4, 1, mMeshletBoundsBuffer)
 		);
 
 		// set up updater
@@ -523,7 +565,8 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 #endif
 			avk::descriptor_binding(3, 5, avk::as_uniform_texel_buffer_views(mBoneIndicesBuffers)),
 			avk::descriptor_binding(3, 6, avk::as_uniform_texel_buffer_views(mBoneWeightsBuffers)),
-			avk::descriptor_binding(4, 0, mMeshletsBuffer)
+			avk::descriptor_binding(4, 0, mMeshletsBuffer),
+			avk::descriptor_binding(4, 1, mMeshletBoundsBuffer)
 			}));
 		cmdbfr->handle().pushConstants(mPipeline->layout_handle(), vk::ShaderStageFlagBits::eFragment, 0u, sizeof(push_constants), &pushConstants);
 		// draw our meshlets
@@ -551,6 +594,7 @@ private: // v== Member variables ==v
 	avk::buffer mViewProjBuffer;
 	avk::buffer mMaterialBuffer;
 	avk::buffer mMeshletsBuffer;
+	avk::buffer mMeshletBoundsBuffer;
 	std::array<std::vector<avk::buffer>, cConcurrentFrames> mBoneMatricesBuffersAni;
 	std::vector<avk::image_sampler> mImageSamplers;
 
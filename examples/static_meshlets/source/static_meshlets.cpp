@@ -180,10 +180,10 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 
 				auto cpuMeshlets = gvk::divide_into_meshlets(meshletSelection);
 #if !USE_REDIRECTED_GPU_DATA
-				gvk::serializer serializer("direct_meshlets-" + meshname + "-" + std::to_string(mpos) + ".cache");
+				gvk::serializer serializer("direct_meshlets-" + meshname + "-" + std::to_string(mpos) + ".cache", gvk::content_hash{}.add_file("assets/stanford_bunny.obj", gvk::file_hash_mode::timestamp_and_size).value());
 				auto [gpuMeshlets, _] = gvk::convert_for_gpu_usage_cached<gvk::meshlet_gpu_data<sNumVertices, sNumIndices>>(serializer, cpuMeshlets);
 #else
-				gvk::serializer serializer("indirect_meshlets-" + meshname + "-" + std::to_string(mpos) + ".cache");
+				gvk::serializer serializer("indirect_meshlets-" + meshname + "-" + std::to_string(mpos) + ".cache", gvk::content_hash{}.add_file("assets/stanford_bunny.obj", gvk::file_hash_mode::timestamp_and_size).value());
 				auto [gpuMeshlets, generatedMeshletData] = gvk::convert_for_gpu_usage_cached<gvk::meshlet_redirected_gpu_data, sNumVertices, sNumIndices>(serializer, cpuMeshlets);
 				drawCallData.mMeshletData = std::move(generatedMeshletData.value());
 #endif
@@ -0,0 +1,67 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Output stream buffer which writes to a file on a background thread.
+	 *
+	 *	Written data is collected in chunks, and full chunks are handed over to a writer thread, so that the thread which
+	 *	produces the data (e.g. a serializer while loading assets) does not wait for the disk. Written chunks are recycled,
+	 *	so that large blocks of data, like whole vertex or image buffers, are copied into existing memory instead of newly
+	 *	allocated one. The amount of data which has been handed over but not been written yet is bounded; if the budget is
+	 *	exhausted, the producing thread waits for the writer thread. Blocks larger than the budget are written directly.
+	 *
+	 *	pubsync() (i.e. std::ostream::flush) waits until all data has been written, and is the point where write errors
+	 *	are reported: it fails, setting the stream's badbit, if any write has failed.
+	 */
+	class async_file_streambuf : public std::streambuf
+	{
+	public:
+		/** Size of the chunks in which small writes are collected */
+		static constexpr size_t sDefaultChunkSize = 1024 * 1024;
+		/** Maximum amount of data which has been handed over to the writer thread, but not been written yet */
+		static constexpr size_t sDefaultMaxBytesInFlight = 64 * 1024 * 1024;
+
+		/** Opens the file for writing, truncating it, and starts the writer thread.
+		 *	@param	aPath				Path to the file. Throws a gvk::runtime_error if it cannot be opened.
+		 *	@param	aChunkSize			Size of the chunks in which small writes are collected.
+		 *	@param	aMaxBytesInFlight	Maximum amount of data which has been handed over to the writer thread, but not been written yet.
+		 */
+		explicit async_file_streambuf(std::string_view aPath, size_t aChunkSize = sDefaultChunkSize, size_t aMaxBytesInFlight = sDefaultMaxBytesInFlight);
+
+		async_file_streambuf(async_file_streambuf&&) = delete;
+		async_file_streambuf(const async_file_streambuf&) = delete;
+		async_file_streambuf& operator=(async_file_streambuf&&) = delete;
+		async_file_streambuf& operator=(const async_file_streambuf&) = delete;
+
+		/** Writes all remaining data and stops the writer thread */
+		~async_file_streambuf() override;
+
+	protected:
+		int_type overflow(int_type aChar) override;
+		std::streamsize xsputn(const char* aData, std::streamsize aCount) override;
+		int sync() override;
+
+	private:
+		void start_new_chunk();
+		bool submit_current_chunk();
+		bool submit(std::vector<char>&& aChunk);
+		void write_chunks();
+
+		std::string mPath;
+		std::ofstream mFile;
+		size_t mChunkSize;
+		size_t mMaxBytesInFlight;
+		std::vector<char> mCurrentChunk;
+
+		std::mutex mMutex;
+		std::condition_variable mChunkSubmitted;
+		std::condition_variable mChunkWritten;
+		std::deque<std::vector<char>> mPendingChunks;
+		std::vector<std::vector<char>> mRecycledChunks;
+		size_t mBytesInFlight = 0;
+		bool mFailed = false;
+		bool mStop = false;
+		std::thread mWriterThread;
+	};
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Compression codecs for cache files. The codec of a cache file is stored in its header. */
+	enum struct compression_codec : uint32_t
+	{
+		/** Data is stored as is, and can be read without any copies from a memory mapped cache file */
+		none = 0,
+		/** Data is compressed in chunks with a built-in compressor which produces the LZ4 block format */
+		lz4 = 1
+	};
+
+	/** Default size of the chunks of uncompressed data which are compressed independently. Chunks are the unit of parallel decompression. */
+	static constexpr size_t sDefaultCompressionChunkSize = 1024 * 1024;
+
+	/** The maximum size of the LZ4 block compressed data of aSize bytes, i.e. the size of incompressible data */
+	static inline size_t lz4_compress_bound(size_t aSize)
+	{
+		return aSize + aSize / 255 + 16;
+	}
+
+	/** Compresses a block of data into the LZ4 block format.
+	 *	@param	aSource			The data to compress
+	 *	@param	aDestination	Memory for the compressed data
+	 *	@returns				The size of the compressed data, or 0 if it does not fit into aDestination.
+	 */
+	size_t lz4_compress(std::span<const std::byte> aSource, std::span<std::byte> aDestination);
+
+	/** Decompresses a block of data in the LZ4 block format.
+	 *	@param	aSource			The compressed data
+	 *	@param	aDestination	Memory for the decompressed data, whose size must match the size of the decompressed data exactly.
+	 *							Throws a gvk::runtime_error if the compressed data is corrupt or does not match aDestination's size.
+	 */
+	void lz4_decompress(std::span<const std::byte> aSource, std::span<std::byte> aDestination);
+
+	/** Decompresses data in the Zstandard format (RFC 8878), e.g. the supercompressed levels of KTX2 files.
+	 *	Supports one or more frames, optionally with skippable frames in between. Frames which require a dictionary are not supported.
+	 *	Content checksums are verified if frames contain them.
+	 *	@param	aSource			The compressed frames
+	 *	@param	aDestination	Memory for the decompressed data, whose size must match the size of the decompressed data exactly.
+	 *							Throws a gvk::runtime_error if the compressed data is corrupt or does not match aDestination's size.
+	 */
+	void zstd_decompress(std::span<const std::byte> aSource, std::span<std::byte> aDestination);
+
+	/** Compresses data in independent chunks.
+	 *	Each chunk is stored as a frame consisting of its uncompressed size, its stored size, and its data.
+	 *	Chunks which do not get smaller are stored uncompressed. Chunks are compressed in parallel.
+	 *	@param	aData		The data to compress
+	 *	@param	aCodec		The codec to use for every chunk
+	 *	@param	aChunkSize	Size of the chunks of uncompressed data
+	 *	@returns			The frames
+	 */
+	std::vector<std::byte> compress_chunked(std::span<const std::byte> aData, compression_codec aCodec, size_t aChunkSize = sDefaultCompressionChunkSize);
+
+	/** Decompresses data which has been compressed with compress_chunked or written through a compressing_streambuf.
+	 *	The chunks are decompressed in parallel, directly into their final location in the returned buffer.
+	 *	@param	aFrames		The frames
+	 *	@param	aCodec		The codec the chunks have been compressed with
+	 *	@returns			The decompressed data
+	 */
+	std::vector<std::byte> decompress_chunked(std::span<const std::byte> aFrames, compression_codec aCodec);
+
+	/** Input stream buffer which decompresses the frames written by compress_chunked or a compressing_streambuf on demand,
+	 *	one chunk at a time. Unlike decompress_chunked, it never holds more than one decompressed chunk in memory, and
+	 *	chunks which have been stored uncompressed are read in place.
+	 */
+	class decompressing_streambuf : public std::streambuf
+	{
+	public:
+		/** @param	aFrames		The frames, which must outlive the decompressing_streambuf
+		 *	@param	aCodec		The codec the chunks have been compressed with
+		 */
+		decompressing_streambuf(std::span<const std::byte> aFrames, compression_codec aCodec);
+
+		decompressing_streambuf(decompressing_streambuf&&) = delete;
+		decompressing_streambuf(const decompressing_streambuf&) = delete;
+		decompressing_streambuf& operator=(decompressing_streambuf&&) = delete;
+		decompressing_streambuf& operator=(const decompressing_streambuf&) = delete;
+		~decompressing_streambuf() override = default;
+
+		/** Returns the next aSize bytes without copying them if they are contained in the current chunk, and advances the
+		 *	read position. Memory which spans multiple chunks is assembled in an internal buffer. The returned memory stays
+		 *	valid until the next read. Throws a gvk::runtime_error if fewer bytes remain.
+		 */
+		std::span<const std::byte> view(size_t aSize);
+
+	protected:
+		int_type underflow() override;
+
+	private:
+		bool next_chunk();
+
+		std::span<const std::byte> mFrames;
+		size_t mOffset = 0;
+		compression_codec mCodec;
+		std::vector<char> mChunk;
+		std::vector<std::byte> mAssembled;
+	};
+
+	/** Output stream buffer which compresses data in chunks and writes the frames (see compress_chunked) to another stream buffer. */
+	class compressing_streambuf : public std::streambuf
+	{
+	public:
+		/** @param	aDestination	The stream buffer to write the compressed frames to
+		 *	@param	aCodec			The codec to use
+		 *	@param	aChunkSize		Size of the chunks of uncompressed data
+		 */
+		compressing_streambuf(std::unique_ptr<std::streambuf> aDestination, compression_codec aCodec, size_t aChunkSize = sDefaultCompressionChunkSize);
+
+		compressing_streambuf(compressing_streambuf&&) = delete;
+		compressing_streambuf(const compressing_streambuf&) = delete;
+		compressing_streambuf& operator=(compressing_streambuf&&) = delete;
+		compressing_streambuf& operator=(const compressing_streambuf&) = delete;
+
+		/** Compresses and writes the remaining data */
+		~compressing_streambuf() override;
+
+	protected:
+		int_type overflow(int_type aChar) override;
+		int sync() override;
+
+	private:
+		bool write_chunk();
+
+		std::unique_ptr<std::streambuf> mDestination;
+		compression_codec mCodec;
+		std::vector<char> mChunk;
+		std::vector<std::byte> mCompressed;
+	};
+}
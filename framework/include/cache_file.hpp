@@ -0,0 +1,341 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Table of contents entry of a cache_file */
+	struct cache_file_entry
+	{
+		/** The key under which the entry has been stored, see cache_key */
+		std::string mKey;
+		/** Offset of the entry's data from the beginning of the cache file in bytes */
+		uint64_t mOffset;
+		/** Size of the entry's stored data in bytes, i.e. after compression */
+		uint64_t mSize;
+		/** Hash of the inputs the entry has been produced from, see content_hash */
+		uint64_t mInputHash;
+		/** Size of the entry's serialized data in bytes, i.e. before compression */
+		uint64_t mUncompressedSize;
+		/** Hash of the entry's stored data, which is used to detect corrupted entries, see cache_file::verify */
+		uint64_t mChecksum;
+		/** Human readable description of the entry's contents, as passed to cache_file::write_entry or cache_file::entry */
+		std::string mDescription;
+	};
+
+	/** Serialization/deserialization method for cache_file_entry.
+	 *	@param	aArchive	The archive.
+	 *	@param	aValue		The value to serialize or to deserialize into.
+	 *	@tparam Archive		The archive type.
+	 */
+	template<typename Archive>
+	void serialize(Archive& aArchive, cache_file_entry& aValue)
+	{
+		aArchive(aValue.mKey, aValue.mOffset, aValue.mSize, aValue.mInputHash, aValue.mUncompressedSize, aValue.mChecksum, aValue.mDescription);
+	}
+
+	/** A problem which cache_file::verify has found with an entry */
+	struct cache_file_issue
+	{
+		/** The key of the affected entry */
+		std::string mKey;
+		/** Description of the problem */
+		std::string mProblem;
+	};
+
+	/** Statistics about the entries which a cache_file has loaded, produced, and written since it has been opened.
+	 *	Times are wall clock times of the respective calls, summed over all threads.
+	 */
+	struct cache_file_statistics
+	{
+		/** Number of entries which have been loaded from the file */
+		size_t mEntriesLoaded = 0;
+		/** Number of entries which have been produced because they were missing or stale */
+		size_t mEntriesProduced = 0;
+		/** Number of entries which have been written to the file */
+		size_t mEntriesWritten = 0;
+
+		/** Bytes read from the file, i.e. the stored sizes of the loaded entries */
+		uint64_t mBytesRead = 0;
+		/** Bytes which have been decompressed from the read bytes */
+		uint64_t mBytesDecompressed = 0;
+		/** Bytes of serialized data which have been written, i.e. before compression */
+		uint64_t mBytesSerialized = 0;
+		/** Bytes written to the file, i.e. after compression */
+		uint64_t mBytesWritten = 0;
+
+		/** Time spent in read_entry, including decompression */
+		double mReadSeconds = 0.0;
+		/** Time spent decompressing entries */
+		double mDecompressSeconds = 0.0;
+		/** Time spent in write_entry, including compression */
+		double mWriteSeconds = 0.0;
+		/** Time spent in entry() loading existing entries, i.e. reading and deserializing them */
+		double mLoadSeconds = 0.0;
+		/** Time spent in entry() producing missing or stale entries, i.e. producing, serializing, and writing them */
+		double mProduceSeconds = 0.0;
+
+		/** Time spent in entry() per key, loading or producing the entry. Shows which entries dominate load times. */
+		std::unordered_map<std::string, double> mSecondsPerEntry;
+
+		/** Throughput of read_entry in bytes of serialized data per second */
+		double read_throughput() const { return mReadSeconds > 0.0 ? static_cast<double>(mBytesDecompressed) / mReadSeconds : 0.0; }
+		/** Throughput of write_entry in bytes of serialized data per second */
+		double write_throughput() const { return mWriteSeconds > 0.0 ? static_cast<double>(mBytesSerialized) / mWriteSeconds : 0.0; }
+	};
+
+	/** Creates a key for an entry of a cache_file.
+	 *	@param	aHelperName		Name of the function or helper which produces the entry, e.g. "divide_into_meshlets".
+	 *	@param	aSourcePath		Path of the asset the entry has been produced from, e.g. a model's path.
+	 *	@param	aFlags			Flags which influence the entry's data, e.g. the Assimp import flags.
+	 *	@param	aDetail			Further distinguishing information, e.g. the mesh indices or helper parameters.
+	 */
+	static inline std::string cache_key(std::string_view aHelperName, std::string_view aSourcePath, uint64_t aFlags = 0, std::string_view aDetail = {})
+	{
+		return fmt::format("{}|{}|{:x}|{}", aHelperName, aSourcePath, aFlags, aDetail);
+	}
+
+	/** A keyed, random-access cache file.
+	 *
+	 *	In contrast to a plain serializer-based cache file, which must be read exactly in the order in which it has been written,
+	 *	a cache_file stores independent entries under keys. Each entry can be loaded on demand and in any order, and new entries
+	 *	are appended to the existing file. A table of contents is not written per added entry, but only by flush() and when the
+	 *	cache_file is destroyed, behind the entries appended since. Until then, the appended entries are only known to this
+	 *	instance: if the process terminates before, they are dropped when the file is opened next, but the entries of the
+	 *	previously written table of contents remain intact.
+	 *	The file is memory mapped for reading, and entries are deserialized directly from the mapped memory.
+	 *
+	 *	Every entry stores a hash of the inputs it has been produced from (see content_hash). If the hash
+	 *	passed to entry differs from the stored one, the entry is stale and only this entry is produced anew.
+	 *	If the whole file is outdated, i.e. its version does not match SERIALIZER_CACHE_FILE_VERSION, it is
+	 *	recreated.
+	 *
+	 *	A cache_file can be used from multiple threads concurrently: Entries are produced, serialized, and compressed
+	 *	in parallel, only appending the finished data to the file is serialized by a mutex. Likewise, entries are read
+	 *	and decompressed in parallel. If multiple threads produce an entry with the same key at the same time, the entry
+	 *	which is written last supersedes the others. The framework's *_cached helpers and convert_for_gpu_usage produce
+	 *	their entries on the calling thread; to use multiple threads, call entry for independent assets from multiple
+	 *	threads as shown below.
+	 *
+	 *	Entries can optionally be compressed, see compression_codec. Uncompressed entries are read without
+	 *	any copies from the mapped memory, compressed ones are decompressed in parallel into memory first.
+	 *
+	 *	For inspection and maintenance, entries() lists the entries with their sizes and descriptions, statistics()
+	 *	reports how much time has been spent loading and producing entries, verify() checks every entry's checksum,
+	 *	and compact() removes the data of superseded or unwanted entries from the file. The cache_tool example offers
+	 *	these functions on the command line.
+	 *
+	 *	File layout:
+	 *	 - header: magic number, SERIALIZER_CACHE_FILE_VERSION, and compression_codec
+	 *	 - the entries' data, one after another, interleaved with the tables of contents and footers written by previous flushes,
+	 *	   which are no longer referenced
+	 *	 - table of contents: the cache_file_entry of every entry
+	 *	 - footer: offset, size, and checksum of the table of contents, and the magic number
+	 *	If the file does not end with a valid footer, it is cut off behind the last valid footer. If there is none, the file is recreated.
+	 *
+	 *	Example:
+	 *	@code
+	 *	gvk::cache_file cache("scene.cache");
+	 *	auto key = gvk::cache_key("divide_into_meshlets_for_gpu_usage", modelPath, aiFlags);
+	 *	auto inputHash = gvk::content_hash{}.add_file(modelPath).add(aiFlags).value();
+	 *	auto [meshlets, indices] = cache.entry(key, inputHash, [&](gvk::serializer& aSerializer) {
+	 *		return gvk::divide_into_meshlets_for_gpu_usage_cached<meshlet_gpu_data>(aSerializer, ...);
+	 *	}, "meshlets of " + modelPath);
+	 *
+	 *	// Independent assets can be loaded or produced on multiple threads:
+	 *	std::vector<std::future<std::vector<glm::vec3>>> normals;
+	 *	for (const auto& [model, path] : models) {
+	 *		normals.push_back(std::async(std::launch::async, [&cache, &model, &path]() {
+	 *			return cache.entry(gvk::cache_key("get_normals", path), gvk::content_hash{}.add_file(path).value(), [&](gvk::serializer& aSerializer) {
+	 *				return gvk::get_normals_cached(aSerializer, gvk::make_models_and_meshes_selection(model, 0));
+	 *			});
+	 *		}));
+	 *	}
+	 *	@endcode
+	 */
+	class cache_file
+	{
+	public:
+		/** Opens the cache file at the given path, or creates it if it does not exist yet.
+		 *	@param	aPath	Path to the cache file
+		 *	@param	aCodec	The compression codec for the entries if the file is created. Existing files keep their codec.
+		 */
+		explicit cache_file(std::string_view aPath, compression_codec aCodec = compression_codec::none);
+
+		cache_file(cache_file&&) = delete;
+		cache_file(const cache_file&) = delete;
+		cache_file& operator=(cache_file&&) = delete;
+		cache_file& operator=(const cache_file&) = delete;
+		/** Writes the table of contents if entries have been added since the last flush */
+		~cache_file();
+
+		/** Writes the table of contents, if entries have been added since it has been written last.
+		 *	Call this to persist the entries which have been added so far, e.g. after loading a level.
+		 */
+		void flush();
+
+		/** The path of the cache file */
+		const std::string& path() const { return mPath; }
+
+		/** The compression codec of the entries */
+		compression_codec codec() const;
+
+		/** A copy of the table of contents, in the order in which the entries have been added */
+		std::vector<cache_file_entry> entries() const;
+
+		/** Statistics about the entries which have been loaded, produced, and written since the file has been opened */
+		cache_file_statistics statistics() const;
+
+		/** Number of bytes in the file which are not referenced by any entry, i.e. the data of superseded entries and previously
+		 *	written tables of contents. See compact.
+		 */
+		uint64_t unreferenced_bytes() const;
+
+		/** Checks that every entry lies within the file, that its stored data matches its checksum, and
+		 *	that compressed entries decompress to their recorded size.
+		 *	@returns	The problems which have been found, or an empty vector if all entries are intact.
+		 */
+		std::vector<cache_file_issue> verify();
+
+		/** Rewrites the file, such that it contains only the data of the entries which are kept.
+		 *	Unreferenced data of superseded entries is dropped. The file is written anew next to the
+		 *	original and then replaces it, i.e. the cache file stays intact if compacting fails.
+		 *	Since a file which is still mapped cannot be replaced on Windows, all serializers returned
+		 *	by read_entry must have been destroyed before compacting.
+		 *	@param	aKeep	Decides which entries to keep. If empty, all entries are kept.
+		 *	@returns		The number of bytes by which the file has become smaller, or 0 if it has not become smaller.
+		 */
+		uint64_t compact(std::function<bool(const cache_file_entry&)> aKeep = {});
+
+		/** Returns true if an entry is stored under the given key.
+		 *	@param	aKey		The key of the entry
+		 *	@param	aInputHash	If set, the entry must also have been produced from inputs with this hash.
+		 */
+		bool contains(std::string_view aKey, std::optional<uint64_t> aInputHash = {}) const;
+
+		/** Returns a serializer in deserialize mode which reads the entry stored under the given key,
+		 *	or an empty optional if there is no such entry. The serializer reads from the memory mapped
+		 *	file, which it keeps alive; it may outlive the cache_file.
+		 *	@param	aKey		The key of the entry
+		 *	@param	aInputHash	If set, an entry which has been produced from inputs with a different hash is treated as missing.
+		 */
+		std::optional<serializer> read_entry(std::string_view aKey, std::optional<uint64_t> aInputHash = {});
+
+		/** Appends an entry with the given data, which must have been created with serializer::serialize_to_memory.
+		 *	If an entry with the same key exists already, it is superseded by the new one.
+		 *	@param	aKey		The key under which to store the entry
+		 *	@param	aData		The serialized data of the entry
+		 *	@param	aInputHash		Hash of the inputs the entry has been produced from
+		 *	@param	aDescription	Human readable description of the entry's contents
+		 */
+		void write_entry(std::string_view aKey, std::span<const std::byte> aData, uint64_t aInputHash = 0, std::string_view aDescription = {});
+
+		/** Serializes an entry with the given function and appends it.
+		 *	@param	aKey			The key under which to store the entry
+		 *	@param	aWriter			Function which gets a serializer& in serialize mode and serializes the entry's data
+		 *	@param	aInputHash		Hash of the inputs the entry has been produced from
+		 *	@param	aDescription	Human readable description of the entry's contents
+		 */
+		template <typename F> requires std::is_invocable_v<F, serializer&>
+		void write_entry(std::string_view aKey, F&& aWriter, uint64_t aInputHash = 0, std::string_view aDescription = {})
+		{
+			auto ser = serializer::serialize_to_memory();
+			aWriter(ser);
+			const auto data = ser.take_serialized_memory();
+			write_entry(aKey, std::as_bytes(std::span<const char>(data.data(), data.size())), aInputHash, aDescription);
+		}
+
+		/** Loads the entry stored under the given key, or produces and appends it if there is none.
+		 *	Entries are not checked for staleness, use the overload which takes an input hash for that.
+		 *	@param	aKey			The key of the entry
+		 *	@param	aFunction		Function which gets a serializer& and returns the entry's data, or void.
+		 *	@param	aDescription	Human readable description of the entry's contents, which is stored if the entry is produced
+		 *	@returns				The result of aFunction.
+		 */
+		template <typename F>
+		auto entry(std::string_view aKey, F&& aFunction, std::string_view aDescription = {})
+		{
+			return load_or_produce(aKey, std::nullopt, std::forward<F>(aFunction), aDescription);
+		}
+
+		/** Loads the entry stored under the given key, or produces and appends it if there is none, or if it is stale.
+		 *
+		 *	The function is invoked with a serializer& in deserialize mode if an up to date entry exists, or in serialize
+		 *	mode otherwise. This matches the convention of the framework's *_cached functions, which can be invoked from
+		 *	within aFunction.
+		 *
+		 *	@param	aKey			The key of the entry
+		 *	@param	aInputHash		Hash of all the inputs which influence the entry's data, see content_hash.
+		 *							If it differs from the hash stored with the entry, the entry is produced anew.
+		 *	@param	aFunction		Function which gets a serializer& and returns the entry's data, or void.
+		 *	@param	aDescription	Human readable description of the entry's contents, which is stored if the entry is produced
+		 *	@returns				The result of aFunction.
+		 */
+		template <typename F>
+		auto entry(std::string_view aKey, uint64_t aInputHash, F&& aFunction, std::string_view aDescription = {})
+		{
+			return load_or_produce(aKey, aInputHash, std::forward<F>(aFunction), aDescription);
+		}
+
+	private:
+		// Records the time spent loading or producing an entry when it goes out of scope
+		struct entry_timer
+		{
+			~entry_timer() { mCacheFile->record_entry_time(mKey, mProduced, std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count()); }
+			cache_file* mCacheFile;
+			std::string_view mKey;
+			bool mProduced;
+			std::chrono::steady_clock::time_point mStart = std::chrono::steady_clock::now();
+		};
+
+		template <typename F>
+		auto load_or_produce(std::string_view aKey, std::optional<uint64_t> aInputHash, F&& aFunction, std::string_view aDescription)
+		{
+			using result_t = std::invoke_result_t<F, serializer&>;
+			entry_timer timer{ this, aKey, false };
+			auto existing = read_entry(aKey, aInputHash);
+			if (existing.has_value()) {
+				return aFunction(existing.value());
+			}
+
+			timer.mProduced = true;
+			auto ser = serializer::serialize_to_memory();
+			auto store = [&]() {
+				const auto data = ser.take_serialized_memory();
+				write_entry(aKey, std::as_bytes(std::span<const char>(data.data(), data.size())), aInputHash.value_or(0), aDescription);
+			};
+			if constexpr (std::is_void_v<result_t>) {
+				aFunction(ser);
+				store();
+			}
+			else {
+				auto result = aFunction(ser);
+				store();
+				return result;
+			}
+		}
+
+		void create();
+		void open();
+		void write_stored_entry(cache_file_entry aEntry, std::span<const std::byte> aData);
+		void write_table_of_contents_if_outdated();
+		void record_entry_time(std::string_view aKey, bool aProduced, double aSeconds);
+		std::shared_ptr<const memory_mapped_file> mapping_for(const cache_file_entry& aEntry);
+		const cache_file_entry* find(std::string_view aKey) const;
+
+		std::string mPath;
+		// Guards all of the following members and writing to the file:
+		mutable std::mutex mMutex;
+		// Read from the file by open(), which compact() calls while other threads may be reading or writing entries
+		compression_codec mCodec;
+		std::shared_ptr<const memory_mapped_file> mMapping;
+		std::vector<cache_file_entry> mEntries;
+		std::unordered_map<std::string, size_t> mIndexOfKey;
+		// The end of the last footer or of the entries appended behind it, where the next entry or table of contents is written
+		uint64_t mEndOfFile = 0;
+		// The size of the last written table of contents and footer, which is the valid one in the file
+		uint64_t mTableOfContentsSize = 0;
+		// Whether entries have been added since the table of contents has been written
+		bool mTableOfContentsOutdated = false;
+		cache_file_statistics mStatistics;
+	};
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** The texture slots of materials, in the order in which they are stored in compact_material_gpu_data */
+	enum struct material_texture_slot : uint32_t
+	{
+		diffuse = 0,
+		specular,
+		ambient,
+		emissive,
+		height,
+		normals,
+		shininess,
+		opacity,
+		displacement,
+		reflection,
+		lightmap,
+		extra
+	};
+
+	/** The number of texture slots of materials */
+	inline constexpr uint32_t material_texture_slot_count = 12u;
+
+	/** Flags of compact_material_gpu_data::mFeatures */
+	enum struct compact_material_feature : uint32_t
+	{
+		/** The first of 12 bits which are set for slots that contain a texture loaded from file, i.e. not a 1x1 placeholder texture */
+		has_texture = 1u << 0,
+		/** The first of 12 bits which are set for slots whose offset and tiling are not the identity (0, 0, 1, 1) */
+		has_offset_tiling = 1u << 16
+	};
+
+	/** The bit of compact_material_gpu_data::mFeatures which is set if the given slot contains a texture loaded from file */
+	inline constexpr uint32_t has_texture_bit(material_texture_slot aSlot)
+	{
+		return static_cast<uint32_t>(compact_material_feature::has_texture) << static_cast<uint32_t>(aSlot);
+	}
+
+	/** The bit of compact_material_gpu_data::mFeatures which is set if the given slot's offset and tiling are not the identity */
+	inline constexpr uint32_t has_offset_tiling_bit(material_texture_slot aSlot)
+	{
+		return static_cast<uint32_t>(compact_material_feature::has_offset_tiling) << static_cast<uint32_t>(aSlot);
+	}
+
+	/** A compact encoding of material_gpu_data which takes 128 bytes instead of 432 bytes, for shaders which are limited by
+	 *	the bandwidth of fetching materials, see pack_materials and convert_for_gpu_usage_compact.
+	 *
+	 *	- Colors are packed into unsigned normalized 8-bit components, i.e. they are clamped to [0, 1]. Only the emissive
+	 *	  color, which exceeds 1 often, the anisotropy rotation, and the custom data are packed into 16-bit floats.
+	 *	- Scalar material parameters are packed into 16-bit floats, two per element.
+	 *	- Texture indices are packed into 16 bits, two per element. 0xFFFF means that a slot has no texture.
+	 *	- Offsets and tilings are deduplicated into a table, see compact_material_table::mOffsetTilings, which is referenced
+	 *	  by 16-bit indices, two per element.
+	 *	- mFeatures tells shaders which slots contain textures, so that they can skip fetching from the others, and which
+	 *	  slots have offsets and tilings at all, see has_texture_bit and has_offset_tiling_bit.
+	 *
+	 *	The data of material_gpu_data_ext is not contained.
+	 *
+	 *	Possible corresponding GLSL data structures:
+	 *
+	 *	layout(set = 0, binding = 0) uniform sampler2D textures[];
+	 *
+	 *	struct CompactMaterialGpuData
+	 *	{
+	 *		uint mDiffuseReflectivity;		// unpackUnorm4x8
+	 *		uint mAmbientReflectivity;		// unpackUnorm4x8
+	 *		uint mSpecularReflectivity;		// unpackUnorm4x8
+	 *		uint mTransparentColor;			// unpackUnorm4x8
+	 *		uint mReflectiveColor;			// unpackUnorm4x8
+	 *		uint mAlbedo;					// unpackUnorm4x8
+	 *		uint mEmissiveColor[2];			// unpackHalf2x16: rg, ba
+	 *		uint mAnisotropyRotation[2];	// unpackHalf2x16: xy, zw
+	 *		uint mCustomData[2];			// unpackHalf2x16: xy, zw
+	 *		uint mScalars[6];				// unpackHalf2x16: (opacity, bump scaling), (shininess, shininess strength), (refraction index, reflectivity),
+	 *										//                 (metallic, smoothness), (sheen, thickness), (roughness, anisotropy)
+	 *		uint mTexIndices[6];			// Two 16-bit indices per element, the lower half first, in the order of material_texture_slot
+	 *		uint mOffsetTilingIndices[6];	// Two 16-bit indices into offsetTilings per element, like mTexIndices
+	 *		uint mFeatures;
+	 *		uint mPadding;
+	 *	};
+	 *
+	 *	layout(set = 0, binding = 1) buffer Material
+	 *	{
+	 *		CompactMaterialGpuData materials[];
+	 *	} materialsBuffer;
+	 *
+	 *	layout(set = 0, binding = 2) buffer OffsetTiling
+	 *	{
+	 *		vec4 offsetTilings[];
+	 *	} offsetTilingBuffer;
+	 *
+	 *	int texIndex(CompactMaterialGpuData m, uint slot)
+	 *	{
+	 *		uint index = (m.mTexIndices[slot / 2] >> (16 * (slot % 2))) & 0xFFFF;
+	 *		return index == 0xFFFF ? -1 : int(index);
+	 *	}
+	 *
+	 */
+	struct compact_material_gpu_data
+	{
+		alignas(4) uint32_t mDiffuseReflectivity;
+		alignas(4) uint32_t mAmbientReflectivity;
+		alignas(4) uint32_t mSpecularReflectivity;
+		alignas(4) uint32_t mTransparentColor;
+		alignas(4) uint32_t mReflectiveColor;
+		alignas(4) uint32_t mAlbedo;
+
+		alignas(4) std::array<uint32_t, 2> mEmissiveColor;
+		alignas(4) std::array<uint32_t, 2> mAnisotropyRotation;
+		alignas(4) std::array<uint32_t, 2> mCustomData;
+
+		alignas(4) std::array<uint32_t, 6> mScalars;
+
+		alignas(4) std::array<uint32_t, material_texture_slot_count / 2> mTexIndices;
+		alignas(4) std::array<uint32_t, material_texture_slot_count / 2> mOffsetTilingIndices;
+
+		alignas(4) uint32_t mFeatures;
+		alignas(4) uint32_t mPadding;
+	};
+	static_assert(sizeof(compact_material_gpu_data) == 128, "compact_material_gpu_data must match the layout of its GLSL counterpart");
+
+	/** Materials in the compact encoding, created by pack_materials */
+	struct compact_material_table
+	{
+		/** The materials, in the same order as the material_gpu_data entries they have been packed from */
+		std::vector<compact_material_gpu_data> mMaterials;
+
+		/** The distinct offsets (xy) and tilings (zw) of all texture slots, referenced by compact_material_gpu_data::mOffsetTilingIndices.
+		 *	The first entry is always the identity (0, 0, 1, 1).
+		 */
+		std::vector<glm::vec4> mOffsetTilings;
+	};
+
+	/** Packs materials into the compact encoding, see compact_material_gpu_data.
+	 *	@param	aMaterialConfigs	The material configs which aMaterials have been created from, which tell which slots contain textures
+	 *	@param	aMaterials			The materials to pack, e.g. returned by convert_for_gpu_usage
+	 *	@returns					The packed materials, and the table of their offsets and tilings
+	 *	Throws a gvk::runtime_error if a texture index does not fit into 16 bits, e.g. because textures have been packed into
+	 *	array textures, whose layers are encoded in the texture indices (see texture_packing_config), or if there are more
+	 *	than 65536 distinct offsets and tilings.
+	 */
+	compact_material_table pack_materials(std::span<const material_config> aMaterialConfigs, std::span<const material_gpu_data> aMaterials);
+
+	/** Unpacks a material from the compact encoding, e.g. to verify the precision of the encoding on the CPU.
+	 *	The texture indices of slots without texture are -1.
+	 *	@param	aMaterial		The packed material
+	 *	@param	aOffsetTilings	The table of offsets and tilings which has been packed along with the material
+	 */
+	material_gpu_data unpack_material(const compact_material_gpu_data& aMaterial, std::span<const glm::vec4> aOffsetTilings);
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Pool of textures which contain a single, constant color, e.g. the white textures and straight-up normal maps which
+	 *	gvk::convert_for_gpu_usage uses for material slots without a texture.
+	 *
+	 *	Every combination of color, format, and image usage is created only once, and handed out with shared ownership, i.e. all
+	 *	users of a color share the same image, image view, and, per filter mode, the same sampler. The colors are specified as four bytes, therefore only formats
+	 *	with four bytes per texel are supported, e.g. vk::Format::eR8G8B8A8Unorm or vk::Format::eR8G8B8A8Srgb.
+	 *
+	 *	Additionally, arbitrary colors can be packed into one array texture per format, so that all of them can be accessed
+	 *	through a single descriptor, with the layer index selecting the color.
+	 *
+	 *	The pool belongs to the context, see context_vulkan::constant_color_textures(), and is destroyed along with it.
+	 *	All methods can be invoked from multiple threads.
+	 */
+	class constant_color_texture_pool
+	{
+	public:
+		constant_color_texture_pool() = default;
+		constant_color_texture_pool(constant_color_texture_pool&&) noexcept = delete;
+		constant_color_texture_pool(const constant_color_texture_pool&) = delete;
+		constant_color_texture_pool& operator=(constant_color_texture_pool&&) noexcept = delete;
+		constant_color_texture_pool& operator=(const constant_color_texture_pool&) = delete;
+		~constant_color_texture_pool() = default;
+
+		/** A shared image view of a 1x1 texture of the given color, which is created and uploaded on first use.
+		 *	@param	aColor		The texel's bytes
+		 *	@param	aFormat		The format of the texture, which must have four bytes per texel
+		 *	@param	aImageUsage	How the image is going to be used
+		 */
+		avk::image_view image_view(std::array<uint8_t, 4> aColor, vk::Format aFormat = vk::Format::eR8G8B8A8Unorm, avk::image_usage aImageUsage = avk::image_usage::general_texture);
+
+		/** A shared image sampler of a 1x1 texture of the given color, with repeating borders.
+		 *	@param	aColor		The texel's bytes
+		 *	@param	aFormat		The format of the texture, which must have four bytes per texel
+		 *	@param	aImageUsage	How the image is going to be used
+		 *	@param	aFilterMode	The filter mode of the sampler
+		 */
+		avk::image_sampler image_sampler(std::array<uint8_t, 4> aColor, vk::Format aFormat = vk::Format::eR8G8B8A8Unorm, avk::image_usage aImageUsage = avk::image_usage::general_texture, avk::filter_mode aFilterMode = avk::filter_mode::nearest_neighbor);
+
+		/** The layer of the array texture of the given format which contains the given color. The color is added if it is not contained yet.
+		 *	Adding colors does not change the layers of the previously added ones, but invalidates the array texture, see array_image_view().
+		 */
+		uint32_t layer(std::array<uint8_t, 4> aColor, vk::Format aFormat = vk::Format::eR8G8B8A8Unorm);
+
+		/** A shared image view of the array texture of the given format, which contains all the colors added through layer() so far, as 1x1 layers.
+		 *	It is created anew when colors have been added since the previous call, i.e. image views returned previously do not contain the new colors.
+		 *	Throws a gvk::logic_error if no color has been added for the format.
+		 *	@param	aFormat		The format of the array texture
+		 *	@param	aImageUsage	How the image is going to be used
+		 */
+		avk::image_view array_image_view(vk::Format aFormat = vk::Format::eR8G8B8A8Unorm, avk::image_usage aImageUsage = avk::image_usage::general_texture);
+
+		/** The number of 1x1 textures in the pool, not counting the array textures */
+		size_t number_of_textures() const;
+
+		/** Removes all textures from the pool. Textures which are still referenced elsewhere stay alive until their last user is destroyed. */
+		void clear();
+
+	private:
+		using texture_key = std::tuple<std::array<uint8_t, 4>, vk::Format, avk::image_usage>;
+
+		struct constant_color_texture
+		{
+			avk::image_view mImageView;
+			/** The image samplers which have been requested so far, per filter mode */
+			std::map<avk::filter_mode, avk::image_sampler> mImageSamplers;
+		};
+
+		/** Creates the 1x1 texture of the given color if it does not exist yet */
+		constant_color_texture& get_or_create(std::array<uint8_t, 4> aColor, vk::Format aFormat, avk::image_usage aImageUsage);
+
+		struct array_texture
+		{
+			std::vector<std::array<uint8_t, 4>> mColors;
+			/** The image views which have been requested so far, per image usage. Empty if colors have been added since. */
+			std::map<avk::image_usage, avk::image_view> mImageViews;
+		};
+
+		mutable std::mutex mMutex;
+		std::map<texture_key, constant_color_texture> mTextures;
+		std::map<vk::Format, array_texture> mArrayTextures;
+	};
+}
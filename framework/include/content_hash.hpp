@@ -0,0 +1,57 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Computes the 64-bit xxHash (XXH64) of the given data.
+	 *	@param	aData	The data to hash
+	 *	@param	aSeed	Seed value, which can be used to chain multiple hashes
+	 */
+	uint64_t hash64(std::span<const std::byte> aData, uint64_t aSeed = 0);
+
+	/** How content_hash::add_file incorporates a file into the hash */
+	enum struct file_hash_mode
+	{
+		/** Hash the file's contents. Reliable, but the whole file has to be read. */
+		contents,
+		/** Hash the file's last modification time and its size. Fast, but touching a file changes the hash. */
+		timestamp_and_size
+	};
+
+	/** Builds a hash of all the inputs which influence a cached result, e.g. source files, import flags, and function parameters.
+	 *	Store the hash along with the cached data (see cache_file::entry) to detect stale cache entries.
+	 *
+	 *	Example:
+	 *	@code
+	 *	auto inputHash = gvk::content_hash{}.add_file(modelPath).add(aiFlags).add(maxVertices).add(maxIndices).value();
+	 *	@endcode
+	 */
+	class content_hash
+	{
+	public:
+		/** Adds raw bytes to the hash */
+		content_hash& add(std::span<const std::byte> aData);
+
+		/** Adds a string to the hash */
+		content_hash& add(std::string_view aString);
+
+		/** Adds a value of a trivially copyable type, e.g. flags or numeric parameters, to the hash */
+		template <typename T> requires (std::is_trivially_copyable_v<T> && !std::is_convertible_v<const T&, std::span<const std::byte>> && !std::is_convertible_v<const T&, std::string_view>)
+		content_hash& add(const T& aValue)
+		{
+			return add(std::span<const std::byte>(reinterpret_cast<const std::byte*>(&aValue), sizeof(T)));
+		}
+
+		/** Adds a file to the hash.
+		 *	@param	aPath	Path to the file. Throws a gvk::runtime_error if the file does not exist.
+		 *	@param	aMode	Whether to hash the file's contents or only its timestamp and size.
+		 */
+		content_hash& add_file(std::string_view aPath, file_hash_mode aMode = file_hash_mode::contents);
+
+		/** The hash of everything which has been added so far */
+		uint64_t value() const { return mValue; }
+
+	private:
+		uint64_t mValue = 0;
+	};
+}
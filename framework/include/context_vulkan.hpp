@@ -3,6 +3,9 @@
 
 namespace gvk
 {	
+	class constant_color_texture_pool;
+	class staging_ring_buffer;
+
 	// ============================== VULKAN CONTEXT ================================
 	/**	@brief Context for Vulkan
 	 *
@@ -13,7 +16,7 @@ namespace gvk
 	class context_vulkan : public context_generic_glfw, public avk::root
 	{
 	public:
-		context_vulkan() = default;
+		context_vulkan();
 		context_vulkan(const context_vulkan&) = delete;
 		context_vulkan(context_vulkan&&) = delete;
 		context_vulkan& operator=(const context_vulkan&) = delete;
@@ -164,6 +167,16 @@ namespace gvk
 		/** Used to signal the context about the end of a frame */
 		void end_frame();
 
+		/** The pool of constant-color textures which are shared by everything that uses this context,
+		 *	e.g. the placeholders for missing material textures. It is created on first use.
+		 */
+		constant_color_texture_pool& constant_color_textures();
+
+		/** The staging ring buffer which textures are uploaded through, instead of creating a staging buffer for every mip level.
+		 *	It is created on first use, with a capacity of 64 MiB.
+		 */
+		staging_ring_buffer& staging_ring();
+
 	public: // TODO: private
 		/** Queries the instance layer properties for validation layers 
 		 *  and returns true if a layer with the given name could be found.
@@ -283,6 +296,10 @@ namespace gvk
 		vk::PhysicalDeviceVulkan12Features mRequestedVulkan12DeviceFeatures;
 
 		std::deque<avk::queue> mQueues;
+
+		// Destroyed before the device, see the destructor
+		std::unique_ptr<constant_color_texture_pool> mConstantColorTextures;
+		std::unique_ptr<staging_ring_buffer> mStagingRing;
 	};
 
 }
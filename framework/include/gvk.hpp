@@ -18,6 +18,7 @@
 #include <iostream>
 #include <ostream>
 #include <fstream>
+#include <sstream>
 #include <queue>
 #include <algorithm>
 #include <variant>
@@ -27,13 +28,19 @@
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <thread>
+#include <future>
 #include <cstdlib>
+#include <cstring>
 #include <typeindex>
 #include <type_traits>
 #include <utility>
 #include <cstdint>
 #include <chrono>
 #include <filesystem>
+#include <numeric>
+#include <span>
+#include <bit>
 
 #include <cstdio>
 #include <cassert>
@@ -115,6 +122,7 @@
 // -------------------- Gears-Vk includes --------------------
 #include "format_for.hpp"
 #include "cgb_exceptions.hpp"
+#include "content_hash.hpp"
 #include "conversion_utils.hpp"
 
 #include "context_state.hpp"
@@ -128,6 +136,10 @@
 #include "context_generic_glfw.hpp"
 
 #include "math_utils.hpp"
+#include "memory_mapped_file.hpp"
+#include "async_file_streambuf.hpp"
+#include "parallel_for.hpp"
+#include "block_compression.hpp"
 #include "key_code.hpp"
 #include "key_state.hpp"
 #include "timer_frame_type.hpp"
@@ -202,6 +214,7 @@ namespace gvk {
 #include "material_config.hpp"
 #include "material_gpu_data.hpp"
 #include "material_gpu_data_ext.hpp"
+#include "compact_material_gpu_data.hpp"
 #include "material.hpp"
 #include "lightsource.hpp"
 #include "lightsource_gpu_data.hpp"
@@ -210,9 +223,24 @@ namespace gvk {
 #include "model.hpp"
 #include "orca_scene.hpp"
 #include "serializer.hpp"
+#include "cache_file.hpp"
+#include "mip_generation.hpp"
+#include "texture_compression.hpp"
+#include "texture_resolution.hpp"
+#include "ktx2_file.hpp"
 #include "image_data.hpp"
+#include "staging_ring_buffer.hpp"
+#include "texture_packing.hpp"
+#include "texture_registry.hpp"
+#include "constant_color_textures.hpp"
 #include "material_image_helpers.hpp"
+#include "texture_streaming.hpp"
 #include "meshlet_helpers.hpp"
+#include "meshlet_compression.hpp"
+#include "meshlet_metrics.hpp"
+#include "skinned_meshlet_bounds.hpp"
+#include "meshlet_streaming.hpp"
+#include "meshlet_vertex_reordering.hpp"
 
 #include "composition.hpp"
 #include "setup.hpp"
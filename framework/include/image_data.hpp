@@ -6,6 +6,22 @@ namespace gvk
 	class image_data;
 	class image_data_implementor;
 
+	/** A region of memory which image data is decoded into, see image_data_interface::set_output_allocator
+	*/
+	struct image_data_output_region
+	{
+		/** The memory which the texels are written to
+		*/
+		std::span<std::byte> mMemory;
+		/** Keeps the memory alive as long as the image data references it, e.g. the lease of a staging_allocation
+		*/
+		std::shared_ptr<void> mOwner;
+	};
+
+	/** Provides the memory which image data is decoded into, e.g. persistently mapped staging memory
+	* Invoked with the size of the memory in bytes and the alignment of its beginning. Returns no value if no memory can be provided, in which case the image data allocates the memory itself.
+	*/
+	using image_data_output_allocator = std::function<std::optional<image_data_output_region>(size_t, size_t)>;
 
 	/** Interface of image_data type, used for abstraction and implementor in bridge pattern
 	* This class should only be derived by the image_data and image_data_implementor classes
@@ -117,6 +133,18 @@ namespace gvk
 			return mPaths;
 		}
 
+		/** Set the allocator which provides the memory that the image data is decoded into when it is loaded, e.g. staging_ring_buffer::output_allocator
+		* Images which are read from KTX2 files, and images which are decoded by stb_image, are written straight into the provided memory, which saves
+		* copying them again before they are uploaded. Other images ignore the allocator, and so do KTX2 files which are flipped. The allocator must be
+		* set before the image data is loaded, and the provided memory must stay valid as long as the image data is used.
+		* Staging memory is typically write-combined, i.e. slow to read => do not decode into it if the data is read after loading, e.g. to generate MIP-maps.
+		* @param aOutputAllocator	the allocator, or an empty function to let the image data allocate the memory itself
+		*/
+		void set_output_allocator(image_data_output_allocator aOutputAllocator)
+		{
+			mOutputAllocator = std::move(aOutputAllocator);
+		}
+
 	protected:
 		
 		/** Protected constructor, used by abstraction and implementor of the image_data_interface
@@ -149,9 +177,10 @@ namespace gvk
 		* @param aLoadSrgbIfApplicable	load the texture as sRGB color-corrected data, if supported by the image loading library. If set to true, the image data may be returned in an sRGB format even if the texture file does not contain sRGB data. If set to false, the image data may be returned in a plain RGB format even if the texture contains sRGB data. It is therefore advised to set this parameter according to the color space of the texture file.
 		* @param aFlip					flip the image vertically (upside-down) if set to true. This may be needed if the layout of the image data in the texture file does not match the texture coordinates with which it is used. This parameter may not be supported for all image loaders and texture formats, in particular for some compressed textures.
 		* @param aPreferredNumberOfTextureComponents	defines the number of color channels in the returned image_data. The default of 4 corresponds to RGBA texture components. A value of 1 and 2 denote grey value and grey value with alpha, respectively. If the texture file does not contain an alpha channel, the result will be fully opaque. Note that many Vulkan implementations only support textures with RGBA components. This parameter may be ignored by the image loader.
+		* @param aOutputAllocator		provides the memory which the image data is decoded into, see set_output_allocator
 		* @return a pointer to an image data implementor instance that references the given image files
 		*/
-		static std::unique_ptr<image_data_implementor> load_image_data_from_file(const std::string& aPath, const bool aLoadHdrIfPossible = true, const bool aLoadSrgbIfApplicable = true, const bool aFlip = true, const int aPreferredNumberOfTextureComponents = 4);
+		static std::unique_ptr<image_data_implementor> load_image_data_from_file(const std::string& aPath, const bool aLoadHdrIfPossible = true, const bool aLoadSrgbIfApplicable = true, const bool aFlip = true, const int aPreferredNumberOfTextureComponents = 4, const image_data_output_allocator& aOutputAllocator = {});
 		
 		/** Load cube map image data from six individual image files using one of the available image loading libraries
 		* @param aPaths					a vector of file names of texture files to load the image data from. The vector must contain six file names, each specifying one side of a cube map texture, in the order +X, -X, +Y, -Y, +Z, -Z. The image data from all files must have the same dimensions and texture formats, after possible HDR and sRGB conversions.
@@ -170,6 +199,8 @@ namespace gvk
 		// if image should be flipped vertically when loaded, if possible
 		bool mFlip;
 		int mPreferredNumberOfTextureComponents;
+		// provides the memory which the image data is decoded into, if set
+		image_data_output_allocator mOutputAllocator;
 	};
 
 	/** Abstract base class of implementors of image data bridge pattern
@@ -273,20 +304,23 @@ namespace gvk
 
 			if (mPaths.size() == 1)
 			{
-				pimpl = load_image_data_from_file(mPaths[0], mLoadHdrIfPossible, mLoadSrgbIfApplicable, mFlip, mPreferredNumberOfTextureComponents);
+				pimpl = load_image_data_from_file(mPaths[0], mLoadHdrIfPossible, mLoadSrgbIfApplicable, mFlip, mPreferredNumberOfTextureComponents, mOutputAllocator);
 			}
 			else
 			{
 				pimpl = load_image_data_from_file(mPaths, mLoadHdrIfPossible, mLoadSrgbIfApplicable, mFlip, mPreferredNumberOfTextureComponents);
 			}
-
-			pimpl->load();
+			// load_image_data_from_file has already loaded the data
 		}
 
 		virtual vk::Format get_format() const
 		{
 			assert(!empty());
 
+			if (!mCompressedLevels.empty())
+			{
+				return mCompressedFormat;
+			}
 			return pimpl->get_format();
 		}
 
@@ -300,8 +334,12 @@ namespace gvk
 		virtual extent_type extent(const uint32_t level = 0) const
 		{
 			assert(!empty());
-			assert(level < pimpl->levels());
+			assert(level < levels());
 
+			if (const auto* l = replaced_level(0, level))
+			{
+				return l->mExtent;
+			}
 			return pimpl->extent(level);
 		}
 
@@ -310,8 +348,12 @@ namespace gvk
 			assert(!empty());
 			assert(layer < pimpl->layers());
 			assert(face < pimpl->faces());
-			assert(level < pimpl->levels());
+			assert(level < levels());
 
+			if (auto* l = replaced_level(face, level))
+			{
+				return l->mData.data();
+			}
 			return pimpl->get_data(layer, face, level);
 		}
 
@@ -319,14 +361,22 @@ namespace gvk
 		{
 			assert(!empty());
 
-			return pimpl->size();
+			if (!mCompressedLevels.empty())
+			{
+				return levels_size(mCompressedLevels);
+			}
+			return (mDownscaledLevels.empty() ? pimpl->size() : levels_size(mDownscaledLevels)) + levels_size(mGeneratedLevels);
 		}
 
 		virtual size_t size(const uint32_t level) const
 		{
 			assert(!empty());
-			assert(level < pimpl->levels());
+			assert(level < levels());
 
+			if (const auto* l = replaced_level(0, level))
+			{
+				return l->mData.size();
+			}
 			return pimpl->size(level);
 		}
 
@@ -334,6 +384,18 @@ namespace gvk
 		{
 			assert(!empty());
 
+			if (!mCompressedLevels.empty())
+			{
+				return static_cast<uint32_t>(mCompressedLevels[0].size());
+			}
+			if (!mGeneratedLevels.empty())
+			{
+				return 1 + static_cast<uint32_t>(mGeneratedLevels[0].size());
+			}
+			if (!mDownscaledLevels.empty())
+			{
+				return static_cast<uint32_t>(mDownscaledLevels[0].size());
+			}
 			return pimpl->levels();
 		}
 
@@ -370,12 +432,96 @@ namespace gvk
 			return !(pimpl && !pimpl->empty());
 		}
 
+		/** Generate all mipmap levels below level 0 on the CPU, which are then returned by levels(), extent(), get_data(), and size() like loaded levels
+		* The image data must have been loaded. Nothing happens if the image data already contains more than one level, or if its format is not supported by can_generate_mip_chain_on_cpu.
+		* @param aConfig	the filter and alpha coverage settings for generating the levels
+		*/
+		void generate_mip_chain(const mip_generation_config& aConfig = {});
+
+		/** Reduce the resolution on the CPU, so that neither the width nor the height of level 0 exceeds the given extent
+		* If the image data contains multiple mipmap levels, the finest levels are dropped, which also works for block-compressed formats. Otherwise, level 0 is resampled
+		* to fit the given extent, keeping the aspect ratio, and mipmap levels should be generated afterwards. The image data must have been loaded.
+		* Nothing happens if the image already fits, if it has multiple layers, or if it has only one level in a format which is not supported by can_generate_mip_chain_on_cpu.
+		* @param aMaxExtent	the maximum width and height of level 0
+		* @param aFilter	the filter for resampling level 0
+		*/
+		void downscale(uint32_t aMaxExtent, mip_filter aFilter = mip_filter::kaiser);
+
+		/** Compress all mipmap levels into a block-compressed format on the CPU, which is then returned by get_format(), and whose blocks are returned by get_data()
+		* Mipmap levels should be generated before, since they can not be generated from block-compressed data.
+		* Nothing happens if aCompression is texture_compression::none, or if the format is not supported by can_compress_texture.
+		* @param aCompression	the block-compressed format to use
+		*/
+		void compress(texture_compression aCompression);
+
 	private:
+		// Returns the generated or compressed level which replaces the given level of pimpl, if any
+		const mip_level* replaced_level(const uint32_t aFace, const uint32_t aLevel) const
+		{
+			if (!mCompressedLevels.empty())
+			{
+				return &mCompressedLevels[aFace][aLevel];
+			}
+			if (aLevel > 0 && !mGeneratedLevels.empty())
+			{
+				return &mGeneratedLevels[aFace][aLevel - 1];
+			}
+			if (!mDownscaledLevels.empty())
+			{
+				return &mDownscaledLevels[aFace][aLevel];
+			}
+			return nullptr;
+		}
+
+		mip_level* replaced_level(const uint32_t aFace, const uint32_t aLevel)
+		{
+			return const_cast<mip_level*>(std::as_const(*this).replaced_level(aFace, aLevel));
+		}
+
+		static size_t levels_size(const std::vector<std::vector<mip_level>>& aLevels)
+		{
+			size_t result = 0;
+			for (const auto& faceLevels : aLevels)
+			{
+				for (const auto& level : faceLevels)
+				{
+					result += level.mData.size();
+				}
+			}
+			return result;
+		}
+
 		// for the pimpl (pointer-to-implementation) idiom, the following should hold true: 
 		// use unique_ptr
 		// allocate pimpl in out-of-line constructor
 		// deallocate in out-of-line destructor (since the complete type is only known after class definition)
 		// for user-defined destructor, there is no compiler-generated copy constructor and move-assignment operator; define out-of-line if needed
 		std::unique_ptr<image_data_implementor> pimpl;
+
+		// all mipmap levels which remain after reducing the resolution on the CPU, per face
+		std::vector<std::vector<mip_level>> mDownscaledLevels;
+		// mipmap levels 1 to n, which have been generated on the CPU, per face
+		std::vector<std::vector<mip_level>> mGeneratedLevels;
+		// all mipmap levels, block-compressed on the CPU into mCompressedFormat, per face
+		std::vector<std::vector<mip_level>> mCompressedLevels;
+		vk::Format mCompressedFormat = vk::Format::eUndefined;
 	};
+
+	/** Load (i.e. decode) multiple image_data instances in parallel on the threads of the worker_pool, see parallel_for
+	* Instances which have already been loaded are skipped. If loading any of the instances fails, the remaining instances are skipped and the first exception is rethrown after all worker threads have finished.
+	* @param aImageData			the image_data instances to load
+	* @param aMipChainConfig	if set, the mipmap levels of every instance are generated on the worker threads as well, see image_data::generate_mip_chain
+	* @param aNumThreads		the maximum number of threads to use, including the calling thread. If set to 0, all threads of the worker_pool are used.
+	* @param aMaxExtents		if not empty, one maximum extent per instance, to which its resolution is reduced on the worker threads before mipmap levels are generated, see image_data::downscale
+	* @param aDownscaleFilter	the filter for reducing the resolution of instances which have only one level
+	*/
+	void load_image_data_in_parallel(std::span<image_data> aImageData, std::optional<mip_generation_config> aMipChainConfig = {}, size_t aNumThreads = 0,
+		std::span<const std::optional<uint32_t>> aMaxExtents = {}, mip_filter aDownscaleFilter = mip_filter::kaiser);
+
+	/** Query the extent of level 0 of an image file without decoding the image, if the file format allows to
+	* Only the header is read for KTX2 files and for the formats supported by stb_image. Other files are loaded completely.
+	* @param aPath	file name of a texture file
+	* @return the extent, or no value if the file could not be read
+	*/
+	std::optional<vk::Extent3D> query_image_extent(const std::string& aPath);
 }
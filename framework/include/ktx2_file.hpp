@@ -0,0 +1,91 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Supercompression schemes which can be applied to the levels of a KTX2 file */
+	enum struct ktx2_supercompression : uint32_t
+	{
+		none = 0,
+		/** Used for ETC1S-encoded universal textures, which have to be transcoded with Basis Universal */
+		basis_lz = 1,
+		zstd = 2,
+		zlib = 3
+	};
+
+	/** Reader for texture files in the KTX2 container format.
+	 *	The file is memory mapped and only its header and level index are parsed on construction. The levels can then be read one by one
+	 *	into caller-provided memory, e.g. a staging buffer, and Zstandard-supercompressed levels are decompressed directly into it.
+	 *	Levels which are not supercompressed are stored in their Vulkan format, which includes block-compressed formats.
+	 */
+	class ktx2_file
+	{
+	public:
+		/** Opens a KTX2 file and parses its header.
+		 *	@param	aPath	Path to the file. Throws a gvk::runtime_error if it is not a valid KTX2 file, or if its levels cannot be read,
+		 *					i.e. if they are supercompressed with BasisLZ or ZLIB, or if they are stored in a universal format (UASTC or ETC1S).
+		 *					Also throws if the size of a level in the level index does not match the format and extent of the level.
+		 */
+		explicit ktx2_file(std::string_view aPath);
+
+		ktx2_file(ktx2_file&&) noexcept = default;
+		ktx2_file(const ktx2_file&) = delete;
+		ktx2_file& operator=(ktx2_file&&) noexcept = default;
+		ktx2_file& operator=(const ktx2_file&) = delete;
+		~ktx2_file() = default;
+
+		/** Returns true if the file at the given path starts with the KTX2 file identifier */
+		static bool has_ktx2_identifier(std::string_view aPath);
+
+		/** The Vulkan format of the texels */
+		vk::Format format() const { return mFormat; }
+
+		/** The image type, which depends on which of the dimensions are used */
+		vk::ImageType target() const;
+
+		/** The extent of the given level, which must be less than levels(). Unused dimensions are 1. */
+		vk::Extent3D extent(uint32_t aLevel = 0) const;
+
+		/** The number of levels which are stored in the file */
+		uint32_t levels() const { return static_cast<uint32_t>(mLevelIndex.size()); }
+
+		/** The number of array layers, 1 for textures which are not arrays */
+		uint32_t layers() const { return mLayers; }
+
+		/** The number of faces, 6 for cubemaps and 1 otherwise */
+		uint32_t faces() const { return mFaces; }
+
+		/** The supercompression scheme of the levels */
+		ktx2_supercompression supercompression() const { return mSupercompression; }
+
+		/** The size of one image of the given level, i.e. of one face of one layer, including all of its depth slices */
+		size_t image_size(uint32_t aLevel) const;
+
+		/** The size of the given level after decompression, i.e. of the images of all layers and faces */
+		size_t level_size(uint32_t aLevel) const;
+
+		/** Reads one level into caller-provided memory, and decompresses it if it is supercompressed.
+		 *	The images are stored layer by layer, and face by face within each layer, each taking image_size(aLevel) bytes.
+		 *	@param	aLevel			The level to read
+		 *	@param	aDestination	Memory for the level, whose size must be exactly level_size(aLevel)
+		 */
+		void read_level(uint32_t aLevel, std::span<std::byte> aDestination) const;
+
+	private:
+		struct level_index_entry
+		{
+			uint64_t mByteOffset;
+			uint64_t mByteLength;
+			uint64_t mUncompressedByteLength;
+		};
+
+		std::string mPath;
+		memory_mapped_file mFile;
+		vk::Format mFormat = vk::Format::eUndefined;
+		vk::Extent3D mExtent;
+		uint32_t mLayers = 1;
+		uint32_t mFaces = 1;
+		ktx2_supercompression mSupercompression = ktx2_supercompression::none;
+		std::vector<level_index_entry> mLevelIndex;
+	};
+}
@@ -151,7 +151,7 @@ namespace gvk
 	* @param aMemoryUsage	the intended memory usage of the returned image resource.
 	* @param aImageUsage	the intended image usage of the returned image resource.
 	* @param aSyncHandler	the sync handler to use creating the image resource.
-	* @param aSerializer	a serializer to use for caching data loaded from disk.
+	* @param aSerializer	a serializer to use for caching data loaded from disk. The timestamp and size of the file are stored along with the data; if they differ when the data is read from the cache file, a gvk::runtime_error is thrown.
 	*/
 	avk::image create_cubemap_from_file_cached(const std::string& aPath, bool aLoadHdrIfPossible = true, bool aLoadSrgbIfApplicable = true, bool aFlip = true,
 		int aPreferredNumberOfTextureComponents = 4, avk::memory_usage aMemoryUsage = avk::memory_usage::device,
@@ -204,7 +204,7 @@ namespace gvk
 	* @param aMemoryUsage	the intended memory usage of the returned image resource.
 	* @param aImageUsage	the intended image usage of the returned image resource.
 	* @param aSyncHandler	the sync handler to use creating the image resource.
-	* @param aSerializer	a serializer to use for caching data loaded from disk. 
+	* @param aSerializer	a serializer to use for caching data loaded from disk. The timestamps and sizes of the files are stored along with the data; if they differ when the data is read from the cache file, a gvk::runtime_error is thrown.
 	*/
 	avk::image create_cubemap_from_file_cached(const std::vector<std::string>& aPaths, bool aLoadHdrIfPossible = true, bool aLoadSrgbIfApplicable = true, bool aFlip = true,
 		int aPreferredNumberOfTextureComponents = 4, avk::memory_usage aMemoryUsage = avk::memory_usage::device,
@@ -245,6 +245,8 @@ namespace gvk
 
 	/** Create image from image_data, with optional caching
 	* Loads image data from an image_data object or the serializer cache.
+	* If aImageUsage contains avk::image_usage::mip_mapped, missing mipmap levels are generated on the CPU and stored in the cache along with the base level.
+	* To use other filter settings than the default ones, call aImageData.generate_mip_chain before.
 	* @param aImageData		the image data to create the image from.
 	* @param aMemoryUsage	the intended memory usage of the returned image resource.
 	* @param aImageUsage	the intended image usage of the returned image resource.
@@ -291,7 +293,7 @@ namespace gvk
 	* @param aMemoryUsage	the intended memory usage of the returned image resource.
 	* @param aImageUsage	the intended image usage of the returned image resource.
 	* @param aSyncHandler	the sync handler to use creating the image resource.
-	* @param aSerializer	a serializer to use for caching data loaded from disk.
+	* @param aSerializer	a serializer to use for caching data loaded from disk. The timestamp and size of the file are stored along with the data; if they differ when the data is read from the cache file, a gvk::runtime_error is thrown.
 	*/
 	avk::image create_image_from_file_cached(const std::string& aPath, bool aLoadHdrIfPossible = true, bool aLoadSrgbIfApplicable = true, bool aFlip = true, int aPreferredNumberOfTextureComponents = 4, avk::memory_usage aMemoryUsage = avk::memory_usage::device, avk::image_usage aImageUsage = avk::image_usage::general_texture, avk::sync aSyncHandler = avk::sync::wait_idle(), std::optional<std::reference_wrapper<gvk::serializer>> aSerializer = {});
 
@@ -1393,8 +1395,17 @@ namespace gvk
 		avk::image_usage aImageUsage,
 		avk::filter_mode aTextureFilterMode,
 		avk::sync aSyncHandler,
-		std::optional<std::reference_wrapper<gvk::serializer>> aSerializer = {})
-	{
+		std::optional<std::reference_wrapper<gvk::serializer>> aSerializer = {},
+		std::optional<texture_compression_config> aTextureCompression = {},
+		std::optional<texture_resolution_policy> aTextureResolution = {},
+		std::optional<std::reference_wrapper<texture_registry>> aTextureRegistry = {},
+		std::optional<texture_packing_config> aTexturePacking = {},
+		std::optional<std::reference_wrapper<std::vector<avk::image_sampler>>> aArrayImageSamplers = {})
+	{
+		if (aTexturePacking.has_value() && aTexturePacking->mMinArrayLayers.has_value() && !aArrayImageSamplers.has_value()) {
+			throw gvk::logic_error("Textures can only be packed into array textures if a vector for the image samplers of the array textures is passed.");
+		}
+
 		// These are the texture names loaded from file -> mapped to vector of usage-pointers
 		std::unordered_map<std::string, std::vector<std::tuple<std::array<avk::border_handling_mode, 2>, std::vector<int*>>>> texNamesToBorderHandlingToUsages;
 
@@ -1606,6 +1617,123 @@ namespace gvk
 			}
 		}
 
+		// If requested, choose the block compression of every texture by the material slots it is used in.
+		// Textures which are used in slots of different kinds are compressed like color textures.
+		std::unordered_map<std::string, texture_compression> texCompressions;
+		if (aTextureCompression.has_value()) {
+			auto useAs = [&texCompressions, &aTextureCompression](const std::string& bPath, texture_compression bCompression) {
+				if (bPath.empty()) {
+					return;
+				}
+				auto [it, inserted] = texCompressions.try_emplace(avk::clean_up_path(bPath), bCompression);
+				if (!inserted && it->second != bCompression) {
+					it->second = aTextureCompression->mColorTextures;
+				}
+			};
+			for (auto& mc : aMaterialConfigs) {
+				useAs(mc.mDiffuseTex,		aTextureCompression->mColorTextures);
+				useAs(mc.mSpecularTex,		aTextureCompression->mColorTextures);
+				useAs(mc.mAmbientTex,		aTextureCompression->mColorTextures);
+				useAs(mc.mEmissiveTex,		aTextureCompression->mColorTextures);
+				useAs(mc.mHeightTex,		aTextureCompression->mMasks);
+				useAs(mc.mNormalsTex,		aTextureCompression->mNormalMaps);
+				useAs(mc.mShininessTex,		aTextureCompression->mMasks);
+				useAs(mc.mOpacityTex,		aTextureCompression->mMasks);
+				useAs(mc.mDisplacementTex,	aTextureCompression->mMasks);
+				useAs(mc.mReflectionTex,	aTextureCompression->mColorTextures);
+				useAs(mc.mLightmapTex,		aTextureCompression->mColorTextures);
+				useAs(mc.mExtraTex,			aTextureCompression->mColorTextures);
+			}
+		}
+
+		// If requested, choose the maximum extent of every texture by the material slots it is used in, and by the memory budget.
+		// Textures which are used in slots of different kinds get the largest of their maximum extents.
+		// The resulting images are stored in the cache file, i.e. the decision does not have to be made again when deserializing.
+		std::unordered_map<std::string, std::optional<uint32_t>> texMaxExtents;
+		if (aTextureResolution.has_value() &&
+			(!aSerializer || (aSerializer && (aSerializer->get().mode() == serializer::mode::serialize)))) {
+			auto useAs = [&texMaxExtents](const std::string& bPath, std::optional<uint32_t> bMaxExtent) {
+				if (bPath.empty()) {
+					return;
+				}
+				auto [it, inserted] = texMaxExtents.try_emplace(avk::clean_up_path(bPath), bMaxExtent);
+				if (!inserted && it->second.has_value()) {
+					it->second = bMaxExtent.has_value() ? std::max(*it->second, *bMaxExtent) : bMaxExtent;
+				}
+			};
+			for (auto& mc : aMaterialConfigs) {
+				useAs(mc.mDiffuseTex,		aTextureResolution->mMaxColorTextureExtent);
+				useAs(mc.mSpecularTex,		aTextureResolution->mMaxColorTextureExtent);
+				useAs(mc.mAmbientTex,		aTextureResolution->mMaxColorTextureExtent);
+				useAs(mc.mEmissiveTex,		aTextureResolution->mMaxColorTextureExtent);
+				useAs(mc.mHeightTex,		aTextureResolution->mMaxMaskExtent);
+				useAs(mc.mNormalsTex,		aTextureResolution->mMaxNormalMapExtent);
+				useAs(mc.mShininessTex,		aTextureResolution->mMaxMaskExtent);
+				useAs(mc.mOpacityTex,		aTextureResolution->mMaxMaskExtent);
+				useAs(mc.mDisplacementTex,	aTextureResolution->mMaxMaskExtent);
+				useAs(mc.mReflectionTex,	aTextureResolution->mMaxColorTextureExtent);
+				useAs(mc.mLightmapTex,		aTextureResolution->mMaxColorTextureExtent);
+				useAs(mc.mExtraTex,			aTextureResolution->mMaxColorTextureExtent);
+			}
+
+			if (aTextureResolution->mMemoryBudget.has_value()) {
+				// Only the headers of most image files have to be read to estimate the memory of all textures:
+				std::vector<std::string> paths;
+				std::vector<texture_resolution_request> requests;
+				for (const auto& [path, maxExtent] : texMaxExtents) {
+					const auto extent = query_image_extent(path);
+					if (!extent.has_value()) {
+						continue;
+					}
+					const auto it = texCompressions.find(path);
+					paths.push_back(path);
+					requests.push_back(texture_resolution_request{ *extent, maxExtent, bytes_per_texel(texCompressions.end() == it ? texture_compression::none : it->second) });
+				}
+				const bool mipMapped = (static_cast<int>(aImageUsage) & static_cast<int>(avk::image_usage::mip_mapped)) > 0;
+				const auto maxExtents = fit_texture_resolutions(requests, aTextureResolution->mMemoryBudget, aTextureResolution->mMinExtent, mipMapped);
+				for (size_t i = 0; i < paths.size(); ++i) {
+					texMaxExtents[paths[i]] = maxExtents[i];
+				}
+			}
+		}
+
+		// Textures which are in the texture registry already, and textures with the same contents as other ones, are not loaded again.
+		// The registry is not used together with a serializer, because the cache file must contain all images which are deserialized.
+		// It is not used together with texture packing either, because packed textures share their images with other textures.
+		const bool useTextureRegistry = aTextureRegistry.has_value() && !aSerializer && !aTexturePacking.has_value();
+		std::unordered_map<std::string, uint64_t> registryKeys;
+		std::unordered_map<std::string, avk::image_view> registeredImageViews;
+		std::set<std::string> duplicateTextures; // Their contents are loaded for another path during this call
+		if (useTextureRegistry) {
+			// The keys hash the files' contents (unless the registry has hashed them before) => compute them in parallel:
+			std::vector<const std::string*> paths;
+			for (const auto& pair : texNamesToBorderHandlingToUsages) {
+				paths.push_back(&pair.first);
+			}
+			std::vector<uint64_t> keys(paths.size());
+			parallel_for(paths.size(), [&](size_t i) {
+				const auto& path = *paths[i];
+				const auto it = texCompressions.find(path);
+				const auto maxExtentIt = texMaxExtents.find(path);
+				keys[i] = aTextureRegistry->get().key(path, srgbTextures.contains(path), aFlipTextures, 4, aImageUsage,
+					texCompressions.end() == it ? texture_compression::none : it->second,
+					texMaxExtents.end() == maxExtentIt ? std::optional<uint32_t>{} : maxExtentIt->second);
+			});
+
+			std::unordered_set<uint64_t> keysToLoad;
+			for (size_t i = 0; i < paths.size(); ++i) {
+				const auto& path = *paths[i];
+				const auto key = keys[i];
+				registryKeys.emplace(path, key);
+				if (auto imgView = aTextureRegistry->get().acquire(key)) {
+					registeredImageViews.emplace(path, std::move(*imgView));
+				}
+				else if (!keysToLoad.insert(key).second) {
+					duplicateTextures.insert(path);
+				}
+			}
+		}
+
 		size_t numTexUsages = 0;
 		for (const auto& entry : texNamesToBorderHandlingToUsages) {
 			numTexUsages += entry.second.size();
@@ -1614,7 +1742,8 @@ namespace gvk
 		size_t numWhiteTexUsages = whiteTexUsages.empty() ? 0 : 1;
 		size_t numStraightUpNormalTexUsages = (straightUpNormalTexUsages.empty() ? 0 : 1);
 		size_t numTexNamesToBorderHandlingToUsages = texNamesToBorderHandlingToUsages.size();
-		auto numImageViews = numTexNamesToBorderHandlingToUsages + numWhiteTexUsages + numStraightUpNormalTexUsages;
+		// The white and the normal texture are shared through the context's pool => they are neither uploaded nor serialized
+		auto numImageViews = numTexNamesToBorderHandlingToUsages - registeredImageViews.size() - duplicateTextures.size();
 
 		if (aSerializer) {
 			aSerializer->get().archive(numWhiteTexUsages);
@@ -1622,12 +1751,16 @@ namespace gvk
 			aSerializer->get().archive(numImageViews);
 			aSerializer->get().archive(numTexNamesToBorderHandlingToUsages);
 		}
+		// Written after every serialized image and checked after every deserialized one, so that a serialize branch and a
+		// deserialize branch which do not archive the same data are detected instead of reading garbage from the cache file:
+		constexpr uint32_t serializedImageMarker = 0x494D4731u; // "IMG1"
 
 		const auto numSamplers = numTexUsages + numWhiteTexUsages + numStraightUpNormalTexUsages;
 		std::vector<avk::image_sampler> imageSamplers;
 		imageSamplers.reserve(numSamplers);
 
-		auto getSync = [numImageViews, &aSyncHandler, lSyncCount = size_t{ 0 }]() mutable->avk::sync {
+		// numImageViews is captured by reference, because it is only known after all textures have been decoded if they are packed:
+		auto getSync = [&numImageViews, &aSyncHandler, lSyncCount = size_t{ 0 }]() mutable->avk::sync {
 			++lSyncCount;
 			if (lSyncCount < numImageViews) {
 				return avk::sync::auxiliary_with_barriers(aSyncHandler, avk::sync::steal_before_handler_on_demand, {}); // Invoke external sync exactly once (if there is something to sync)
@@ -1636,19 +1769,9 @@ namespace gvk
 			return std::move(aSyncHandler); // For the last image, pass the main sync => this will also have the after-handler invoked.
 		};
 
-		// Create the white texture and assign its index to all usages
+		// Use the white texture of the context's pool and assign its index to all usages
 		if (numWhiteTexUsages > 0) {
-			auto imgView = gvk::context().create_image_view(create_1px_texture_cached({ 255, 255, 255, 255 }, vk::Format::eR8G8B8A8Unorm, avk::memory_usage::device, aImageUsage, getSync(), aSerializer));
-			avk::sampler smplr;
-			if (aSerializer)
-			{
-				smplr = create_sampler_cached(aSerializer->get(), avk::filter_mode::nearest_neighbor, avk::border_handling_mode::repeat);
-			}
-			else
-			{
-				smplr = context().create_sampler(avk::filter_mode::nearest_neighbor, avk::border_handling_mode::repeat);
-			}
-			imageSamplers.push_back(gvk::context().create_image_sampler(avk::owned(imgView), avk::owned(smplr)));
+			imageSamplers.push_back(context().constant_color_textures().image_sampler({ 255, 255, 255, 255 }, vk::Format::eR8G8B8A8Unorm, aImageUsage, aTextureFilterMode));
 
 			// Assign this image_sampler's index wherever it is referenced:
 			if (!aSerializer ||
@@ -1660,19 +1783,9 @@ namespace gvk
 			}
 		}
 
-		// Create the normal texture, containing a normal pointing straight up, and assign to all usages
+		// Use the normal texture of the context's pool, containing a normal pointing straight up, and assign it to all usages
 		if (numStraightUpNormalTexUsages > 0) {
-			auto imgView = gvk::context().create_image_view(create_1px_texture_cached({ 127, 127, 255, 0 }, vk::Format::eR8G8B8A8Unorm, avk::memory_usage::device, aImageUsage, getSync(), aSerializer));
-			avk::sampler smplr;
-			if (aSerializer)
-			{
-				smplr = create_sampler_cached(aSerializer->get(), avk::filter_mode::nearest_neighbor, avk::border_handling_mode::repeat);
-			}
-			else
-			{
-				smplr = context().create_sampler(avk::filter_mode::nearest_neighbor, avk::border_handling_mode::repeat);
-			}
-			imageSamplers.push_back(gvk::context().create_image_sampler(avk::owned(imgView), avk::owned(smplr)));
+			imageSamplers.push_back(context().constant_color_textures().image_sampler({ 127, 127, 255, 0 }, vk::Format::eR8G8B8A8Unorm, aImageUsage, aTextureFilterMode));
 
 			// Assign this image_sampler's index wherever it is referenced:
 			if (!aSerializer ||
@@ -1687,26 +1800,35 @@ namespace gvk
 		// Load all the images from file, and assign them to all usages
 		if (!aSerializer ||
 			(aSerializer && (aSerializer->get().mode() == serializer::mode::serialize))) {
+			// Decoding the image files dominates the loading times => decode them on multiple threads, batch by batch.
+			// While a batch is being uploaded on this thread, the next batch is decoded in the background. Images are
+			// still uploaded in a fixed order, so that they are serialized in the same order as they are deserialized.
+			std::vector<decltype(texNamesToBorderHandlingToUsages)::value_type*> texturesToLoad;
+			texturesToLoad.reserve(texNamesToBorderHandlingToUsages.size());
 			for (auto& pair : texNamesToBorderHandlingToUsages) {
 				assert(!pair.first.empty());
+				if (registeredImageViews.contains(pair.first) || duplicateTextures.contains(pair.first)) {
+					continue;
+				}
+				texturesToLoad.push_back(&pair);
+			}
 
-				bool potentiallySrgb = srgbTextures.contains(pair.first);
-
-				// create_image_from_file_cached takes the serializer as an optional,
-				// therefore the call is safe with and without one
-				auto imgView = context().create_image_view(create_image_from_file_cached(pair.first, true, potentiallySrgb, aFlipTextures, 4, avk::memory_usage::device, aImageUsage, getSync(), aSerializer));
-				assert(!pair.second.empty());
+			// Create the image samplers of a texture, and assign them to all of its usages
+			auto addImageSamplers = [&](std::vector<std::tuple<std::array<avk::border_handling_mode, 2>, std::vector<int*>>>& bBhModesAndUsages, avk::image_view bImgView) {
+				assert(!bBhModesAndUsages.empty());
 
 				// It is now possible that an image can be referenced from different samplers, which adds support for different
 				// usages of an image, e.g. once it is used as a tiled texture, at a different place it is clamped to edge, etc.
 				// If we are serializing, we need to store how many different samplers are referencing the image:
-				auto numDifferentSamplers = static_cast<int>(pair.second.size());
+				auto numDifferentSamplers = static_cast<int>(bBhModesAndUsages.size());
 				if (aSerializer) {
+					auto marker = serializedImageMarker;
+					aSerializer->get().archive(marker);
 					aSerializer->get().archive(numDifferentSamplers);
 				}
 
 				// There can be different border handling types specified for the textures
-				for (auto& [bhModes, usages] : pair.second) {
+				for (auto& [bhModes, usages] : bBhModesAndUsages) {
 					assert(!usages.empty());
 					
 					avk::sampler smplr;
@@ -1720,11 +1842,11 @@ namespace gvk
 
 					if (numDifferentSamplers > 1) {
 						// If we indeed have different border handling modes, create multiple samplers and share the image view resource among them:
-						imageSamplers.push_back(context().create_image_sampler(avk::shared(imgView), avk::owned(smplr)));
+						imageSamplers.push_back(context().create_image_sampler(avk::shared(bImgView), avk::owned(smplr)));
 					}
 					else {
 						// There is only one border handling mode:
-						imageSamplers.push_back(context().create_image_sampler(avk::owned(imgView), avk::owned(smplr)));
+						imageSamplers.push_back(context().create_image_sampler(avk::owned(bImgView), avk::owned(smplr)));
 					}
 
 					// Assign the texture usages:
@@ -1733,19 +1855,193 @@ namespace gvk
 						*img = index;
 					}
 				}
+			};
+
+			// If requested, textures are packed into atlases and array textures once all of them have been decoded, see texture_packing_config.
+			// Packing needs the offset and tiling of every texture usage, and it is not supported together with a serializer.
+			const bool packTextures = aTexturePacking.has_value() && !aSerializer && std::is_convertible<T&, material_gpu_data&>::value;
+			std::vector<decltype(texNamesToBorderHandlingToUsages)::value_type*> texturesToPack;
+			std::vector<image_data> imageDataToPack;
+
+			const size_t batchSize = 2 * static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u));
+			// Generate the MIP-maps on the decoding threads as well, create_image_from_image_data_cached uploads them then:
+			const auto mipChainConfig = (static_cast<int>(aImageUsage) & static_cast<int>(avk::image_usage::mip_mapped)) > 0
+				? std::optional<mip_generation_config>{ mip_generation_config{} }
+				: std::optional<mip_generation_config>{};
+			auto decodeBatch = [&](size_t bFirst) {
+				std::vector<image_data> batch;
+				std::vector<texture_compression> compressions;
+				std::vector<std::optional<uint32_t>> maxExtents;
+				for (size_t i = bFirst; i < std::min(bFirst + batchSize, texturesToLoad.size()); ++i) {
+					const auto& path = texturesToLoad[i]->first;
+					batch.push_back(get_image_data(path, true, srgbTextures.contains(path), aFlipTextures, 4));
+					const auto it = texCompressions.find(path);
+					compressions.push_back(texCompressions.end() == it ? texture_compression::none : it->second);
+					const auto maxExtentIt = texMaxExtents.find(path);
+					maxExtents.push_back(texMaxExtents.end() == maxExtentIt ? std::optional<uint32_t>{} : maxExtentIt->second);
+					// Textures whose decoded levels are uploaded as they are, are decoded straight into staging memory. Staging memory is
+					// typically write-combined, i.e. slow to read => not if MIP-maps are generated from it, or if it is serialized.
+					// Textures to pack are kept until all of them have been decoded, i.e. they would occupy the staging memory for too long.
+					if (texture_compression::none == compressions.back() && !maxExtents.back().has_value() && !packTextures && !mipChainConfig.has_value() && !aSerializer) {
+						batch.back().set_output_allocator(context().staging_ring().output_allocator());
+					}
+				}
+				const auto downscaleFilter = aTextureResolution.has_value() ? aTextureResolution->mFilter : mip_filter::kaiser;
+				return std::async(std::launch::async, [lBatch = std::move(batch), lCompressions = std::move(compressions), lMaxExtents = std::move(maxExtents), mipChainConfig, downscaleFilter]() mutable {
+					// The resolution is reduced before MIP-maps are generated, and before the textures are compressed:
+					load_image_data_in_parallel(lBatch, mipChainConfig, 0, lMaxExtents, downscaleFilter);
+					// Every texture is compressed on multiple threads => compress one after the other:
+					for (size_t i = 0; i < lBatch.size(); ++i) {
+						lBatch[i].compress(lCompressions[i]);
+					}
+					return std::move(lBatch);
+				});
+			};
+
+			std::future<std::vector<image_data>> nextBatch;
+			if (!texturesToLoad.empty()) {
+				nextBatch = decodeBatch(0);
+			}
+			for (size_t batchFirst = 0; batchFirst < texturesToLoad.size(); batchFirst += batchSize) {
+				auto batch = nextBatch.get();
+				if (batchFirst + batchSize < texturesToLoad.size()) {
+					nextBatch = decodeBatch(batchFirst + batchSize);
+				}
+
+				for (size_t i = 0; i < batch.size(); ++i) {
+					auto& pair = *texturesToLoad[batchFirst + i];
+					if (packTextures) {
+						texturesToPack.push_back(&pair);
+						imageDataToPack.push_back(std::move(batch[i]));
+						continue;
+					}
+
+					// create_image_from_image_data_cached takes the serializer as an optional,
+					// therefore the call is safe with and without one
+					auto imgView = context().create_image_view(create_image_from_image_data_cached(batch[i], avk::memory_usage::device, aImageUsage, getSync(), aSerializer));
+					if (useTextureRegistry) {
+						imgView = aTextureRegistry->get().add(registryKeys.at(pair.first), std::move(imgView), batch[i].size());
+					}
+					addImageSamplers(pair.second, std::move(imgView));
+				}
+			}
+
+			if constexpr (std::is_convertible<T&, material_gpu_data&>::value) {
+				if (packTextures) {
+					// The offset and tiling of every texture usage, which are changed for textures in atlases:
+					std::unordered_map<int*, glm::vec4*> offsetTilings;
+					for (auto& entry : result) {
+						material_gpu_data& mgd = static_cast<material_gpu_data&>(entry);
+						offsetTilings.emplace(&mgd.mDiffuseTexIndex,		&mgd.mDiffuseTexOffsetTiling);
+						offsetTilings.emplace(&mgd.mSpecularTexIndex,		&mgd.mSpecularTexOffsetTiling);
+						offsetTilings.emplace(&mgd.mAmbientTexIndex,		&mgd.mAmbientTexOffsetTiling);
+						offsetTilings.emplace(&mgd.mEmissiveTexIndex,		&mgd.mEmissiveTexOffsetTiling);
+						offsetTilings.emplace(&mgd.mHeightTexIndex,			&mgd.mHeightTexOffsetTiling);
+						offsetTilings.emplace(&mgd.mNormalsTexIndex,		&mgd.mNormalsTexOffsetTiling);
+						offsetTilings.emplace(&mgd.mShininessTexIndex,		&mgd.mShininessTexOffsetTiling);
+						offsetTilings.emplace(&mgd.mOpacityTexIndex,		&mgd.mOpacityTexOffsetTiling);
+						offsetTilings.emplace(&mgd.mDisplacementTexIndex,	&mgd.mDisplacementTexOffsetTiling);
+						offsetTilings.emplace(&mgd.mReflectionTexIndex,		&mgd.mReflectionTexOffsetTiling);
+						offsetTilings.emplace(&mgd.mLightmapTexIndex,		&mgd.mLightmapTexOffsetTiling);
+						offsetTilings.emplace(&mgd.mExtraTexIndex,			&mgd.mExtraTexOffsetTiling);
+					}
+
+					std::vector<texture_packing_candidate> candidates;
+					candidates.reserve(imageDataToPack.size());
+					for (size_t i = 0; i < imageDataToPack.size(); ++i) {
+						const auto& imgData = imageDataToPack[i];
+						const auto& bhModesAndUsages = texturesToPack[i]->second;
+						const bool clampsToEdge = std::all_of(std::begin(bhModesAndUsages), std::end(bhModesAndUsages), [](const auto& bEntry) {
+							const auto& bhModes = std::get<0>(bEntry);
+							return avk::border_handling_mode::clamp_to_edge == bhModes[0] && avk::border_handling_mode::clamp_to_edge == bhModes[1];
+						});
+						candidates.push_back(texture_packing_candidate{
+							imgData.get_format(), imgData.extent(0), imgData.levels(),
+							vk::ImageType::e2D == imgData.target() && 1u == imgData.layers() && 1u == imgData.faces(),
+							clampsToEdge
+						});
+					}
+					const auto plan = plan_texture_packing(candidates, *aTexturePacking);
+					numImageViews = plan.mUnpacked.size() + plan.mAtlases.size() + plan.mArrays.size();
+
+					for (auto i : plan.mUnpacked) {
+						addImageSamplers(texturesToPack[i]->second, context().create_image_view(create_image_from_image_data_cached(imageDataToPack[i], avk::memory_usage::device, aImageUsage, getSync(), aSerializer)));
+					}
+
+					// Every atlas has a single image sampler, since all of its textures clamp to the edge. It clamps to the edges of the atlas,
+					// not to those of the textures, i.e. coordinates beyond the padding sample neighboring textures:
+					for (const auto& atlas : plan.mAtlases) {
+						auto imgView = context().create_image_view(create_texture_atlas(atlas, imageDataToPack, aImageUsage, getSync()));
+						auto smplr = context().create_sampler(aTextureFilterMode, std::array<avk::border_handling_mode, 2>{ avk::border_handling_mode::clamp_to_edge, avk::border_handling_mode::clamp_to_edge });
+						imageSamplers.push_back(context().create_image_sampler(avk::owned(imgView), avk::owned(smplr)));
+						const auto index = static_cast<int>(imageSamplers.size() - 1);
+						for (const auto& placement : atlas.mPlacements) {
+							for (auto& [bhModes, usages] : texturesToPack[placement.mCandidate]->second) {
+								for (auto* usage : usages) {
+									*usage = index;
+									auto* offsetTiling = offsetTilings.at(usage);
+									*offsetTiling = atlas_offset_tiling(*offsetTiling, atlas, placement, candidates[placement.mCandidate].mExtent);
+								}
+							}
+						}
+					}
+
+					// Array textures have one image sampler for every border handling mode which any of their layers is used with.
+					// They are added to aArrayImageSamplers, so that imageSamplers contains only image samplers of 2D textures:
+					for (const auto& array : plan.mArrays) {
+						auto imgView = context().create_image_view(avk::owned(create_texture_array(array, imageDataToPack, aImageUsage, getSync())), {}, {}, [](avk::image_view_t& bImageView) {
+							bImageView.create_info().setViewType(vk::ImageViewType::e2DArray);
+						});
+						imgView.enable_shared_ownership();
+						std::vector<std::tuple<std::array<avk::border_handling_mode, 2>, uint32_t>> samplerIndices;
+						for (uint32_t layer = 0; layer < static_cast<uint32_t>(array.mCandidates.size()); ++layer) {
+							for (auto& [bhModes, usages] : texturesToPack[array.mCandidates[layer]]->second) {
+								auto it = std::find_if(std::begin(samplerIndices), std::end(samplerIndices), [&bhModes](const auto& bEntry) { return std::get<0>(bEntry) == bhModes; });
+								if (std::end(samplerIndices) == it) {
+									auto& arrayImageSamplers = aArrayImageSamplers->get();
+									arrayImageSamplers.push_back(context().create_image_sampler(avk::shared(imgView), avk::owned(context().create_sampler(aTextureFilterMode, bhModes))));
+									if (arrayImageSamplers.size() > 0x10000u) {
+										throw gvk::runtime_error("Too many image samplers to encode the layers of array textures in texture indices.");
+									}
+									it = samplerIndices.emplace(std::end(samplerIndices), bhModes, static_cast<uint32_t>(arrayImageSamplers.size() - 1));
+								}
+								for (auto* usage : usages) {
+									*usage = array_texture_index(std::get<1>(*it), layer);
+								}
+							}
+						}
+					}
+				}
+			}
+
+			// The textures which have not been loaded share the images of the registry:
+			for (auto& [path, imgView] : registeredImageViews) {
+				addImageSamplers(texNamesToBorderHandlingToUsages.at(path), std::move(imgView));
+			}
+			for (const auto& path : duplicateTextures) {
+				auto imgView = aTextureRegistry->get().acquire(registryKeys.at(path));
+				assert(imgView.has_value());
+				addImageSamplers(texNamesToBorderHandlingToUsages.at(path), std::move(*imgView));
 			}
 		}
 		else {
 			// We sure have the serializer here
 			for (int i = 0; i < numTexNamesToBorderHandlingToUsages; ++i) {
-				// create_image_from_file_cached does not need these values, as the
-				// image data is loaded from a cache file, so we can just pass some
-				// defaults to avoid having to save them to the cache file
+				// The image data is read from the cache file, so we can just pass some defaults to avoid having to save them to the cache file.
+				// Read it the same way as the serialize branch has written it, i.e. through create_image_from_image_data_cached, which
+				// (unlike create_image_from_file_cached) does not archive the hash of the source file in front of the image:
 				const bool potentiallySrgbDontCare = false;
 				const std::string pathDontCare = "";
+				auto imageDataDontCare = get_image_data(pathDontCare, true, potentiallySrgbDontCare, aFlipTextures, 4);
 
 				// Read an image from cache
-				auto imgView = context().create_image_view(create_image_from_file_cached(pathDontCare, true, potentiallySrgbDontCare, aFlipTextures, 4, avk::memory_usage::device, aImageUsage, getSync(), aSerializer));
+				auto imgView = context().create_image_view(create_image_from_image_data_cached(imageDataDontCare, avk::memory_usage::device, aImageUsage, getSync(), aSerializer));
+
+				uint32_t marker = 0;
+				aSerializer->get().archive(marker);
+				if (serializedImageMarker != marker) {
+					throw gvk::runtime_error(fmt::format("The image {} of {} could not be read from the cache file, since its data does not match the data which has been written. Please delete the existing cache file and let it be recreated!", i + 1, numTexNamesToBorderHandlingToUsages));
+				}
 
 				// Read the number of samplers from cache
 				int numDifferentSamplers;
@@ -1773,6 +2069,11 @@ namespace gvk
 			}
 		}
 
+		// Without any image to upload, the sync handler has not been used => submit it anyway, so that its handlers are invoked:
+		if (0 == numImageViews) {
+			aSyncHandler.submit_and_sync();
+		}
+
 		if (aSerializer) {
 			aSerializer->get().archive(result);
 		}
@@ -1791,6 +2092,8 @@ namespace gvk
 	 *	@param	aImageUsage					How this image is going to be used. Can be a combination of different avk::image_usage values
 	 *	@param	aTextureFilterMode			Texture filtering mode for all the textures. Trilinear or anisotropic filtering modes will trigger MIP-maps to be generated.
 	 *	@param	aSyncHandler				A synchronization handler.
+	 *	@param	aTextureCompression			If set, the textures are block-compressed on the CPU before they are uploaded (and stored in the cache file), with formats depending on the material slots they are used in.
+	 *	@param	aTextureResolution			If set, the resolution of the textures is limited before they are uploaded (and stored in the cache file), depending on the material slots they are used in and on a memory budget.
 	 *	@reutrn	A tuple with two elements:
 	 *			<0>: A collection of structs that contains material data converted to a GPU-suitable format. Image indices refer to the indices of the second tuple element:
 	 *			<1>: A list of image samplers that were loaded from the referenced images in aMaterialConfigs, i.e. these are already actual GPU resources.
@@ -1803,7 +2106,9 @@ namespace gvk
 		bool aFlipTextures = false,
 		avk::image_usage aImageUsage = avk::image_usage::general_texture,
 		avk::filter_mode aTextureFilterMode = avk::filter_mode::trilinear,
-		avk::sync aSyncHandler = avk::sync::wait_idle())
+		avk::sync aSyncHandler = avk::sync::wait_idle(),
+		std::optional<texture_compression_config> aTextureCompression = {},
+		std::optional<texture_resolution_policy> aTextureResolution = {})
 	{
 		return convert_for_gpu_usage_cached<T>(
 			aMaterialConfigs,
@@ -1812,7 +2117,9 @@ namespace gvk
 			aImageUsage,
 			aTextureFilterMode,
 			std::move(aSyncHandler),
-			aSerializer);
+			aSerializer,
+			aTextureCompression,
+			aTextureResolution);
 	}
 
 	/**	Takes a vector of gvk::material_config elements and converts it into a format that is usable
@@ -1826,6 +2133,9 @@ namespace gvk
 	 *	types of such replacement textures:
 	 *	- 1x1 pure white (i.e. unorm values of (1,1,1,1))
 	 *	- 1x1 "straight up normal" texture containing byte values (127, 127, 255, 0)
+	 *	They are not created by every invocation, but taken from the context's pool of constant-color
+	 *	textures (see context_vulkan::constant_color_textures), i.e. all invocations share the same
+	 *	image samplers, which are created with aImageUsage and aTextureFilterMode.
 	 *
 	 *	Either 0, 1, or 2 such automatically created textures can be created and returned.
 	 *	To find out how many such 1x1 textures actually were created, you can use the following code:
@@ -1850,6 +2160,26 @@ namespace gvk
 	 *	@param	aTextureFilterMode		Texture filter mode for all the textures that are loaded.
 	 *	@param	aBorderHandlingMode		Border handling mode for all the textures that are loaded.
 	 *	@param	aSyncHandler			How to synchronize the GPU-upload of texture memory.
+	 *	@param	aTextureCompression		If set, the textures are block-compressed on the CPU before they are uploaded. Normal maps
+	 *									and masks (height, shininess, opacity, displacement) can get different formats than
+	 *									color textures, see gvk::texture_compression_config.
+	 *	@param	aTextureResolution		If set, the resolution of the textures is limited when they are loaded, with maximum extents
+	 *									depending on the material slots they are used in, and on a memory budget for all of them,
+	 *									see gvk::texture_resolution_policy.
+	 *	@param	aTextureRegistry		If set, textures are shared with everything else that has loaded them through this registry,
+	 *									e.g. other models or scenes. Textures are identified by their contents, i.e. identical
+	 *									textures in files with different names are loaded only once. Pass global_texture_registry()
+	 *									to share textures process-wide.
+	 *	@param	aTexturePacking			If set, small textures which clamp to the edge are packed into atlases, and the offsets and
+	 *									tilings of their usages are changed to address their areas in the atlases. Texture coordinates
+	 *									outside of [0, 1] are not clamped to these areas, see texture_packing_config. If its
+	 *									mMinArrayLayers is set, textures of the same format and size are also packed into 2D array
+	 *									textures, see aArrayImageSamplers. Textures are not shared through aTextureRegistry if they
+	 *									are packed.
+	 *	@param	aArrayImageSamplers		Receives the image samplers of the array textures, which have to be bound to sampler2DArray
+	 *									descriptors. They have an index space of their own, which is encoded in the texture indices
+	 *									together with the layers, see gvk::array_texture_index. Must be set if textures are packed
+	 *									into array textures, otherwise a gvk::logic_error is thrown.
 	 *	@return	A tuple of two elements: The first element contains a vector of gvk::material_gpu_data
 	 *			entries, which are gvk::material_config entries converted into a format suitable to be
 	 *			used in UBOs or SSBOs, and the second element contains a vector of avk::image_samplers,
@@ -1864,7 +2194,12 @@ namespace gvk
 		bool aFlipTextures = false,
 		avk::image_usage aImageUsage = avk::image_usage::general_texture,
 		avk::filter_mode aTextureFilterMode = avk::filter_mode::trilinear,
-		avk::sync aSyncHandler = avk::sync::wait_idle())
+		avk::sync aSyncHandler = avk::sync::wait_idle(),
+		std::optional<texture_compression_config> aTextureCompression = {},
+		std::optional<texture_resolution_policy> aTextureResolution = {},
+		std::optional<std::reference_wrapper<texture_registry>> aTextureRegistry = {},
+		std::optional<texture_packing_config> aTexturePacking = {},
+		std::optional<std::reference_wrapper<std::vector<avk::image_sampler>>> aArrayImageSamplers = {})
 	{
 		return convert_for_gpu_usage_cached<T>(
 			aMaterialConfigs,
@@ -1872,6 +2207,33 @@ namespace gvk
 			aFlipTextures,
 			aImageUsage,
 			aTextureFilterMode,
-			std::move(aSyncHandler));
+			std::move(aSyncHandler),
+			{},
+			aTextureCompression,
+			aTextureResolution,
+			aTextureRegistry,
+			aTexturePacking,
+			aArrayImageSamplers);
 	}
+
+	/**	Like convert_for_gpu_usage, but the materials are packed into the compact encoding of gvk::compact_material_gpu_data,
+	 *	which takes about a quarter of the memory and bandwidth of gvk::material_gpu_data, see gvk::pack_materials.
+	 *	The parameters are the same as the ones of convert_for_gpu_usage. If textures are packed (see aTexturePacking), they must not
+	 *	be packed into array textures, because their texture indices do not fit into 16 bits then, i.e. mMinArrayLayers must not be set.
+	 *	Otherwise, a gvk::logic_error is thrown before any texture is loaded.
+	 *	@return	A tuple of two elements: The first element contains the packed materials and the table of their texture offsets and
+	 *			tilings, which are to be uploaded into GPU buffers. The second element contains the image samplers which are
+	 *			referenced by the packed texture indices.
+	 */
+	std::tuple<compact_material_table, std::vector<avk::image_sampler>> convert_for_gpu_usage_compact(
+		const std::vector<gvk::material_config>& aMaterialConfigs,
+		bool aLoadTexturesInSrgb = false,
+		bool aFlipTextures = false,
+		avk::image_usage aImageUsage = avk::image_usage::general_texture,
+		avk::filter_mode aTextureFilterMode = avk::filter_mode::trilinear,
+		avk::sync aSyncHandler = avk::sync::wait_idle(),
+		std::optional<texture_compression_config> aTextureCompression = {},
+		std::optional<texture_resolution_policy> aTextureResolution = {},
+		std::optional<std::reference_wrapper<texture_registry>> aTextureRegistry = {},
+		std::optional<texture_packing_config> aTexturePacking = {});
 }
@@ -0,0 +1,106 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Read-only memory mapping of a whole file.
+	 *	The mapped memory stays valid until the memory_mapped_file is destroyed; moving it does not change the address of the mapped memory.
+	 */
+	class memory_mapped_file
+	{
+	public:
+		memory_mapped_file() = default;
+
+		/** Maps the file at the given path into memory for reading.
+		 *	@param	aPath	Path to the file. Throws a gvk::runtime_error if it cannot be opened or mapped.
+		 */
+		explicit memory_mapped_file(std::string_view aPath);
+
+		memory_mapped_file(memory_mapped_file&& aOther) noexcept;
+		memory_mapped_file(const memory_mapped_file&) = delete;
+		memory_mapped_file& operator=(memory_mapped_file&& aOther) noexcept;
+		memory_mapped_file& operator=(const memory_mapped_file&) = delete;
+		~memory_mapped_file();
+
+		/** Pointer to the first byte of the mapped file, or nullptr if nothing is mapped (e.g. for empty files) */
+		const std::byte* data() const { return mData; }
+
+		/** Size of the mapped file in bytes */
+		size_t size() const { return mSize; }
+
+		/** The mapped file as a span */
+		std::span<const std::byte> span() const { return std::span<const std::byte>(mData, mSize); }
+
+	private:
+		void unmap();
+
+		const std::byte* mData = nullptr;
+		size_t mSize = 0;
+#ifdef _WIN32
+		HANDLE mFile = INVALID_HANDLE_VALUE;
+		HANDLE mMapping = nullptr;
+#endif
+	};
+
+	/** Read-only stream buffer over a contiguous piece of memory.
+	 *	Used by the serializer to let cereal read directly from a memory mapped cache file.
+	 */
+	class memory_streambuf : public std::streambuf
+	{
+	public:
+		memory_streambuf() = default;
+
+		/** @param	aData	The memory to read from, it must outlive the memory_streambuf. */
+		explicit memory_streambuf(std::span<const std::byte> aData)
+		{
+			auto* begin = const_cast<char*>(reinterpret_cast<const char*>(aData.data()));
+			setg(begin, begin, begin + aData.size());
+		}
+
+		memory_streambuf(const memory_streambuf& aOther)
+			: std::streambuf(aOther)
+		{
+			setg(aOther.eback(), aOther.gptr(), aOther.egptr());
+		}
+
+		memory_streambuf& operator=(const memory_streambuf& aOther)
+		{
+			std::streambuf::operator=(aOther);
+			setg(aOther.eback(), aOther.gptr(), aOther.egptr());
+			return *this;
+		}
+
+		/** Pointer to the current read position */
+		const std::byte* current() const { return reinterpret_cast<const std::byte*>(gptr()); }
+
+		/** Number of bytes which have not been read yet */
+		size_t remaining() const { return static_cast<size_t>(egptr() - gptr()); }
+
+		/** Advances the read position without copying.
+		 *	@param	aSize	Number of bytes to skip. Throws a gvk::runtime_error if fewer bytes remain.
+		 */
+		void skip(size_t aSize)
+		{
+			if (aSize > remaining()) {
+				throw gvk::runtime_error(fmt::format("Attempted to read {} bytes, but only {} bytes remain in the cache file.", aSize, remaining()));
+			}
+			setg(eback(), gptr() + aSize, egptr());
+		}
+
+	protected:
+		pos_type seekoff(off_type aOffset, std::ios_base::seekdir aDirection, std::ios_base::openmode aWhich) override
+		{
+			char* base = aDirection == std::ios_base::beg ? eback() : (aDirection == std::ios_base::cur ? gptr() : egptr());
+			return seekpos(static_cast<pos_type>((base - eback()) + aOffset), aWhich);
+		}
+
+		pos_type seekpos(pos_type aPosition, std::ios_base::openmode aWhich) override
+		{
+			if (!(aWhich & std::ios_base::in) || aPosition < 0 || aPosition > egptr() - eback()) {
+				return pos_type(off_type(-1));
+			}
+			setg(eback(), eback() + static_cast<off_type>(aPosition), egptr());
+			return aPosition;
+		}
+	};
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** How the local (meshlet-relative) indices of a compressed meshlet are stored. */
+	enum struct meshlet_index_encoding : uint8_t
+	{
+		/** Three uint8 local indices per triangle, tightly packed. */
+		triangle_list = 0,
+		/** Triangle strips of uint8 local indices with alternating winding, separated by sMeshletStripRestart.
+		 *  Triangles keep their order and winding, but their first vertex may be rotated. */
+		triangle_strip = 1
+	};
+
+	/** Marks the start of a new strip in meshlet_index_encoding::triangle_strip encoded index data. */
+	inline constexpr uint8_t sMeshletStripRestart = 0xFF;
+
+	/** Compressed meshlet for GPU usage in combination with the meshlet data generated by encode_meshlets_compressed.
+	 *
+	 *	Starting at word mDataOffset, the meshlet data contains:
+	 *	 - mVertexCount vertex offsets of mVertexOffsetBits bits each (8, 16, or 32), relative to mBaseVertex,
+	 *	   little-endian and padded to the next uint32 boundary.
+	 *	 - mIndexByteCount bytes of local indices, encoded as specified by mIndexEncoding,
+	 *	   padded to the next uint32 boundary.
+	 *	The actual vertex index of the i-th meshlet vertex is mBaseVertex + offset[i].
+	 */
+	struct meshlet_compressed_gpu_data
+	{
+		/** Data offset into the meshlet data array, in uint32 words */
+		uint32_t mDataOffset;
+		/** The smallest vertex index referenced by this meshlet */
+		uint32_t mBaseVertex;
+		/** The vertex count */
+		uint8_t mVertexCount;
+		/** The primitive count */
+		uint8_t mPrimitiveCount;
+		/** Bit width of each vertex offset: 8, 16, or 32 */
+		uint8_t mVertexOffsetBits;
+		/** The meshlet_index_encoding of the local indices */
+		uint8_t mIndexEncoding;
+		/** Number of bytes used by the encoded local indices */
+		uint16_t mIndexByteCount;
+		/** Unused, keeps the struct at 16 bytes */
+		uint16_t mPadding;
+	};
+
+	/** Sizes and timings gathered by report_meshlet_compression. */
+	struct meshlet_compression_report
+	{
+		/** Number of meshlets that have been encoded */
+		size_t mNumMeshlets = 0;
+		/** Number of triangles that have been encoded */
+		size_t mNumTriangles = 0;
+		/** Size in bytes of the meshlets as meshlet_gpu_data */
+		size_t mFixedLayoutBytes = 0;
+		/** Size in bytes of the meshlets as meshlet_redirected_gpu_data plus their meshlet data */
+		size_t mRedirectedLayoutBytes = 0;
+		/** Size in bytes of the meshlets as meshlet_compressed_gpu_data plus their meshlet data */
+		size_t mCompressedBytes = 0;
+		/** Time spent in encode_meshlets_compressed, in seconds */
+		double mEncodeSeconds = 0.0;
+		/** Time spent decoding all meshlets with decode_meshlet_compressed, in seconds */
+		double mDecodeSeconds = 0.0;
+		/** True if every decoded meshlet references the same triangles as its source meshlet */
+		bool mRoundTripValid = false;
+
+		double encode_triangles_per_second() const { return mEncodeSeconds > 0.0 ? static_cast<double>(mNumTriangles) / mEncodeSeconds : 0.0; }
+		double decode_triangles_per_second() const { return mDecodeSeconds > 0.0 ? static_cast<double>(mNumTriangles) / mDecodeSeconds : 0.0; }
+		double ratio_to_fixed_layout() const { return mFixedLayoutBytes > 0 ? static_cast<double>(mCompressedBytes) / static_cast<double>(mFixedLayoutBytes) : 0.0; }
+		double ratio_to_redirected_layout() const { return mRedirectedLayoutBytes > 0 ? static_cast<double>(mCompressedBytes) / static_cast<double>(mRedirectedLayoutBytes) : 0.0; }
+	};
+
+	/** Serialization/deserialization method for meshlet_compressed_gpu_data.
+	 *	@param	aArchive	The archive.
+	 *	@param	aValue		The value to serialize or to deserialize into.
+	 *	@tparam Archive		The archive type.
+	 */
+	template<typename Archive>
+	void serialize(Archive& aArchive, meshlet_compressed_gpu_data& aValue)
+	{
+		aArchive(aValue.mDataOffset, aValue.mBaseVertex, aValue.mVertexCount, aValue.mPrimitiveCount, aValue.mVertexOffsetBits, aValue.mIndexEncoding, aValue.mIndexByteCount);
+	}
+
+	/** Converts meshlets into the compressed GPU representation.
+	 *	Each meshlet stores a base vertex plus the narrowest vertex offsets that fit, and a variable amount of
+	 *	local index data, so that small meshlets do not pay for the maximum vertex and index counts.
+	 *	@param	aMeshlets		The meshlets to convert. Each meshlet may reference at most 254 vertices and 255 triangles.
+	 *	@param	aIndexEncoding	How to encode the local indices.
+	 *	@returns				A tuple of the compressed meshlets and the meshlet data they refer to.
+	 */
+	std::tuple<std::vector<meshlet_compressed_gpu_data>, std::vector<uint32_t>> encode_meshlets_compressed(const std::vector<meshlet>& aMeshlets, meshlet_index_encoding aIndexEncoding = meshlet_index_encoding::triangle_list);
+
+	/** Converts meshlets into the compressed GPU representation, with caching.
+	 *  @param  aSerializer		The serializer for the meshlet gpu data.
+	 *	@param	aMeshlets		The meshlets to convert. Only evaluated in serializer::mode::serialize.
+	 *	@param	aIndexEncoding	How to encode the local indices.
+	 *	@returns				A tuple of the compressed meshlets and the meshlet data they refer to.
+	 */
+	std::tuple<std::vector<meshlet_compressed_gpu_data>, std::vector<uint32_t>> encode_meshlets_compressed_cached(serializer& aSerializer, const std::vector<meshlet>& aMeshlets, meshlet_index_encoding aIndexEncoding = meshlet_index_encoding::triangle_list);
+
+	/** Reference CPU decoder for a compressed meshlet, mainly intended for validation.
+	 *	@param	aMeshlet		The compressed meshlet.
+	 *	@param	aMeshletData	The meshlet data returned alongside aMeshlet by encode_meshlets_compressed.
+	 *	@returns				A meshlet with mVertices, mIndices (as triangle list), mVertexCount, and mIndexCount set.
+	 *							mModel and mMeshIndex are not stored in the compressed format and are left empty.
+	 */
+	meshlet decode_meshlet_compressed(const meshlet_compressed_gpu_data& aMeshlet, const std::vector<uint32_t>& aMeshletData);
+
+	/** Encodes the given meshlets, decodes them again with the reference decoder, and reports sizes and throughput.
+	 *	@param	aMeshlets					The meshlets to evaluate.
+	 *	@param	aIndexEncoding				How to encode the local indices.
+	 *	@param	aFixedLayoutBytesPerMeshlet	Size of one meshlet in the fixed layout, i.e. sizeof(meshlet_gpu_data<NV, NI>).
+	 */
+	meshlet_compression_report report_meshlet_compression(const std::vector<meshlet>& aMeshlets, meshlet_index_encoding aIndexEncoding, size_t aFixedLayoutBytesPerMeshlet);
+
+	/** Encodes the given meshlets, decodes them again with the reference decoder, and reports sizes and throughput.
+	 *	@param	aMeshlets		The meshlets to evaluate.
+	 *	@param	aIndexEncoding	How to encode the local indices.
+	 *  @tparam NV				The number of vertices of the fixed layout to compare against
+	 *  @tparam NI				The number of indices of the fixed layout to compare against
+	 */
+	template <size_t NV = 64, size_t NI = 378>
+	meshlet_compression_report report_meshlet_compression(const std::vector<meshlet>& aMeshlets, meshlet_index_encoding aIndexEncoding = meshlet_index_encoding::triangle_list)
+	{
+		return report_meshlet_compression(aMeshlets, aIndexEncoding, sizeof(meshlet_gpu_data<NV, NI>));
+	}
+}
@@ -95,6 +95,34 @@ namespace gvk
 		std::optional<mesh_index_t> aMeshIndex,
 		uint32_t aMaxVertices, uint32_t aMaxIndices);
 
+	/** Whether a meshlet division callback only receives the indices, i.e. not the vertices, see divide_indexed_geometry_into_meshlets */
+	template <typename F>
+	inline constexpr bool is_indices_only_meshlet_division = std::is_assignable_v<std::function<std::vector<meshlet>(const std::vector<uint32_t>& tIndices, const model_t& tModel, std::optional<mesh_index_t> tMeshIndex, uint32_t tMaxVertices, uint32_t tMaxIndices)>, F>;
+
+	/** Whether a meshlet division callback receives the vertices and the indices, see divide_indexed_geometry_into_meshlets */
+	template <typename F>
+	inline constexpr bool is_vertices_and_indices_meshlet_division = std::is_assignable_v<std::function<std::vector<meshlet>(const std::vector<glm::vec3>& tVertices, const std::vector<uint32_t>& tIndices, const model_t& tModel, std::optional<mesh_index_t> tMeshIndex, uint32_t tMaxVertices, uint32_t tMaxIndices)>, F>;
+
+	/** Invokes a meshlet division callback with the parameters it takes, see divide_indexed_geometry_into_meshlets for the schemas of such callbacks.
+	 *	The vertices are not passed to callbacks which only receive the indices, i.e. they can be empty for them.
+	 */
+	template <typename F>
+	std::vector<meshlet> invoke_meshlet_division(F& aMeshletDivision,
+		const std::vector<glm::vec3>& aVertices,
+		const std::vector<uint32_t>& aIndices,
+		const model_t& aModel,
+		const std::optional<mesh_index_t> aMeshIndex,
+		const uint32_t aMaxVertices, const uint32_t aMaxIndices)
+	{
+		static_assert(is_indices_only_meshlet_division<F> || is_vertices_and_indices_meshlet_division<F>, "No compatible lambda has been passed as meshlet division callback.");
+		if constexpr (is_indices_only_meshlet_division<F>) {
+			return aMeshletDivision(aIndices, aModel, aMeshIndex, aMaxVertices, aMaxIndices);
+		}
+		else {
+			return aMeshletDivision(aVertices, aIndices, aModel, aMeshIndex, aMaxVertices, aMaxIndices);
+		}
+	}
+
 	/** Divides the given vertex and index buffer into meshlets using the given callback function.
 	 *  @param	aVertices			The vertex buffer.
 	 *  @param	aIndices			The index buffer.
@@ -139,20 +167,7 @@ namespace gvk
 		auto ownedModel = aModel.own();
 		ownedModel.enable_shared_ownership();
 
-		if constexpr (std::is_assignable_v<std::function<std::vector<meshlet>(const std::vector<uint32_t>& tIndices, const model_t& tModel, std::optional<mesh_index_t> tMeshIndex, uint32_t tMaxVertices, uint32_t tMaxIndices)>, decltype(aMeshletDivision)>) {
-			generatedMeshlets = aMeshletDivision(aIndices, ownedModel.get(), aMeshIndex, aMaxVertices, aMaxIndices);
-		}
-		else if constexpr (std::is_assignable_v<std::function<std::vector<meshlet>(const std::vector<glm::vec3>& tVertices, const std::vector<uint32_t>& tIndices, const model_t& tModel, std::optional<mesh_index_t> tMeshIndex, uint32_t tMaxVertices, uint32_t tMaxIndices)>, decltype(aMeshletDivision)>) {
-			generatedMeshlets = aMeshletDivision(aVertices, aIndices, ownedModel.get(), aMeshIndex, aMaxVertices, aMaxIndices);
-		}
-		else {
-#if defined(_MSC_VER) && defined(__cplusplus)
-			static_assert(false);
-#else
-			assert(false);
-#endif
-			throw avk::logic_error("No compatible lambda has been passed to divide_into_meshlets.");
-		}
+		generatedMeshlets = invoke_meshlet_division(aMeshletDivision, aVertices, aIndices, ownedModel.get(), aMeshIndex, aMaxVertices, aMaxIndices);
 
 		for (auto& meshlet : generatedMeshlets)
 		{
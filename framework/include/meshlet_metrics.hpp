@@ -0,0 +1,135 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Summary of a per-meshlet value over all meshlets of a division. */
+	struct meshlet_value_distribution
+	{
+		float mMin = 0.0f;
+		float mMax = 0.0f;
+		float mMean = 0.0f;
+		float mMedian = 0.0f;
+		float mPercentile90 = 0.0f;
+	};
+
+	/** Quality metrics of a meshlet division, as computed by compute_meshlet_metrics or measure_meshlet_division. */
+	struct meshlet_metrics
+	{
+		/** Number of meshlets */
+		size_t mNumMeshlets = 0;
+		/** Number of triangles over all meshlets */
+		size_t mNumTriangles = 0;
+		/** Number of distinct vertices referenced by all meshlets */
+		size_t mNumUniqueVertices = 0;
+		/** Sum of the vertex counts of all meshlets */
+		size_t mNumMeshletVertices = 0;
+		/** The maximum number of vertices a meshlet was allowed to have */
+		uint32_t mMaxVertices = 0;
+		/** The maximum number of indices a meshlet was allowed to have */
+		uint32_t mMaxIndices = 0;
+		/** Average of mVertexCount / mMaxVertices over all meshlets */
+		double mVertexFill = 0.0;
+		/** Average of triangle count / (mMaxIndices / 3) over all meshlets */
+		double mTriangleFill = 0.0;
+		/** mNumMeshletVertices / mNumUniqueVertices, i.e. how often a vertex is processed on average */
+		double mVertexDuplicationFactor = 0.0;
+		/** Radii of the meshlets' bounding spheres (Ritter's algorithm) */
+		meshlet_value_distribution mBoundingSphereRadius;
+		/** Half angles, in radians, of the cones which contain all face normals of a meshlet */
+		meshlet_value_distribution mNormalConeAngle;
+		/** Fraction of meshlets whose normal cone half angle is below 90 degrees, i.e. which can be backface culled as a whole */
+		double mCullableFraction = 0.0;
+		/** Time spent in the meshlet division callback, in seconds. Zero if the division has not been timed. */
+		double mBuildSeconds = 0.0;
+
+		double triangles_per_second() const { return mBuildSeconds > 0.0 ? static_cast<double>(mNumTriangles) / mBuildSeconds : 0.0; }
+	};
+
+	/** Computes quality metrics of the given meshlets.
+	 *	@param	aVertices		The vertex positions which the meshlets' mVertices refer to.
+	 *	@param	aMeshlets		The meshlets to evaluate.
+	 *	@param	aMaxVertices	The maximum number of vertices of a meshlet, used to compute the fill ratios.
+	 *	@param	aMaxIndices		The maximum number of indices of a meshlet, used to compute the fill ratios.
+	 *	@returns				The metrics with mBuildSeconds set to zero.
+	 */
+	meshlet_metrics compute_meshlet_metrics(const std::vector<glm::vec3>& aVertices, const std::vector<meshlet>& aMeshlets, uint32_t aMaxVertices, uint32_t aMaxIndices);
+
+	/** Creates a human readable, multi-line summary of the given metrics.
+	 *	@param	aMetrics		The metrics to summarize.
+	 */
+	std::string to_string(const meshlet_metrics& aMetrics);
+
+	/** Runs the given meshlet division callback on the given geometry, times it and computes quality metrics of its result.
+	 *  @param	aVertices			The vertex buffer.
+	 *  @param	aIndices			The index buffer.
+	 *  @param	aModel				The model these buffers belong to.
+	 *	@param	aMeshIndex			The optional mesh index of the mesh these buffers belong to.
+	 *  @param	aMeshletDivision	Callback used to divide meshes into meshlets, following the same schema as for divide_into_meshlets.
+	 *	@param	aMaxVertices		The maximum number of vertices of a meshlet.
+	 *	@param	aMaxIndices			The maximum number of indices of a meshlet.
+	 */
+	template <typename F>
+	meshlet_metrics measure_meshlet_division(
+		const std::vector<glm::vec3>& aVertices,
+		const std::vector<uint32_t>& aIndices,
+		const model_t& aModel,
+		const std::optional<mesh_index_t> aMeshIndex,
+		F aMeshletDivision,
+		const uint32_t aMaxVertices = 64, const uint32_t aMaxIndices = 378)
+	{
+		std::vector<meshlet> generatedMeshlets;
+		const auto start = std::chrono::steady_clock::now();
+		generatedMeshlets = invoke_meshlet_division(aMeshletDivision, aVertices, aIndices, aModel, aMeshIndex, aMaxVertices, aMaxIndices);
+		const auto end = std::chrono::steady_clock::now();
+
+		auto metrics = compute_meshlet_metrics(aVertices, generatedMeshlets, aMaxVertices, aMaxIndices);
+		metrics.mBuildSeconds = std::chrono::duration<double>(end - start).count();
+		return metrics;
+	}
+
+	/** Runs the given meshlet division callback on the selected meshes of a model, like divide_into_meshlets would,
+	 *	times it and computes quality metrics of the combined result.
+	 *  @param	aModel				The model to divide into meshlets.
+	 *  @param	aMeshIndices		The meshes of the model to divide into meshlets.
+	 *  @param	aMeshletDivision	Callback used to divide meshes into meshlets, following the same schema as for divide_into_meshlets.
+	 *	@param	aCombineSubmeshes	If submeshes should be combined into a single vertex/index buffer.
+	 *	@param	aMaxVertices		The maximum number of vertices of a meshlet.
+	 *	@param	aMaxIndices			The maximum number of indices of a meshlet.
+	 */
+	template <typename F>
+	meshlet_metrics measure_meshlet_division(const model_t& aModel, const std::vector<mesh_index_t>& aMeshIndices, F aMeshletDivision,
+		const bool aCombineSubmeshes = true, const uint32_t aMaxVertices = 64, const uint32_t aMaxIndices = 378)
+	{
+		if (aCombineSubmeshes) {
+			auto [vertices, indices] = get_vertices_and_indices(std::vector({ std::make_tuple(avk::const_referenced(aModel), aMeshIndices) }));
+			return measure_meshlet_division(vertices, indices, aModel, std::nullopt, std::move(aMeshletDivision), aMaxVertices, aMaxIndices);
+		}
+
+		// Measure every mesh on its own and accumulate the results:
+		std::vector<glm::vec3> allVertices;
+		std::vector<meshlet> allMeshlets;
+		double buildSeconds = 0.0;
+		for (const auto meshIndex : aMeshIndices) {
+			auto vertices = aModel.positions_for_mesh(meshIndex);
+			auto indices = aModel.indices_for_mesh<uint32_t>(meshIndex);
+			const auto start = std::chrono::steady_clock::now();
+			auto meshlets = invoke_meshlet_division(aMeshletDivision, vertices, indices, aModel, meshIndex, aMaxVertices, aMaxIndices);
+			buildSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			// Offset the vertex references so that they refer into allVertices:
+			const auto vertexOffset = static_cast<uint32_t>(allVertices.size());
+			for (auto& ml : meshlets) {
+				for (auto& v : ml.mVertices) {
+					v += vertexOffset;
+				}
+			}
+			allVertices.insert(std::end(allVertices), std::begin(vertices), std::end(vertices));
+			allMeshlets.insert(std::end(allMeshlets), std::make_move_iterator(std::begin(meshlets)), std::make_move_iterator(std::end(meshlets)));
+		}
+
+		auto metrics = compute_meshlet_metrics(allVertices, allMeshlets, aMaxVertices, aMaxIndices);
+		metrics.mBuildSeconds = buildSeconds;
+		return metrics;
+	}
+}
@@ -0,0 +1,243 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** A meshlet stored inside of a meshlet_arena, referring to its vertices and indices by offsets. */
+	struct meshlet_arena_entry
+	{
+		/** Offset into meshlet_arena::mVertices */
+		uint32_t mVerticesOffset;
+		/** Offset into meshlet_arena::mIndices */
+		uint32_t mIndicesOffset;
+		/** The number of vertices starting at mVerticesOffset */
+		uint32_t mVertexCount;
+		/** The number of indices starting at mIndicesOffset */
+		uint32_t mIndexCount;
+		/** The optional mesh index of the meshlet, see meshlet::mMeshIndex */
+		std::optional<mesh_index_t> mMeshIndex;
+	};
+
+	/** Flat storage for many meshlets. Instead of every meshlet owning two vectors and a model handle,
+	 *	all vertex indices and all local indices are stored contiguously and meshlets refer to them by offsets.
+	 */
+	struct meshlet_arena
+	{
+		std::vector<meshlet_arena_entry> mMeshlets;
+		/** Vertex indices of all meshlets, see meshlet::mVertices */
+		std::vector<uint32_t> mVertices;
+		/** Local indices of all meshlets, see meshlet::mIndices */
+		std::vector<uint8_t> mIndices;
+
+		size_t size() const { return mMeshlets.size(); }
+		bool empty() const { return mMeshlets.empty(); }
+
+		/** Appends a meshlet, only its first mVertexCount vertices and mIndexCount indices are stored. */
+		void append(const meshlet& aMeshlet);
+
+		/** Appends all the given meshlets. */
+		void append(const std::vector<meshlet>& aMeshlets);
+
+		/** The vertex indices of the meshlet at the given index */
+		std::span<const uint32_t> vertices_of(size_t aMeshletIndex) const
+		{
+			const auto& e = mMeshlets[aMeshletIndex];
+			return std::span<const uint32_t>(mVertices.data() + e.mVerticesOffset, e.mVertexCount);
+		}
+
+		/** The local indices of the meshlet at the given index */
+		std::span<const uint8_t> indices_of(size_t aMeshletIndex) const
+		{
+			const auto& e = mMeshlets[aMeshletIndex];
+			return std::span<const uint8_t>(mIndices.data() + e.mIndicesOffset, e.mIndexCount);
+		}
+
+		/** Creates a stand-alone meshlet from the meshlet at the given index. Its mModel is left empty. */
+		meshlet to_meshlet(size_t aMeshletIndex) const;
+	};
+
+	/** Serialization/deserialization method for meshlet_arena_entry.
+	 *	@param	aArchive	The archive.
+	 *	@param	aValue		The value to serialize or to deserialize into.
+	 *	@tparam Archive		The archive type.
+	 */
+	template<typename Archive>
+	void serialize(Archive& aArchive, meshlet_arena_entry& aValue)
+	{
+		aArchive(aValue.mVerticesOffset, aValue.mIndicesOffset, aValue.mVertexCount, aValue.mIndexCount, aValue.mMeshIndex);
+	}
+
+	/** Serialization/deserialization method for meshlet_arena.
+	 *	@param	aArchive	The archive.
+	 *	@param	aValue		The value to serialize or to deserialize into.
+	 *	@tparam Archive		The archive type.
+	 */
+	template<typename Archive>
+	void serialize(Archive& aArchive, meshlet_arena& aValue)
+	{
+		aArchive(aValue.mMeshlets, aValue.mVertices, aValue.mIndices);
+	}
+
+	/** Divides the given meshes of a model into meshlets chunk by chunk, handing every chunk over to a consumer as soon as it has been generated.
+	 *	In contrast to divide_into_meshlets, the combined vertex and index buffers are never materialized. Only the index buffer of the
+	 *	current mesh, the meshlets of the current chunk, and, if the division callback requires them, the positions of the current mesh are held in memory.
+	 *  @param	aModel					The model to divide into meshlets. Ownership is not taken and the generated meshlets' mModel is left empty.
+	 *  @param	aMeshIndices			The meshes of the model to divide into meshlets.
+	 *  @param	aMeshletDivision		Callback used to divide meshes into meshlets, following the same schema as for divide_into_meshlets.
+	 *									It is invoked with the indices of one chunk and, optionally, the positions of the chunk's mesh. Both are
+	 *									local to that mesh, therefore its mesh index is always passed, also if aCombineSubmeshes is true.
+	 *  @param	aChunkConsumer			Callback receiving the meshlets of one chunk as std::vector<meshlet>&. If aCombineSubmeshes is true, their
+	 *									vertex indices have already been offset to refer to the combined vertex buffer as created by get_vertices_and_indices,
+	 *									and their mMeshIndex has been reset, like for meshlets created by divide_into_meshlets.
+	 *	@param	aCombineSubmeshes		If the vertex indices should refer to a combined vertex buffer. Meshlets never span multiple meshes, though.
+	 *	@param	aMaxVertices			The maximum number of vertices of a meshlet. This value is just passed on to aMeshletDivision.
+	 *	@param	aMaxIndices				The maximum number of indices of a meshlet. This value is just passed on to aMeshletDivision.
+	 *	@param	aMaxTrianglesPerChunk	The maximum number of triangles which are passed to aMeshletDivision at once.
+	 */
+	template <typename F, typename C>
+	void divide_into_meshlets_streamed(const model_t& aModel, const std::vector<mesh_index_t>& aMeshIndices, F aMeshletDivision, C aChunkConsumer,
+		const bool aCombineSubmeshes = true, const uint32_t aMaxVertices = 64, const uint32_t aMaxIndices = 378, const size_t aMaxTrianglesPerChunk = 65536)
+	{
+		static_assert(is_indices_only_meshlet_division<F> || is_vertices_and_indices_meshlet_division<F>, "No compatible lambda has been passed to divide_into_meshlets_streamed.");
+
+		const size_t chunkIndices = std::max<size_t>(aMaxTrianglesPerChunk, 1) * 3;
+		size_t vertexOffset = 0;
+		std::vector<uint32_t> indicesOfChunk;
+		for (const auto meshIndex : aMeshIndices) {
+			const auto indices = aModel.indices_for_mesh<uint32_t>(meshIndex);
+			std::vector<glm::vec3> positions;
+			if constexpr (!is_indices_only_meshlet_division<F>) {
+				positions = aModel.positions_for_mesh(meshIndex);
+			}
+
+			for (size_t first = 0; first < indices.size(); first += chunkIndices) {
+				const auto last = std::min(indices.size(), first + chunkIndices);
+				indicesOfChunk.assign(std::begin(indices) + first, std::begin(indices) + last);
+
+				auto meshlets = invoke_meshlet_division(aMeshletDivision, positions, indicesOfChunk, aModel, meshIndex, aMaxVertices, aMaxIndices);
+
+				// Only now the vertex indices refer to the combined vertex buffer, which is what an empty mesh index denotes:
+				if (aCombineSubmeshes) {
+					for (auto& ml : meshlets) {
+						for (auto& v : ml.mVertices) {
+							v += static_cast<uint32_t>(vertexOffset);
+						}
+						ml.mMeshIndex.reset();
+					}
+				}
+				aChunkConsumer(meshlets);
+			}
+
+			vertexOffset += aModel.number_of_vertices_for_mesh(meshIndex);
+		}
+	}
+
+	/** Divides the given meshes of a model into meshlets, streaming them chunk by chunk into a meshlet_arena.
+	 *	For the parameters, see divide_into_meshlets_streamed.
+	 */
+	template <typename F>
+	meshlet_arena divide_into_meshlet_arena(const model_t& aModel, const std::vector<mesh_index_t>& aMeshIndices, F aMeshletDivision,
+		const bool aCombineSubmeshes = true, const uint32_t aMaxVertices = 64, const uint32_t aMaxIndices = 378, const size_t aMaxTrianglesPerChunk = 65536)
+	{
+		meshlet_arena arena;
+		divide_into_meshlets_streamed(aModel, aMeshIndices, std::move(aMeshletDivision), [&arena](const std::vector<meshlet>& tMeshlets) {
+			arena.append(tMeshlets);
+		}, aCombineSubmeshes, aMaxVertices, aMaxIndices, aMaxTrianglesPerChunk);
+		return arena;
+	}
+
+	/** Converts meshlets into a GPU usable representation and appends them to already converted meshlets.
+	 *	The data offsets of the redirected representation are adjusted so that they refer into the combined meshlet data.
+	 *	@param	aMeshlets		The meshlets to convert
+	 *	@param	aGpuMeshlets	The converted meshlets to append to
+	 *	@param	aMeshletData	The meshlet data to append to, only used with the redirected representation
+	 *	@tparam	T				Either meshlet_gpu_data or meshlet_redirected_gpu_data, see convert_for_gpu_usage.
+	 *  @tparam NV				The number of vertices
+	 *  @tparam NI				The number of indices
+	 */
+	template <typename T, size_t NV, size_t NI>
+	void append_for_gpu_usage(const std::vector<meshlet>& aMeshlets, std::vector<T>& aGpuMeshlets, std::optional<std::vector<uint32_t>>& aMeshletData)
+	{
+		auto [gpuMeshlets, meshletData] = convert_for_gpu_usage<T, NV, NI>(aMeshlets);
+		if constexpr (std::is_convertible_v<T, meshlet_redirected_gpu_data>) {
+			if (!aMeshletData.has_value()) {
+				aMeshletData = std::vector<uint32_t>();
+			}
+			const auto dataOffset = static_cast<uint32_t>(aMeshletData->size());
+			for (auto& ml : gpuMeshlets) {
+				static_cast<meshlet_redirected_gpu_data&>(ml).mDataOffset += dataOffset;
+			}
+			aMeshletData->insert(std::end(aMeshletData.value()), std::begin(meshletData.value()), std::end(meshletData.value()));
+		}
+		aGpuMeshlets.insert(std::end(aGpuMeshlets), std::begin(gpuMeshlets), std::end(gpuMeshlets));
+	}
+
+	/** Divides the given meshes of a model into meshlets and converts them into a GPU usable representation, chunk by chunk, with caching.
+	 *	In serializer::mode::serialize, every chunk is converted and written to the serializer right after it has been generated,
+	 *	so that no intermediate std::vector<meshlet> of the whole model is ever created.
+	 *	In serializer::mode::deserialize, the model is not touched at all.
+	 *  @param  aSerializer		The serializer for the meshlet gpu data.
+	 *	For all other parameters, see divide_into_meshlets_streamed.
+	 *	@tparam	T				Either meshlet_gpu_data or meshlet_redirected_gpu_data, see convert_for_gpu_usage.
+	 *  @tparam NV				The number of vertices
+	 *  @tparam NI				The number of indices
+	 *  @returns				A Tuple of the converted meshlets and the optional meshlet data when the redirected representation is used.
+	 */
+	template <typename T, size_t NV, size_t NI, typename F>
+	std::tuple<std::vector<T>, std::optional<std::vector<uint32_t>>> divide_into_meshlets_for_gpu_usage_streamed_cached(serializer& aSerializer,
+		const model_t& aModel, const std::vector<mesh_index_t>& aMeshIndices, F aMeshletDivision,
+		const bool aCombineSubmeshes = true, const size_t aMaxTrianglesPerChunk = 65536)
+	{
+		std::tuple<std::vector<T>, std::optional<std::vector<uint32_t>>> result;
+		auto& resultMeshlets = std::get<std::vector<T>>(result);
+		auto& resultMeshletsData = std::get<std::optional<std::vector<uint32_t>>>(result);
+
+		// Every chunk is preceded by a flag which tells whether another chunk follows:
+		if (aSerializer.mode() == serializer::mode::serialize) {
+			divide_into_meshlets_streamed(aModel, aMeshIndices, std::move(aMeshletDivision), [&](const std::vector<meshlet>& tMeshlets) {
+				std::vector<T> chunkMeshlets;
+				std::optional<std::vector<uint32_t>> chunkData;
+				append_for_gpu_usage<T, NV, NI>(tMeshlets, chunkMeshlets, chunkData);
+				// Offset the chunk into the overall meshlet data before writing it, so that reading does not need to adjust anything:
+				if constexpr (std::is_convertible_v<T, meshlet_redirected_gpu_data>) {
+					const auto dataOffset = static_cast<uint32_t>(resultMeshletsData.has_value() ? resultMeshletsData->size() : 0);
+					for (auto& ml : chunkMeshlets) {
+						static_cast<meshlet_redirected_gpu_data&>(ml).mDataOffset += dataOffset;
+					}
+				}
+				bool hasChunk = true;
+				aSerializer.archive(hasChunk);
+				aSerializer.archive(chunkMeshlets);
+				aSerializer.archive(chunkData);
+				resultMeshlets.insert(std::end(resultMeshlets), std::begin(chunkMeshlets), std::end(chunkMeshlets));
+				if (chunkData.has_value()) {
+					if (!resultMeshletsData.has_value()) {
+						resultMeshletsData = std::vector<uint32_t>();
+					}
+					resultMeshletsData->insert(std::end(resultMeshletsData.value()), std::begin(chunkData.value()), std::end(chunkData.value()));
+				}
+			}, aCombineSubmeshes, static_cast<uint32_t>(NV), static_cast<uint32_t>(NI), aMaxTrianglesPerChunk);
+			bool hasChunk = false;
+			aSerializer.archive(hasChunk);
+		}
+		else {
+			bool hasChunk = false;
+			aSerializer.archive(hasChunk);
+			while (hasChunk) {
+				std::vector<T> chunkMeshlets;
+				std::optional<std::vector<uint32_t>> chunkData;
+				aSerializer.archive(chunkMeshlets);
+				aSerializer.archive(chunkData);
+				resultMeshlets.insert(std::end(resultMeshlets), std::begin(chunkMeshlets), std::end(chunkMeshlets));
+				if (chunkData.has_value()) {
+					if (!resultMeshletsData.has_value()) {
+						resultMeshletsData = std::vector<uint32_t>();
+					}
+					resultMeshletsData->insert(std::end(resultMeshletsData.value()), std::begin(chunkData.value()), std::end(chunkData.value()));
+				}
+				aSerializer.archive(hasChunk);
+			}
+		}
+		return result;
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Mapping between an original vertex order and a reordered, compacted vertex order, as computed by reorder_vertices_for_meshlets. */
+	struct vertex_remap
+	{
+		/** Marks vertices in mOldToNew which are not referenced by any meshlet and have been dropped. */
+		static constexpr uint32_t sNotReferenced = std::numeric_limits<uint32_t>::max();
+
+		/** For every original vertex, its new index or sNotReferenced */
+		std::vector<uint32_t> mOldToNew;
+		/** For every new vertex, its original index */
+		std::vector<uint32_t> mNewToOld;
+
+		/** The number of vertices after reordering */
+		size_t size() const { return mNewToOld.size(); }
+
+		/** Reorders and compacts a vertex attribute stream.
+		 *	@param	aAttribute	The attribute stream in the original vertex order, e.g. normals, texture coordinates, or bone data.
+		 *	@returns			The attribute stream in the new vertex order.
+		 */
+		template <typename T>
+		std::vector<T> apply(const std::vector<T>& aAttribute) const
+		{
+			if (aAttribute.size() != mOldToNew.size()) {
+				throw gvk::runtime_error(fmt::format("The attribute stream has {} elements, but the vertex remap has been created for {} vertices.", aAttribute.size(), mOldToNew.size()));
+			}
+			std::vector<T> result;
+			result.reserve(mNewToOld.size());
+			for (auto oldIndex : mNewToOld) {
+				result.push_back(aAttribute[oldIndex]);
+			}
+			return result;
+		}
+
+		/** Rewrites an index buffer which refers to the original vertex order, e.g. the one returned by get_vertices_and_indices.
+		 *	@param	aIndices	The indices to rewrite in place. They must only refer to vertices which are referenced by the meshlets.
+		 */
+		void apply_to_indices(std::vector<uint32_t>& aIndices) const;
+	};
+
+	/** Serialization/deserialization method for vertex_remap.
+	 *	@param	aArchive	The archive.
+	 *	@param	aValue		The value to serialize or to deserialize into.
+	 *	@tparam Archive		The archive type.
+	 */
+	template<typename Archive>
+	void serialize(Archive& aArchive, vertex_remap& aValue)
+	{
+		aArchive(aValue.mOldToNew, aValue.mNewToOld);
+	}
+
+	/** Computes a vertex order in which vertices are stored in order of their first use by the meshlets, drops unreferenced vertices,
+	 *	and rewrites the meshlets' mVertices accordingly. Afterwards, the vertices of a meshlet are mostly contiguous in memory.
+	 *	Use vertex_remap::apply to bring all vertex attribute streams into the new order.
+	 *	All meshlets must refer to the same vertex buffer, i.e. they must have been created with submeshes combined,
+	 *	or all belong to the same mesh.
+	 *	@param	aMeshlets		The meshlets, whose mVertices are rewritten in place.
+	 *	@param	aNumVertices	The number of vertices in the original vertex buffer.
+	 *	@returns				The mapping between the original and the new vertex order.
+	 */
+	vertex_remap reorder_vertices_for_meshlets(std::vector<meshlet>& aMeshlets, size_t aNumVertices);
+
+	/** Computes a vertex order in which vertices are stored in order of their first use by the meshlets, drops unreferenced vertices,
+	 *	and rewrites the meshlets' vertex references accordingly.
+	 *	@param	aMeshlets		The meshlets, whose vertex references are rewritten in place.
+	 *	@param	aNumVertices	The number of vertices in the original vertex buffer.
+	 *	@returns				The mapping between the original and the new vertex order.
+	 */
+	vertex_remap reorder_vertices_for_meshlets(meshlet_arena& aMeshlets, size_t aNumVertices);
+
+	/** Reorders the meshlets' vertices in order of first use and applies the new order to all the given vertex attribute streams.
+	 *	@param	aMeshlets		The meshlets, whose mVertices are rewritten in place.
+	 *	@param	aPositions		The vertex positions, which are reordered in place. Their size determines the number of vertices.
+	 *	@param	aAttributes		Further vertex attribute streams of the same size, e.g. normals, texture coordinates, bone indices, and bone weights,
+	 *							which are reordered in place.
+	 *	@returns				The mapping between the original and the new vertex order.
+	 *
+	 *	Example:
+	 *	@code
+	 *	auto remap = gvk::reorder_vertex_streams_for_meshlets(meshlets, positions, normals, texCoords, boneIndices, boneWeights);
+	 *	remap.apply_to_indices(indices);
+	 *	@endcode
+	 */
+	template <typename... Attributes>
+	vertex_remap reorder_vertex_streams_for_meshlets(std::vector<meshlet>& aMeshlets, std::vector<glm::vec3>& aPositions, std::vector<Attributes>&... aAttributes)
+	{
+		auto remap = reorder_vertices_for_meshlets(aMeshlets, aPositions.size());
+		aPositions = remap.apply(aPositions);
+		((aAttributes = remap.apply(aAttributes)), ...);
+		return remap;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Filters which can be used to downsample the levels of a MIP-map chain on the CPU */
+	enum struct mip_filter
+	{
+		/** Averages all texels which are covered by a texel of the next level, like blitting with linear filtering */
+		box,
+		/** Kaiser-windowed sinc filter, which keeps the smaller levels sharper than the box filter, at the cost of slight ringing at hard edges */
+		kaiser
+	};
+
+	/** Configuration of the MIP-map chain generation on the CPU */
+	struct mip_generation_config
+	{
+		/** The filter which is used to compute each level from the previous one */
+		mip_filter mFilter = mip_filter::box;
+
+		/** If set, the alpha values of every level are scaled, so that the same fraction of texels passes an alpha test
+		 *	against this reference value as in level 0. This prevents alpha-tested geometry (e.g. foliage) from thinning
+		 *	out in the distance. Only applies to formats with four components.
+		 */
+		std::optional<float> mAlphaCoverageReference;
+	};
+
+	/** A level of a MIP-map chain which has been generated on the CPU */
+	struct mip_level
+	{
+		vk::Extent3D mExtent;
+		std::vector<std::byte> mData;
+	};
+
+	/** Returns true if generate_mip_chain supports the given format. Supported are uncompressed formats with
+	 *	one to four 8-bit unorm or sRGB components, and with one to four 32-bit float components.
+	 */
+	bool can_generate_mip_chain_on_cpu(vk::Format aFormat);
+
+	/** Generates all levels of a MIP-map chain below level 0 on the CPU.
+	 *	Filtering happens in linear space, i.e. components of sRGB formats (except alpha) are linearized before and
+	 *	converted back to sRGB after filtering. Texels outside of the image are clamped to the edge.
+	 *	@param	aLevel0		The tightly packed texels of level 0
+	 *	@param	aExtent		The extent of level 0. Only 2D images are supported, i.e. depth must be 1.
+	 *	@param	aFormat		The format of the texels, must be supported by can_generate_mip_chain_on_cpu.
+	 *	@param	aConfig		The filter and alpha coverage settings
+	 *	@returns			Levels 1 to n, where level n has an extent of 1x1
+	 */
+	std::vector<mip_level> generate_mip_chain(const void* aLevel0, vk::Extent3D aExtent, vk::Format aFormat, const mip_generation_config& aConfig = {});
+
+	/** Resamples a 2D image to a different extent on the CPU, e.g. to reduce its resolution.
+	 *	Like generate_mip_chain, filtering happens in linear space and texels outside of the image are clamped to the edge.
+	 *	@param	aTexels			The tightly packed texels of the image
+	 *	@param	aExtent			The extent of the image, whose depth must be 1
+	 *	@param	aFormat			The format of the texels, must be supported by can_generate_mip_chain_on_cpu.
+	 *	@param	aTargetExtent	The extent of the result, whose depth must be 1
+	 *	@param	aFilter			The filter, which adapts its footprint to the scale factor along each axis
+	 *	@returns				The tightly packed texels of the resampled image, in the same format
+	 */
+	std::vector<std::byte> resample_image(const void* aTexels, vk::Extent3D aExtent, vk::Format aFormat, vk::Extent3D aTargetExtent, mip_filter aFilter = mip_filter::kaiser);
+}
@@ -88,7 +88,7 @@ namespace gvk
 		std::string name_of_material(size_t aMaterialIndex) const;
 
 		/** Gets the `material_config` struct for the mesh at the given index.
-		 *	The `material_config` struct is created from Assimp's internal material data.
+		 *	The `material_config` struct is created from Assimp's internal material data, see material_id_for_mesh.
 		 *	@param		aMeshIndex		The index corresponding to the mesh
 		 *	@return		`material_config` struct, representing the "type of material". 
 		 *				To actually load all the resources it refers to, you'll have 
@@ -96,12 +96,40 @@ namespace gvk
 		 */
 		material_config material_config_for_mesh(mesh_index_t aMeshIndex);
 
+		/** Gets the ID of the material of the mesh at the given index.
+		 *	Every Assimp material is extracted into a `material_config` struct only once, when it is requested for the first mesh
+		 *	which it is assigned to. Identical `material_config` structs are interned into a table, i.e. meshes with identical
+		 *	materials get the same ID, even if their Assimp materials are different.
+		 *	@param		aMeshIndex		The index corresponding to the mesh
+		 *	@return		The ID of the material, which can be passed to material_config_for_id
+		 */
+		material_id_t material_id_for_mesh(mesh_index_t aMeshIndex);
+
+		/** Gets a copy of the `material_config` struct with the given ID. It is returned by value, because the table of
+		 *	materials grows whenever material_id_for_mesh or set_material_config_for_mesh intern a new material.
+		 *	@param		aMaterialId		An ID returned by material_id_for_mesh or distinct_material_ids
+		 */
+		material_config material_config_for_id(material_id_t aMaterialId) const;
+
+		/** Gets the number of materials which have been interned so far. Since materials are extracted lazily, not all of
+		 *	this model's materials are interned before material_id_for_mesh has been invoked for all meshes.
+		 */
+		size_t number_of_material_ids() const;
+
 		/**	Sets some material config struct for the mesh at the given index.
 		 *	@param	aMeshIndex			The index corresponding to the mesh
 		 *	@param	aMaterialConfig		Material config that is to be assigned to the mesh.
 		 */
 		void set_material_config_for_mesh(mesh_index_t aMeshIndex, const material_config& aMaterialConfig);
 
+		/**	Groups all meshes of this model by their distinct materials. Materials are compared once per material ID,
+		 *	with their precomputed hashes, and not once per mesh.
+		 *	@param	aAlsoConsiderCpuOnlyDataForDistinctMaterials	Whether the data which only remains on the CPU is also compared, see distinct_material_configs
+		 *	@return	For every distinct material: The ID of one of the equal materials, and the indices of all meshes which have
+		 *			one of them assigned, in ascending order.
+		 */
+		std::vector<std::tuple<material_id_t, std::vector<mesh_index_t>>> distinct_material_ids(bool aAlsoConsiderCpuOnlyDataForDistinctMaterials = false);
+
 		/**	Gets all distinct `material_config` structs foor this model and, as a bonus, so to say,
 		 *	also gets all the mesh indices which have the materials assigned to.
 		 *	@param	aAlsoConsiderCpuOnlyDataForDistinctMaterials	Setting this parameter to `true` means that for determining if a material is unique or not,
@@ -114,6 +142,7 @@ namespace gvk
 		 *															`mTwosided`, `mBlendMode`. If you don't plan to differentiate based on these, set to `false`.
 		 *	@return	A `std::unordered_map` containing the distinct `material_config` structs as the
 		 *			keys and a vector of mesh indices as the value type, i.e. `std::vector<size_t>`. 
+		 *			It is created from distinct_material_ids.
 		 */
 		std::unordered_map<material_config, std::vector<mesh_index_t>> distinct_material_configs(bool aAlsoConsiderCpuOnlyDataForDistinctMaterials = false);
 			
@@ -124,7 +153,7 @@ namespace gvk
 		 *				`tangents_for_mesh`, `bitangents_for_mesh`, `colors_for_mesh`, 
 		 *				and `texture_coordinates_for_mesh`
 		 */
-		inline size_t number_of_vertices_for_mesh(mesh_index_t aMeshIndex) const;
+		size_t number_of_vertices_for_mesh(mesh_index_t aMeshIndex) const;
 
 		/** Gets all the positions for the mesh at the given index.
 		 *	@param		aMeshIndex		The index corresponding to the mesh
@@ -380,6 +409,8 @@ namespace gvk
 		
 	private:
 		void initialize_materials();
+		material_config material_config_from_assimp(size_t aMaterialIndex) const;
+		material_id_t intern_material_config(const material_config& aMaterialConfig);
 		aiNode* find_mesh_root_node(unsigned int aMeshIndexToFind) const;
 		aiNode* mesh_node_traverser(unsigned int aMeshIndexToFind, aiNode* aNode) const;
 		std::optional<glm::mat4> transformation_matrix_traverser(unsigned int aMeshIndexToFind, const aiNode* aNode, const aiMatrix4x4& aM) const;
@@ -413,7 +444,18 @@ namespace gvk
 		std::unique_ptr<Assimp::Importer> mImporter;
 		std::string mModelPath;
 		const aiScene* mScene;
-		std::vector<std::optional<material_config>> mMaterialConfigPerMesh;
+
+		// An entry of the material table, with the hashes of both kinds of equality of material_config
+		struct interned_material
+		{
+			material_config mConfig;
+			size_t mHash;
+			size_t mHashWithCpuOnlyData;
+		};
+		std::vector<interned_material> mMaterials;
+		std::unordered_multimap<size_t, material_id_t> mMaterialIdsByHash;
+		std::vector<std::optional<material_id_t>> mMaterialIdPerAssimpMaterial;
+		std::vector<std::optional<material_id_t>> mMaterialIdPerMesh;
 	};
 
 	using model = avk::owning_resource<model_t>;
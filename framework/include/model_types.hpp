@@ -5,6 +5,8 @@ namespace gvk
 {
 	using model_index_t = size_t;
 	using mesh_index_t = size_t;
+	/** The index of a material in the table of distinct materials of a model, see model_t::material_id_for_mesh */
+	using material_id_t = uint32_t;
 
 	/** Convert from an ASSIMP vec3 to a GLM vec3 */
 	static glm::vec3 to_vec3(const aiVector3D& aAssimpVector)
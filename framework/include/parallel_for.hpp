@@ -0,0 +1,111 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Threads which execute the iterations of parallel_for. They are created once, when parallel_for is used first,
+	 *	and are reused by all calls, instead of spawning new threads for every call.
+	 */
+	class worker_pool
+	{
+	public:
+		/** The pool which is shared by all calls of parallel_for, with one thread less than the hardware supports,
+		 *	since the thread which calls parallel_for works on the indices too.
+		 */
+		static worker_pool& instance();
+
+		worker_pool(worker_pool&&) = delete;
+		worker_pool(const worker_pool&) = delete;
+		worker_pool& operator=(worker_pool&&) = delete;
+		worker_pool& operator=(const worker_pool&) = delete;
+		~worker_pool();
+
+		/** The number of threads of the pool */
+		size_t number_of_workers() const { return mWorkers.size(); }
+
+		/** Executes aTask on one of the threads of the pool */
+		void submit(std::function<void()> aTask);
+
+	private:
+		explicit worker_pool(size_t aNumWorkers);
+
+		std::mutex mMutex;
+		std::condition_variable mTaskAvailable;
+		std::deque<std::function<void()>> mTasks;
+		bool mStop = false;
+		std::vector<std::thread> mWorkers;
+	};
+
+	/** Invokes aFunction for the indices [0, aCount) on the calling thread and the threads of the worker_pool.
+	 *	The calling thread works on the indices too and only waits for workers which have picked up an index, so that
+	 *	nested calls, e.g. from within aFunction, cannot deadlock. If aFunction throws, the remaining indices are
+	 *	skipped and the first exception is rethrown.
+	 *	@param	aCount		The number of indices
+	 *	@param	aFunction	The function to invoke with every index
+	 *	@param	aMaxThreads	The maximum number of threads to use, including the calling thread, or 0 to use all threads of the worker_pool
+	 */
+	template <typename F>
+	void parallel_for(size_t aCount, F aFunction, size_t aMaxThreads = 0)
+	{
+		auto& pool = worker_pool::instance();
+		size_t numThreads = std::min<size_t>(aCount, pool.number_of_workers() + 1);
+		if (0 != aMaxThreads) {
+			numThreads = std::min(numThreads, aMaxThreads);
+		}
+		if (numThreads <= 1) {
+			for (size_t i = 0; i < aCount; ++i) {
+				aFunction(i);
+			}
+			return;
+		}
+
+		struct state
+		{
+			std::atomic<size_t> mNext{ 0 };
+			size_t mActive = 0;
+			std::mutex mMutex;
+			std::condition_variable mDone;
+			std::exception_ptr mError;
+		};
+		auto shared = std::make_shared<state>();
+		auto work = [&aFunction, aCount](state& aState) {
+			try {
+				for (size_t i = aState.mNext++; i < aCount; i = aState.mNext++) {
+					aFunction(i);
+				}
+			}
+			catch (...) {
+				std::scoped_lock lock(aState.mMutex);
+				if (!aState.mError) {
+					aState.mError = std::current_exception();
+				}
+				aState.mNext = aCount;
+			}
+		};
+		for (size_t t = 1; t < numThreads; ++t) {
+			// Workers which pick up their task after all indices have been taken return immediately, without touching
+			// aFunction, which may not exist anymore by then:
+			pool.submit([shared, work, aCount]() {
+				{
+					std::scoped_lock lock(shared->mMutex);
+					if (shared->mNext >= aCount) {
+						return;
+					}
+					++shared->mActive;
+				}
+				work(*shared);
+				{
+					std::scoped_lock lock(shared->mMutex);
+					--shared->mActive;
+				}
+				shared->mDone.notify_all();
+			});
+		}
+		work(*shared);
+		std::unique_lock lock(shared->mMutex);
+		shared->mDone.wait(lock, [&]() { return 0 == shared->mActive; });
+		if (shared->mError) {
+			std::rethrow_exception(shared->mError);
+		}
+	}
+}
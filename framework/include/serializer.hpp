@@ -38,10 +38,13 @@
  *  the first value read from any cache file if the serializer is initialized in `deserialize`-mode. It is used to
  *  verfiy that the cache file's format is compatible with the serialization formats of the framework's state. If a
  *  framework function changes the format of the serialized/deserialized data, this version must be incremented to
- *  invalidate old cache files. An exception will be thrown if the cache file's version and the framework's serializer
- *  versions do not match.
+ *  invalidate old cache files. If the cache file's version and the framework's serializer versions do not match, an
+ *  exception will be thrown if the serializer is explicitly initialized in `deserialize`-mode. Otherwise, the cache file
+ *  is recreated.
+ *  The version is followed by the gvk::compression_codec of the cache file, the 64-bit hash of the inputs which the
+ *  cache file has been created from (see gvk::content_hash), and the (possibly compressed) data.
  */
-#define SERIALIZER_CACHE_FILE_VERSION 0x00000001
+#define SERIALIZER_CACHE_FILE_VERSION 0x00000009
 
 namespace gvk {
 
@@ -56,6 +59,168 @@ namespace gvk {
 		return std::filesystem::exists(aPath);
 	}
 
+	/** @brief Checks if a cache file exists and has been written with the current SERIALIZER_CACHE_FILE_VERSION
+	 *  from the same inputs
+	 *
+	 *  @param[in] aPath The path to a cached file
+	 *  @param[in] aInputHash The hash of the inputs which the cache file is created from, e.g. built
+	 *                        with gvk::content_hash from the source files which are loaded in
+	 *                        serialize mode. It must match the hash stored in the cache file.
+	 *
+	 *  @param[out] True if the cache file exists and its version and input hash match, false otherwise
+	 */
+	static inline bool is_cache_file_up_to_date(const std::string_view aPath, std::uint64_t aInputHash = 0)
+	{
+		if (!does_cache_file_exist(aPath)) {
+			return false;
+		}
+		std::ifstream file(std::string(aPath), std::ios::binary);
+		std::uint32_t versionAndCodec[2] = { 0, 0 };
+		std::uint64_t inputHash = 0;
+		file.read(reinterpret_cast<char*>(versionAndCodec), sizeof(versionAndCodec));
+		file.read(reinterpret_cast<char*>(&inputHash), sizeof(inputHash));
+		return file.good() && versionAndCodec[0] == SERIALIZER_CACHE_FILE_VERSION && inputHash == aInputHash;
+	}
+
+	/** @brief Trait which opts a type into the binary fast path of the serializer
+	 *
+	 *  Vectors of types for which this trait is true are serialized as one block of memory,
+	 *  instead of element by element, see binary_vector. This is only valid for trivially
+	 *  copyable types which do not contain pointers, i.e. whose memory representation can be
+	 *  written to a cache file and read back as it is. Specialize it for custom types by
+	 *  deriving from binary_serializable, or from binary_serializable_with_padding if the
+	 *  type, or one of its members, contains padding:
+	 *
+	 *  template<> struct gvk::is_binary_serializable<YOUR_TYPE> : gvk::binary_serializable<1> {};
+	 */
+	template<typename T>
+	struct is_binary_serializable : std::false_type {};
+
+	template<typename T>
+	inline constexpr bool is_binary_serializable_v = is_binary_serializable<T>::value;
+
+	/** @brief Base of is_binary_serializable specializations for types without padding
+	 *
+	 *  @tparam Version The version of the type's memory layout. Increment it whenever the members
+	 *                  of the type change without changing its size and alignment, e.g. if they are
+	 *                  reordered, so that binary_vector detects data of the previous layout.
+	 */
+	template<std::uint32_t Version>
+	struct binary_serializable : std::true_type
+	{
+		static constexpr std::uint32_t version = Version;
+	};
+
+	/** @brief Base of is_binary_serializable specializations for types with padding
+	 *
+	 *  Padding is not initialized, i.e. writing the memory of such types as it is would write
+	 *  arbitrary bytes to cache files, which change their checksums from run to run. Therefore,
+	 *  binary_vector writes the listed members one by one into zeroed memory instead. All members
+	 *  of the type must be listed:
+	 *
+	 *  template<> struct gvk::is_binary_serializable<YOUR_TYPE> : gvk::binary_serializable_with_padding<1, &YOUR_TYPE::mA, &YOUR_TYPE::mB> {};
+	 *
+	 *  @tparam Version See binary_serializable
+	 *  @tparam Members Pointers to all members of the type
+	 */
+	template<std::uint32_t Version, auto... Members>
+	struct binary_serializable_with_padding : binary_serializable<Version>
+	{
+		/** @brief Copies the members of aSource to aTarget, leaving the padding bytes of aTarget untouched */
+		template<typename T>
+		static void copy_without_padding(const T& aSource, std::byte* aTarget)
+		{
+			const auto* source = reinterpret_cast<const std::byte*>(&aSource);
+			(copy_member(aSource.*Members, aTarget + (reinterpret_cast<const std::byte*>(&(aSource.*Members)) - source)), ...);
+		}
+
+	private:
+		template<typename M>
+		static void copy_member(const M& aMember, std::byte* aTarget)
+		{
+			// Members which contain padding themselves are copied member by member as well
+			if constexpr (requires { is_binary_serializable<M>::copy_without_padding(aMember, aTarget); }) {
+				is_binary_serializable<M>::copy_without_padding(aMember, aTarget);
+			}
+			else {
+				std::memcpy(aTarget, &aMember, sizeof(M));
+			}
+		}
+	};
+
+	/** @brief Describes the memory layout of a type, see binary_vector
+	 *
+	 *  @return A hash of the size, the alignment, and the version (see binary_serializable) of the type
+	 */
+	template<typename T>
+	constexpr std::uint64_t binary_layout_hash()
+	{
+		std::uint64_t version = 0;
+		if constexpr (requires { is_binary_serializable<T>::version; }) {
+			version = is_binary_serializable<T>::version;
+		}
+		// FNV-1a of size, alignment, and version
+		std::uint64_t hash = 0xcbf29ce484222325ull;
+		for (const std::uint64_t value : { static_cast<std::uint64_t>(sizeof(T)), static_cast<std::uint64_t>(alignof(T)), version }) {
+			for (int i = 0; i < 8; ++i) {
+				hash = (hash ^ ((value >> (i * 8)) & 0xff)) * 0x100000001b3ull;
+			}
+		}
+		return hash;
+	}
+
+	/** @brief Serializes/Deserializes a vector of a binary serializable type as one block of memory
+	 *
+	 *  The number of elements and the binary_layout_hash of the element type are written in front
+	 *  of the elements' memory. Deserialization resizes the vector and copies the memory into it
+	 *  at once, and throws if the layout of the element type has changed since the data has been
+	 *  written. The serializer uses this wrapper for every vector of a type for which
+	 *  is_binary_serializable is true. Use it within custom serialization functions for nested
+	 *  vectors:
+	 *
+	 *  aArchive(gvk::binary_vector{ aValue.mPositionKeys });
+	 */
+	template<typename T>
+	struct binary_vector
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only vectors of trivially copyable types can be serialized as binary data.");
+
+		std::vector<T>& mVector;
+
+		template<typename Archive>
+		void save(Archive& aArchive) const
+		{
+			const std::uint64_t size = mVector.size();
+			const std::uint64_t layout = binary_layout_hash<T>();
+			if constexpr (requires(const T& aElement, std::byte* aTarget) { is_binary_serializable<T>::copy_without_padding(aElement, aTarget); }) {
+				// Write the members into zeroed memory, so that no uninitialized padding ends up in the cache file
+				std::vector<std::byte> packed(mVector.size() * sizeof(T));
+				for (size_t i = 0; i < mVector.size(); ++i) {
+					is_binary_serializable<T>::copy_without_padding(mVector[i], packed.data() + i * sizeof(T));
+				}
+				aArchive(size, layout, cereal::binary_data(packed.data(), packed.size()));
+			}
+			else {
+				aArchive(size, layout, cereal::binary_data(mVector.data(), mVector.size() * sizeof(T)));
+			}
+		}
+
+		template<typename Archive>
+		void load(Archive& aArchive)
+		{
+			std::uint64_t size, layout;
+			aArchive(size, layout);
+			if (layout != binary_layout_hash<T>()) {
+				throw gvk::runtime_error("The memory layout of a type stored in the cache file has changed. Please delete the existing cache file and let it be recreated!");
+			}
+			mVector.resize(static_cast<size_t>(size));
+			aArchive(cereal::binary_data(mVector.data(), mVector.size() * sizeof(T)));
+		}
+	};
+
+	template<typename T>
+	binary_vector(std::vector<T>&) -> binary_vector<T>;
+
 	/** @brief serializer
 	 *  
 	 *  This type serializes/deserializes objects to/from binary files using the cereal
@@ -77,34 +242,85 @@ namespace gvk {
 		 *  @param[in] aCacheFilePath The path to the cache file
 		 *  @param[in] aMode serializer::mode::serialize for serialization
 		 *					 serializer::mode::deserialize for deserialization
+		 *  @param[in] aCodec The compression codec to use for serialization. It is stored in the
+		 *					  cache file, and compressed files are decompressed automatically during
+		 *					  deserialization. Compression makes cache files smaller, but reading them
+		 *					  requires to decompress them chunk by chunk, see decompressing_streambuf.
+		 *  @param[in] aInputHash The hash of the inputs which the cache file is created from, see
+		 *					  is_cache_file_up_to_date. It is stored in the cache file in serialize
+		 *					  mode, and must match the stored hash in deserialize mode.
 		 */
-		serializer(std::string_view aCacheFilePath, serializer::mode aMode) :
+		serializer(std::string_view aCacheFilePath, serializer::mode aMode, compression_codec aCodec = compression_codec::none, std::uint64_t aInputHash = 0) :
 			mArchive(aMode == serializer::mode::serialize ?
-				std::variant<deserialize, serialize>{ serializer::serialize(aCacheFilePath) } :
+				std::variant<deserialize, serialize>{ serializer::serialize(aCacheFilePath, aCodec, aInputHash) } :
 				std::variant<deserialize, serialize>{ serializer::deserialize(aCacheFilePath) })
 		{
-			std::uint32_t version = SERIALIZER_CACHE_FILE_VERSION;
-			archive(version);
-			// If the mode is `deserialize`, version was overwritten by `archive` from the cache file and may be different
-			if (version != SERIALIZER_CACHE_FILE_VERSION)
+			// If the mode is `deserialize`, the version has been read from the cache file and may be different
+			if (mode() == mode::deserialize && std::get<deserialize>(mArchive).file_version() != SERIALIZER_CACHE_FILE_VERSION)
 			{
 				throw std::runtime_error("Versions of serializer and cache file do not match. Please delete the existing cache file and let it be recreated!");
 			}
+			if (mode() == mode::deserialize && std::get<deserialize>(mArchive).input_hash() != aInputHash)
+			{
+				throw gvk::runtime_error("The cache file has been created from different inputs. Please delete the existing cache file and let it be recreated!");
+			}
 		}
 
 		/** @brief Construct a serializer with serializing or deserializing capabilities
-		 *  If the cache file from aCacheFilePath does not exists, the serializer is initialized
-		 *  in serialization mode and creates the file for writing, else the serializer is
-		 *  initialised in deserialization mode and reads from the file.
+		 *  If the cache file from aCacheFilePath does not exists, or if it has been written with
+		 *  a different SERIALIZER_CACHE_FILE_VERSION, the serializer is initialized in serialization
+		 *  mode and (re)creates the file for writing, else the serializer is initialised in
+		 *  deserialization mode and reads from the file.
+		 *
+		 *  @param[in] aCacheFilePath The path to the cache file
+		 *  @param[in] aCodec The compression codec to use if the cache file is (re)created
+		 */
+		serializer(std::string_view aCacheFilePath, compression_codec aCodec = compression_codec::none) :
+			serializer(aCacheFilePath, std::uint64_t{ 0 }, aCodec)
+		{ }
+
+		/** @brief Construct a serializer with serializing or deserializing capabilities
+		 *  Like the constructor above, but the cache file is also (re)created if it has been
+		 *  created from different inputs, i.e. if the hash stored in it does not match aInputHash.
+		 *  This detects cache files whose source files have changed since they have been written:
+		 *
+		 *  auto inputHash = gvk::content_hash{}.add_file(modelPath, gvk::file_hash_mode::timestamp_and_size).add(aiFlags).value();
+		 *  auto serializer = gvk::serializer(modelPath + ".cache", inputHash);
 		 *
 		 *  @param[in] aCacheFilePath The path to the cache file
+		 *  @param[in] aInputHash The hash of the inputs which the cache file is created from
+		 *  @param[in] aCodec The compression codec to use if the cache file is (re)created
 		 */
-		serializer(std::string_view aCacheFilePath) :
-			serializer(aCacheFilePath, does_cache_file_exist(aCacheFilePath) ?
+		serializer(std::string_view aCacheFilePath, std::uint64_t aInputHash, compression_codec aCodec = compression_codec::none) :
+			serializer(aCacheFilePath, is_cache_file_up_to_date(aCacheFilePath, aInputHash) ?
 				serializer::mode::deserialize :
-				serializer::mode::serialize)
+				serializer::mode::serialize, aCodec, aInputHash)
 		{ }
 
+		/** @brief Create a serializer which serializes into memory
+		 *
+		 *  The serialized data can be retrieved with take_serialized_memory. Unlike serializers
+		 *  for cache files, no version is written, since in-memory data is expected to be part of
+		 *  a container which stores the version itself, like gvk::cache_file does.
+		 */
+		static serializer serialize_to_memory()
+		{
+			return serializer(std::variant<deserialize, serialize>{ serialize(std::make_unique<std::stringbuf>(std::ios::out | std::ios::binary)) });
+		}
+
+		/** @brief Create a serializer which deserializes from memory
+		 *
+		 *  This is the counterpart to serialize_to_memory, no version is read.
+		 *
+		 *  @param[in] aData The serialized data
+		 *  @param[in] aDataOwner Optional owner of aData, which is kept alive as long as the
+		 *                        serializer exists, e.g. a std::shared_ptr<memory_mapped_file>
+		 */
+		static serializer deserialize_from_memory(std::span<const std::byte> aData, std::shared_ptr<const void> aDataOwner = {})
+		{
+			return serializer(std::variant<deserialize, serialize>{ deserialize(aData, std::move(aDataOwner)) });
+		}
+
 		serializer() = delete;
 		serializer(serializer&&) noexcept = default;
 		serializer(const serializer&) = delete;
@@ -162,6 +378,19 @@ namespace gvk {
 			}
 		}
 
+		/** @brief Serializes/Deserializes a vector of a binary serializable type
+		 *
+		 *  Vectors of types for which is_binary_serializable is true are serialized as one
+		 *  block of memory instead of element by element, see binary_vector.
+		 *
+		 *  @param[in] aValue The vector to serialize or to deserialize into
+		 */
+		template<typename T> requires is_binary_serializable_v<T>
+		inline void archive(std::vector<T>& aValue)
+		{
+			archive(binary_vector<T>{ aValue });
+		}
+
 		/** @brief Serializes/Deserializes raw memory
 		 *
 		 *  This function serializes a block of memory of a specific size if the serializer
@@ -179,8 +408,31 @@ namespace gvk {
 				std::get<serialize>(mArchive)(binary_data(aValue, aSize));
 			}
 			else {
-				std::get<deserialize>(mArchive)(binary_data(aValue, aSize));
+				// Copy straight from the mapped cache file, or from the decompressed chunks, into the target memory
+				std::get<deserialize>(mArchive).read(aValue, aSize);
+			}
+		}
+
+		/** @brief Returns a view of raw memory inside of the cache file without copying it
+		 *
+		 *  Only valid in deserialization mode. The returned memory is part of the memory mapped
+		 *  cache file and corresponds to a block of memory which has been serialized with
+		 *  archive_memory or archive_buffer. It stays valid as long as the serializer exists.
+		 *  Use this instead of archive_memory to avoid intermediate copies, e.g. if the data is
+		 *  only needed to be copied into a staging buffer or to be decoded. The returned memory
+		 *  is not guaranteed to be aligned. For compressed cache files, the returned memory is
+		 *  part of the current decompressed chunk instead, or assembled from multiple chunks,
+		 *  and it only stays valid until the next value is read from the serializer.
+		 *
+		 *  @param[in] aSize The total size of the data in memory
+		 *  @return A view of aSize bytes of serialized memory
+		 */
+		std::span<const std::byte> view_memory(size_t aSize)
+		{
+			if (mode() != mode::deserialize) {
+				throw gvk::runtime_error("serializer::view_memory can only be used in serializer::mode::deserialize.");
 			}
+			return std::get<deserialize>(mArchive).view(aSize);
 		}
 
 		/** @brief Serializes/Deserializes a avk::buffer
@@ -203,11 +455,25 @@ namespace gvk {
 			archive_memory(mapping.get(), size);
 		}
 
+		/** @brief Moves the data out of a serializer created with serialize_to_memory
+		 *
+		 *  @return The serialized data
+		 */
+		std::string take_serialized_memory()
+		{
+			if (mode() != mode::serialize) {
+				throw gvk::runtime_error("serializer::take_serialized_memory can only be used in serializer::mode::serialize.");
+			}
+			return std::get<serialize>(mArchive).take_memory();
+		}
+
 		/** @brief Flush the underlying output stream
 		 *
 		 *  This function can be used to explicitely flush the underlying outputstream during
-		 *  serialization and requests all data to be written. During deserialization, this
-		 *  function does nothing
+		 *  serialization and requests all data to be written. When serializing to a file, data
+		 *  is written by a background thread (see async_file_streambuf), and this function waits
+		 *  until all data has been written. It throws if writing has failed. During
+		 *  deserialization, this function does nothing
 		 */
 		void flush()
 		{
@@ -220,10 +486,12 @@ namespace gvk {
 
 		/** @brief serialize
 		 *
-		 *  This type represents an output archive to save data in binary form to a file.
+		 *  This type represents an output archive to save data in binary form to a file
+		 *  or to memory. Files are written asynchronously by an async_file_streambuf.
 		 */
 		class serialize {
-			std::ofstream mOfstream;
+			std::unique_ptr<std::streambuf> mStreambuf;
+			std::ostream mOstream;
 			cereal::BinaryOutputArchive mArchive;
 
 		public:
@@ -232,16 +500,28 @@ namespace gvk {
 			/** @brief Construct, outputting a binary file to the provided path
 			 *
 			 *  @param[in] aCacheFilePath The filename including the full path where to save the cached file
+			 *  @param[in] aCodec The compression codec to use
+			 *  @param[in] aInputHash The hash of the inputs which the cache file is created from
+			 */
+			serialize(const std::string_view aCacheFilePath, compression_codec aCodec, std::uint64_t aInputHash) :
+				serialize(open_file(aCacheFilePath, aCodec, aInputHash))
+			{}
+
+			/** @brief Construct, outputting to the provided stream buffer
+			 *
+			 *  @param[in] aStreambuf The stream buffer to write to, e.g. a std::stringbuf to serialize to memory
 			 */
-			serialize(const std::string_view aCacheFilePath) :
-				mOfstream(aCacheFilePath.data(), std::ios::binary),
-				mArchive(mOfstream)
+			serialize(std::unique_ptr<std::streambuf> aStreambuf) :
+				mStreambuf(std::move(aStreambuf)),
+				mOstream(mStreambuf.get()),
+				mArchive(mOstream)
 			{}
 
 			/* Construct from other serialize */
 			serialize(serialize&& aOther) noexcept :
-				mOfstream(std::move(aOther.mOfstream)),
-				mArchive(mOfstream)
+				mStreambuf(std::move(aOther.mStreambuf)),
+				mOstream(mStreambuf.get()),
+				mArchive(mOstream)
 			{}
 
 			serialize(const serialize&) = delete;
@@ -268,17 +548,64 @@ namespace gvk {
 			 */
 			void flush()
 			{
-				mOfstream.flush();
+				mOstream.flush();
+				if (mOstream.bad()) {
+					throw gvk::runtime_error("Writing serialized data failed.");
+				}
+			}
+
+			/** @brief Moves the serialized data out of the underlying std::stringbuf
+			 *
+			 *  Only valid if this serialize has been constructed to serialize to memory.
+			 */
+			std::string take_memory()
+			{
+				auto* stringbuf = dynamic_cast<std::stringbuf*>(mStreambuf.get());
+				if (nullptr == stringbuf) {
+					throw gvk::runtime_error("Only a serializer which serializes to memory can hand out its serialized data.");
+				}
+				return std::move(*stringbuf).str();
+			}
+
+		private:
+			static std::unique_ptr<std::streambuf> open_file(const std::string_view aCacheFilePath, compression_codec aCodec, std::uint64_t aInputHash)
+			{
+				std::unique_ptr<std::streambuf> file = std::make_unique<async_file_streambuf>(aCacheFilePath);
+				// The header is never compressed:
+				const std::uint32_t header[] = { SERIALIZER_CACHE_FILE_VERSION, static_cast<std::uint32_t>(aCodec) };
+				file->sputn(reinterpret_cast<const char*>(header), sizeof(header));
+				file->sputn(reinterpret_cast<const char*>(&aInputHash), sizeof(aInputHash));
+				if (compression_codec::none == aCodec) {
+					return file;
+				}
+				return std::make_unique<compressing_streambuf>(std::move(file), aCodec);
 			}
 		};
 
 		/** @brief deserialize
 		 *
 		 *  This type represents an input archive to retrieve data in binary form from a file.
+		 *  The file is memory mapped and read in place, so that raw memory can be handed out
+		 *  without copying it, see serializer::view_memory. Compressed files are decompressed
+		 *  chunk by chunk while they are read, see decompressing_streambuf.
 		 */
 		class deserialize
 		{
-			std::ifstream mIfstream;
+			/** The data of a cache file after its header */
+			struct file_contents
+			{
+				std::span<const std::byte> mData;
+				std::shared_ptr<const void> mOwner;
+				std::uint32_t mVersion;
+				std::uint64_t mInputHash;
+				compression_codec mCodec;
+			};
+
+			std::shared_ptr<const void> mOwner;
+			std::uint32_t mFileVersion = 0;
+			std::uint64_t mInputHash = 0;
+			std::unique_ptr<std::streambuf> mStreambuf;
+			std::istream mIstream;
 			cereal::BinaryInputArchive mArchive;
 
 		public:
@@ -289,14 +616,26 @@ namespace gvk {
 			 *  @param[in] aCacheFilePath The filename including the full path to the binary cached file
 			 */
 			deserialize(const std::string_view aCacheFilePath) :
-				mIfstream(aCacheFilePath.data(), std::ios::binary),
-				mArchive(mIfstream)
+				deserialize(open_file(aCacheFilePath))
+			{}
+
+			/** @brief Construct, reading from memory
+			 *
+			 *  @param[in] aData The memory to read from
+			 *  @param[in] aOwner Optional owner of aData, which is kept alive by this deserialize
+			 */
+			deserialize(std::span<const std::byte> aData, std::shared_ptr<const void> aOwner) :
+				deserialize(std::make_unique<memory_streambuf>(aData), std::move(aOwner))
 			{}
 
 			/* Construct from other deserialize */
 			deserialize(deserialize&& aOther) noexcept :
-				mIfstream(std::move(aOther.mIfstream)),
-				mArchive(mIfstream)
+				mOwner(std::move(aOther.mOwner)),
+				mFileVersion(aOther.mFileVersion),
+				mInputHash(aOther.mInputHash),
+				mStreambuf(std::move(aOther.mStreambuf)),
+				mIstream(mStreambuf.get()),
+				mArchive(mIstream)
 			{}
 
 			deserialize(const deserialize&) = delete;
@@ -315,8 +654,89 @@ namespace gvk {
 			{
 				mArchive(std::forward<Type>(aValue));
 			}
+
+			/** @brief Returns the next aSize bytes of the file without copying them and advances the read position
+			 *
+			 *  @param[in] aSize The number of bytes
+			 */
+			std::span<const std::byte> view(size_t aSize)
+			{
+				if (auto* decompressing = dynamic_cast<decompressing_streambuf*>(mStreambuf.get())) {
+					return decompressing->view(aSize);
+				}
+				auto* memory = static_cast<memory_streambuf*>(mStreambuf.get());
+				auto* begin = memory->current();
+				memory->skip(aSize);
+				return std::span<const std::byte>(begin, aSize);
+			}
+
+			/** @brief Copies the next aSize bytes of the file into aTarget and advances the read position
+			 *
+			 *  @param[in] aTarget The memory to copy to
+			 *  @param[in] aSize The number of bytes
+			 */
+			void read(void* aTarget, size_t aSize)
+			{
+				const auto read = mStreambuf->sgetn(static_cast<char*>(aTarget), static_cast<std::streamsize>(aSize));
+				if (static_cast<size_t>(read) != aSize) {
+					throw gvk::runtime_error(fmt::format("Attempted to read {} bytes, but only {} bytes remain in the cache file.", aSize, read));
+				}
+			}
+
+			/** @brief The version stored in the cache file, or 0 if not reading from a cache file */
+			std::uint32_t file_version() const
+			{
+				return mFileVersion;
+			}
+
+			/** @brief The hash of the inputs stored in the cache file, or 0 if not reading from a cache file */
+			std::uint64_t input_hash() const
+			{
+				return mInputHash;
+			}
+
+		private:
+			deserialize(std::unique_ptr<std::streambuf> aStreambuf, std::shared_ptr<const void> aOwner) :
+				mOwner(std::move(aOwner)),
+				mStreambuf(std::move(aStreambuf)),
+				mIstream(mStreambuf.get()),
+				mArchive(mIstream)
+			{}
+
+			deserialize(file_contents&& aContents) :
+				deserialize(compression_codec::none == aContents.mCodec ?
+					std::unique_ptr<std::streambuf>(std::make_unique<memory_streambuf>(aContents.mData)) :
+					std::unique_ptr<std::streambuf>(std::make_unique<decompressing_streambuf>(aContents.mData, aContents.mCodec)),
+					std::move(aContents.mOwner))
+			{
+				mFileVersion = aContents.mVersion;
+				mInputHash = aContents.mInputHash;
+			}
+
+			static file_contents open_file(const std::string_view aCacheFilePath)
+			{
+				auto mapping = std::make_shared<const memory_mapped_file>(aCacheFilePath);
+				const auto data = mapping->span();
+				std::uint32_t header[2] = { 0, 0 };
+				std::uint64_t inputHash = 0;
+				if (data.size() < sizeof(header)) {
+					return { {}, std::move(mapping), 0, 0, compression_codec::none };
+				}
+				std::memcpy(header, data.data(), sizeof(header));
+				if (header[0] != SERIALIZER_CACHE_FILE_VERSION || data.size() < sizeof(header) + sizeof(inputHash)) {
+					// The format of the remainder is unknown, let the serializer report the mismatch
+					return { {}, std::move(mapping), header[0] == SERIALIZER_CACHE_FILE_VERSION ? 0 : header[0], 0, compression_codec::none };
+				}
+				std::memcpy(&inputHash, data.data() + sizeof(header), sizeof(inputHash));
+				// Compressed data is decompressed while it is read:
+				return { data.subspan(sizeof(header) + sizeof(inputHash)), std::move(mapping), header[0], inputHash, static_cast<compression_codec>(header[1]) };
+			}
 		};
 
+		serializer(std::variant<deserialize, serialize>&& aArchive) :
+			mArchive(std::move(aArchive))
+		{ }
+
 		std::variant<deserialize, serialize> mArchive;
 	};
 }
@@ -561,16 +981,16 @@ namespace gvk {
 	void serialize(Archive& aArchive, gvk::animated_node& aValue)
 	{
 		aArchive(
-			aValue.mPositionKeys,
-			aValue.mRotationKeys,
-			aValue.mScalingKeys,
+			gvk::binary_vector{ aValue.mPositionKeys },
+			gvk::binary_vector{ aValue.mRotationKeys },
+			gvk::binary_vector{ aValue.mScalingKeys },
 			aValue.mSameRotationAndPositionKeyTimes,
 			aValue.mSameScalingAndPositionKeyTimes,
 			aValue.mLocalTransform,
 			aValue.mGlobalTransform,
 			aValue.mAnimatedParentIndex,
 			aValue.mParentTransform,
-			aValue.mBoneMeshTargets
+			gvk::binary_vector{ aValue.mBoneMeshTargets }
 		);
 	}
 
@@ -592,3 +1012,41 @@ namespace vk {
 		aArchive(aValue.width, aValue.height, aValue.depth);
 	}
 }
+
+/** @brief Types which are serialized with the binary fast path
+ *
+ *  Vectors of these types are serialized as one block of memory, see gvk::binary_vector.
+ *  Types which contain padding, also in their members, list their members, so that their
+ *  padding is written as zeros.
+ */
+namespace gvk {
+	template<> struct is_binary_serializable<glm::vec2> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<glm::vec3> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<glm::vec4> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<glm::uvec2> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<glm::uvec3> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<glm::uvec4> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<glm::ivec2> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<glm::ivec3> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<glm::ivec4> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<glm::mat3> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<glm::mat4> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<glm::quat> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<gvk::material_gpu_data> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<gvk::lightsource_gpu_data> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<gvk::rotation_key> : binary_serializable<1> {};
+	template<> struct is_binary_serializable<gvk::bone_mesh_data> : binary_serializable_with_padding<1,
+		&gvk::bone_mesh_data::mInverseBindPoseMatrix, &gvk::bone_mesh_data::mInverseMeshRootMatrix, &gvk::bone_mesh_data::mMeshBoneInfo> {};
+	template<> struct is_binary_serializable<gvk::animation_clip_data> : binary_serializable_with_padding<1,
+		&gvk::animation_clip_data::mAnimationIndex, &gvk::animation_clip_data::mTicksPerSecond, &gvk::animation_clip_data::mStartTicks, &gvk::animation_clip_data::mEndTicks> {};
+	template<> struct is_binary_serializable<gvk::position_key> : binary_serializable_with_padding<1, &gvk::position_key::mTime, &gvk::position_key::mValue> {};
+	template<> struct is_binary_serializable<gvk::scaling_key> : binary_serializable_with_padding<1, &gvk::scaling_key::mTime, &gvk::scaling_key::mValue> {};
+	template<> struct is_binary_serializable<gvk::mesh_bone_info> : binary_serializable_with_padding<1,
+		&gvk::mesh_bone_info::mMeshAnimationIndex, &gvk::mesh_bone_info::mMeshIndexInModel, &gvk::mesh_bone_info::mMeshLocalBoneIndex, &gvk::mesh_bone_info::mGlobalBoneIndexOffset> {};
+
+	// Types which are written as they are must not contain padding:
+	static_assert(sizeof(glm::mat3) == 9 * sizeof(float) && sizeof(glm::quat) == 4 * sizeof(float));
+	static_assert(sizeof(gvk::material_gpu_data) == 27 * sizeof(glm::vec4));
+	static_assert(sizeof(gvk::lightsource_gpu_data) == 6 * sizeof(glm::vec4));
+	static_assert(sizeof(gvk::rotation_key) == sizeof(double) + sizeof(glm::quat));
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Axis aligned bounding box. A default constructed box is empty. */
+	struct meshlet_bounding_box
+	{
+		glm::vec3 mMin{ std::numeric_limits<float>::max() };
+		glm::vec3 mMax{ std::numeric_limits<float>::lowest() };
+
+		bool empty() const { return mMin.x > mMax.x || mMin.y > mMax.y || mMin.z > mMax.z; }
+		void extend(const glm::vec3& aPoint) { mMin = glm::min(mMin, aPoint); mMax = glm::max(mMax, aPoint); }
+		void extend(const meshlet_bounding_box& aOther) { mMin = glm::min(mMin, aOther.mMin); mMax = glm::max(mMax, aOther.mMax); }
+		glm::vec3 center() const { return (mMin + mMax) * 0.5f; }
+		/** Radius of the sphere around center() which encloses the box */
+		float radius() const { return empty() ? 0.0f : glm::length(mMax - mMin) * 0.5f; }
+	};
+
+	/** Bounds of a skinned meshlet which hold over all poses of the evaluated animation clips.
+	 *	All bounds are given in mesh space, i.e. the space of the vertex positions which were passed to compute_skinned_meshlet_bounds.
+	 */
+	struct skinned_meshlet_bounds
+	{
+		/** Sorted indices of all bones which influence at least one vertex of the meshlet with a non-zero weight.
+		 *	These are bone indices as passed to compute_skinned_meshlet_bounds, i.e. typically indices into a single target buffer.
+		 */
+		std::vector<uint32_t> mBones;
+
+		/** Bind pose bounds of the vertices influenced by each bone in mBones, in the same order as mBones.
+		 *	Transforming the corners of each box with the (mesh space) bone matrix of its bone and taking the bounds of all
+		 *	transformed corners yields conservative bounds of the meshlet for ANY pose, provided that the bone weights are normalized.
+		 */
+		std::vector<meshlet_bounding_box> mPerBoneBounds;
+
+		/** Bounds per animation clip, in the order in which the clips were passed to compute_skinned_meshlet_bounds.
+		 *	Each box encloses the meshlet at all sample times, and has been inflated by the largest distance d which a vertex
+		 *	of the meshlet moves between two consecutive samples. See compute_skinned_meshlet_bounds for the error bound.
+		 */
+		std::vector<meshlet_bounding_box> mPerClipBounds;
+
+		/** Union of all mPerClipBounds */
+		meshlet_bounding_box animated_bounds() const
+		{
+			meshlet_bounding_box result;
+			for (const auto& box : mPerClipBounds) {
+				result.extend(box);
+			}
+			return result;
+		}
+	};
+
+	/** Bounds of a skinned meshlet for GPU usage in combination with the bone data generated by convert_for_gpu_usage.
+	 *	The bone data contains the bone indices from [mBoneDataOffset] to [mBoneDataOffset + mBoneCount] and the per-bone
+	 *	bind pose boxes (min, max) from [2 * mBoneDataOffset] to [2 * (mBoneDataOffset + mBoneCount)].
+	 */
+	struct skinned_meshlet_bounds_gpu_data
+	{
+		/** Bounding sphere of the animated bounds: center in xyz, radius in w */
+		glm::vec4 mBoundingSphere;
+		/** Minimum of the animated bounds in xyz */
+		glm::vec4 mMin;
+		/** Maximum of the animated bounds in xyz */
+		glm::vec4 mMax;
+		/** Offset into the bone data */
+		uint32_t mBoneDataOffset;
+		/** Number of bones which influence the meshlet */
+		uint32_t mBoneCount;
+		uint32_t mPadding[2];
+	};
+
+	/** Serialization/deserialization method for meshlet_bounding_box.
+	 *	@param	aArchive	The archive.
+	 *	@param	aValue		The value to serialize or to deserialize into.
+	 *	@tparam Archive		The archive type.
+	 */
+	template<typename Archive>
+	void serialize(Archive& aArchive, meshlet_bounding_box& aValue)
+	{
+		aArchive(aValue.mMin, aValue.mMax);
+	}
+
+	/** Serialization/deserialization method for skinned_meshlet_bounds.
+	 *	@param	aArchive	The archive.
+	 *	@param	aValue		The value to serialize or to deserialize into.
+	 *	@tparam Archive		The archive type.
+	 */
+	template<typename Archive>
+	void serialize(Archive& aArchive, skinned_meshlet_bounds& aValue)
+	{
+		aArchive(aValue.mBones, aValue.mPerBoneBounds, aValue.mPerClipBounds);
+	}
+
+	/** Serialization/deserialization method for skinned_meshlet_bounds_gpu_data.
+	 *	@param	aArchive	The archive.
+	 *	@param	aValue		The value to serialize or to deserialize into.
+	 *	@tparam Archive		The archive type.
+	 */
+	template<typename Archive>
+	void serialize(Archive& aArchive, skinned_meshlet_bounds_gpu_data& aValue)
+	{
+		aArchive(aValue.mBoundingSphere, aValue.mMin, aValue.mMax, aValue.mBoneDataOffset, aValue.mBoneCount);
+	}
+
+	/** Computes the set of influencing bones and conservative bounds for skinned meshlets.
+	 *	@param	aMeshlets			The meshlets. Their mVertices index into aPositions, aBoneIndices, and aBoneWeights.
+	 *	@param	aPositions			The bind pose vertex positions in mesh space, e.g. as returned by get_vertices_and_indices.
+	 *	@param	aBoneIndices		The bone indices per vertex, as returned by get_bone_indices_for_single_target_buffer.
+	 *	@param	aBoneWeights		The bone weights per vertex, as returned by get_bone_weights. They should be normalized.
+	 *	@param	aAnimation			The animation which has been prepared for the meshes via model_t::prepare_animation, using the
+	 *								same mesh indices (in the same order) that have been used for get_bone_indices_for_single_target_buffer.
+	 *	@param	aClips				The animation clips to sample. Pass an empty vector to only compute mBones and mPerBoneBounds.
+	 *	@param	aSamplesPerClip		Number of evenly distributed samples per clip. The times of all keys of all animated nodes within
+	 *								a clip are sampled in addition.
+	 *	@param	aMaxRelativeSampleDistance	The interval between two samples is halved (up to eight times) while any vertex moves further than
+	 *								this fraction of the diagonal of the bind pose bounds of aPositions within it.
+	 *
+	 *	Error bound of mPerClipBounds: Every box contains all skinned vertex positions at all sample times, and is inflated by the
+	 *	largest distance d that a vertex of the meshlet moves between two consecutive samples. Between two samples, the box is
+	 *	therefore conservative as long as no vertex deviates further than d from the straight line between its two sampled positions.
+	 *	This holds for translations and scalings, which are interpolated linearly between keys, and for rotations by up to 180 degrees
+	 *	between two samples, whose arcs deviate from their chords by at most half the chord length. For other vertex paths, e.g. under
+	 *	fast rotations of several bones of a hierarchy, a vertex can leave its box by at most the part of its deviation that exceeds d.
+	 *	mPerBoneBounds are not affected by this and are conservative for any pose.
+	 */
+	std::vector<skinned_meshlet_bounds> compute_skinned_meshlet_bounds(
+		const std::vector<meshlet>& aMeshlets,
+		const std::vector<glm::vec3>& aPositions,
+		const std::vector<glm::uvec4>& aBoneIndices,
+		const std::vector<glm::vec4>& aBoneWeights,
+		animation& aAnimation,
+		const std::vector<animation_clip_data>& aClips,
+		uint32_t aSamplesPerClip = 32,
+		float aMaxRelativeSampleDistance = 0.01f);
+
+	/** Computes the set of influencing bones and conservative bounds for skinned meshlets, with caching.
+	 *  @param  aSerializer			The serializer for the bounds.
+	 *	For all other parameters, see compute_skinned_meshlet_bounds. They are only evaluated in serializer::mode::serialize.
+	 */
+	std::vector<skinned_meshlet_bounds> compute_skinned_meshlet_bounds_cached(
+		serializer& aSerializer,
+		const std::vector<meshlet>& aMeshlets,
+		const std::vector<glm::vec3>& aPositions,
+		const std::vector<glm::uvec4>& aBoneIndices,
+		const std::vector<glm::vec4>& aBoneWeights,
+		animation& aAnimation,
+		const std::vector<animation_clip_data>& aClips,
+		uint32_t aSamplesPerClip = 32,
+		float aMaxRelativeSampleDistance = 0.01f);
+
+	/** Converts skinned meshlet bounds into a GPU usable representation, in the same order as the meshlets they belong to.
+	 *	@param	aBounds			The bounds to convert.
+	 *	@param	aClipIndex		If set, the bounds of this clip are used for the bounding box and sphere. Otherwise, the union of all clips is used.
+	 *							If no clips have been sampled, the bounds are computed from mPerBoneBounds in bind pose.
+	 *	@returns				A tuple of the bounds, the bone indices, and the per-bone bind pose boxes (two vec4 per bone: min, max).
+	 */
+	std::tuple<std::vector<skinned_meshlet_bounds_gpu_data>, std::vector<uint32_t>, std::vector<glm::vec4>> convert_for_gpu_usage(const std::vector<skinned_meshlet_bounds>& aBounds, std::optional<size_t> aClipIndex = {});
+
+	/** Converts skinned meshlet bounds into a GPU usable representation, with caching.
+	 *  @param  aSerializer		The serializer for the gpu data.
+	 *	@param	aBounds			The bounds to convert. Only evaluated in serializer::mode::serialize.
+	 *	@param	aClipIndex		If set, the bounds of this clip are used for the bounding box and sphere. Otherwise, the union of all clips is used.
+	 *	@returns				A tuple of the bounds, the bone indices, and the per-bone bind pose boxes (two vec4 per bone: min, max).
+	 */
+	std::tuple<std::vector<skinned_meshlet_bounds_gpu_data>, std::vector<uint32_t>, std::vector<glm::vec4>> convert_for_gpu_usage_cached(serializer& aSerializer, const std::vector<skinned_meshlet_bounds>& aBounds, std::optional<size_t> aClipIndex = {});
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** A region of a staging_ring_buffer. The region is recycled when all copies of its lease have been destroyed,
+	 *	i.e. a copy has to be kept alive until the GPU has finished reading from it, e.g. in a command buffer's custom deleter.
+	 */
+	struct staging_allocation
+	{
+		/** The persistently mapped memory of the region */
+		std::span<std::byte> mMemory;
+		/** The offset of the region in the buffer, see staging_ring_buffer::buffer() */
+		vk::DeviceSize mOffset = 0;
+		/** Keeps the region and the staging_ring_buffer's buffer alive */
+		std::shared_ptr<void> mLease;
+	};
+
+	/** A persistently mapped staging buffer which is suballocated as a ring, so that uploads do not have to create
+	 *	a new buffer for every mip level and face.
+	 *
+	 *	Regions are handed out in allocation order and recycled as soon as they are released, see staging_allocation.
+	 *	Since they are typically released in the order in which they have been allocated, the memory between the oldest and
+	 *	the newest region is never fragmented. If a region does not fit into the free memory, no region is allocated,
+	 *	and the caller falls back to a dedicated staging buffer instead of waiting for the GPU.
+	 *
+	 *	The context owns a ring buffer which is used for uploading textures, see context_vulkan::staging_ring().
+	 *	All methods can be invoked from multiple threads.
+	 */
+	class staging_ring_buffer
+	{
+	public:
+		/** Creates the buffer and maps it.
+		 *	@param	aCapacity	The size of the buffer, in bytes
+		 */
+		explicit staging_ring_buffer(size_t aCapacity);
+		staging_ring_buffer(staging_ring_buffer&&) noexcept = delete;
+		staging_ring_buffer(const staging_ring_buffer&) = delete;
+		staging_ring_buffer& operator=(staging_ring_buffer&&) noexcept = delete;
+		staging_ring_buffer& operator=(const staging_ring_buffer&) = delete;
+		~staging_ring_buffer() = default;
+
+		/** Allocates a region of the given size.
+		 *	@param	aSize		The size of the region, in bytes
+		 *	@param	aAlignment	The alignment of the region's offset in the buffer, e.g. the texel block size of images which are copied from it
+		 *	@returns			The region, or no value if it does not fit into the free memory currently
+		 */
+		std::optional<staging_allocation> allocate(size_t aSize, size_t aAlignment = 16);
+
+		/** Finds the region which contains the given memory, e.g. image data which has been decoded into an allocation from output_allocator().
+		 *	@param	aData	The beginning of the memory
+		 *	@param	aSize	The size of the memory, in bytes
+		 *	@returns		A part of the containing region which starts at aData and has the size aSize, sharing its lease, or no value if the memory is not in a region
+		 */
+		std::optional<staging_allocation> find(const void* aData, size_t aSize) const;
+
+		/** An allocator for image_data::set_output_allocator, which lets images be decoded straight into this ring buffer */
+		image_data_output_allocator output_allocator();
+
+		/** The buffer which the regions are suballocated from */
+		const avk::buffer_t& buffer() const;
+
+		/** The size of the buffer, in bytes */
+		size_t capacity() const;
+
+		/** The number of bytes between the oldest and the newest region which has not been released */
+		size_t used() const;
+
+		/** Records a copy from a region into one layer and mip level of a color image, which must be in the layout vk::ImageLayout::eTransferDstOptimal.
+		 *	Like with avk::copy_buffer_to_image_layer_mip_level, the region must contain the tightly packed texels of the image's level.
+		 *	@param	aCommandBuffer	The command buffer to record the copy into. The lease is not kept alive by this function.
+		 */
+		void record_copy_to_image_layer_mip_level(avk::command_buffer_t& aCommandBuffer, const staging_allocation& aAllocation, avk::image_t& aImage, uint32_t aLayer, uint32_t aLevel) const;
+
+	private:
+		struct region;
+		struct state;
+		std::shared_ptr<state> mState;
+	};
+
+	/** The size of one texel block of an image in bytes, computed from the size of its tightly packed data
+	 *	@param	aFormat		The format of the image
+	 *	@param	aExtent		The extent of the image
+	 *	@param	aSize		The size of all texels of the image, in bytes
+	 *	@returns			The size of one texel, or of one block of a block-compressed format
+	 */
+	size_t texel_block_size(vk::Format aFormat, vk::Extent3D aExtent, size_t aSize);
+}
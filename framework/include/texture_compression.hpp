@@ -0,0 +1,55 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Block-compressed formats which textures can be encoded into on the CPU */
+	enum struct texture_compression
+	{
+		/** Textures stay uncompressed */
+		none,
+		/** RGB with 4 bits per texel, alpha is dropped */
+		bc1,
+		/** RGBA with 8 bits per texel, alpha is encoded separately from the colors */
+		bc3,
+		/** Only the red channel, with 4 bits per texel. Suitable for masks and height maps. */
+		bc4,
+		/** Only the red and green channels, with 8 bits per texel. Suitable for normal maps, whose z component is reconstructed in shaders. */
+		bc5,
+		/** RGBA with 8 bits per texel, in a higher quality than bc1 and bc3 */
+		bc7
+	};
+
+	/** Which texture_compression is used for the textures of the different slots of a material_config */
+	struct texture_compression_config
+	{
+		/** For diffuse, specular, ambient, emissive, reflection, lightmap, and extra textures */
+		texture_compression mColorTextures = texture_compression::bc7;
+
+		/** For normal maps. With bc5, only x and y are stored, and shaders have to reconstruct z as sqrt(1 - x*x - y*y). */
+		texture_compression mNormalMaps = texture_compression::bc5;
+
+		/** For height, shininess, opacity, and displacement textures. With bc4, only the red channel is stored. */
+		texture_compression mMasks = texture_compression::bc4;
+	};
+
+	/** Returns true if compress_texture supports textures of the given format, which are RGBA textures with 8-bit unorm or sRGB components. */
+	bool can_compress_texture(vk::Format aFormat);
+
+	/** Returns the block-compressed format which compress_texture produces for the given compression.
+	 *	@param	aCompression		The compression, must not be texture_compression::none
+	 *	@param	aUncompressedFormat	The format of the uncompressed texture. Only bc1, bc3, and bc7 have sRGB variants,
+	 *								therefore a gvk::runtime_error is thrown if the format is an sRGB format and bc4 or bc5 is requested.
+	 */
+	vk::Format compressed_format_for(texture_compression aCompression, vk::Format aUncompressedFormat);
+
+	/** Encodes one level of a texture into a block-compressed format on the CPU, using multiple threads.
+	 *	Blocks at the right and bottom edges which are not fully covered by the texture are padded by repeating the edge texels.
+	 *	@param	aTexels			The tightly packed texels of the level
+	 *	@param	aExtent			The extent of the level, its depth must be 1.
+	 *	@param	aFormat			The format of the texels, must be supported by can_compress_texture.
+	 *	@param	aCompression	The compression, must not be texture_compression::none
+	 *	@returns				The compressed blocks, row by row
+	 */
+	std::vector<std::byte> compress_texture(const void* aTexels, vk::Extent3D aExtent, vk::Format aFormat, texture_compression aCompression);
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Packs the textures of materials into fewer images, so that fewer descriptors have to be bound and fewer images
+	 *	have to be allocated for scenes with many small textures, see convert_for_gpu_usage.
+	 *
+	 *	Small textures of the same format are packed into texture atlases. Every texture is surrounded by padding which
+	 *	repeats its edge texels, and is placed at a position aligned to the size of the atlas' coarsest MIP level, so that
+	 *	neither bilinear filtering nor MIP-mapping blends neighboring textures. Since the texture coordinates of the atlas'
+	 *	textures are transformed by their offset and tiling, only textures which clamp to the edge are packed into atlases.
+	 *	Their clamping is not preserved, though: the atlas' sampler clamps to the edges of the whole atlas, and the shaders
+	 *	do not clamp the texture coordinates to the areas of the textures. Coordinates up to mPadding texels outside of
+	 *	[0, 1] sample the padding, i.e. the edge texels, but coordinates further outside sample neighboring textures.
+	 *	Only enable packing for models whose clamped textures are addressed by coordinates within [0, 1]. Note that
+	 *	clamp_to_edge is the default border handling mode of material_config, i.e. also of textures which are meant to repeat
+	 *	if a model file does not specify their border handling.
+	 *
+	 *	If requested, textures of the same format, size, and number of MIP levels are packed into the layers of 2D array textures,
+	 *	see mMinArrayLayers.
+	 */
+	struct texture_packing_config
+	{
+		/** Textures whose width and height do not exceed this extent are packed into atlases */
+		uint32_t mMaxAtlasTextureExtent = 256;
+
+		/** The maximum width and height of an atlas */
+		uint32_t mAtlasExtent = 2048;
+
+		/** The number of texels around every texture in an atlas. Atlases have 1 + log2(mPadding) MIP levels at most,
+		 *	which is as many as can be sampled without blending neighboring textures.
+		 */
+		uint32_t mPadding = 4;
+
+		/** If set, textures are packed into a 2D array texture if there are at least as many textures of the same format and size.
+		 *	Not set by default, because array textures have to be bound to sampler2DArray descriptors, and their layers are
+		 *	encoded in the texture indices, see array_texture_index.
+		 */
+		std::optional<uint32_t> mMinArrayLayers;
+
+		/** The maximum number of layers of a 2D array texture, which must not exceed the device's maxImageArrayLayers */
+		uint32_t mMaxArrayLayers = 256;
+	};
+
+	/** A texture which plan_texture_packing can pack */
+	struct texture_packing_candidate
+	{
+		/** The format of the texture */
+		vk::Format mFormat;
+		/** The extent of the texture's first level */
+		vk::Extent3D mExtent;
+		/** The number of MIP levels of the texture */
+		uint32_t mLevels = 1;
+		/** Whether the texture is a 2D texture with a single layer and face; only such textures are packed */
+		bool mPackable = false;
+		/** Whether all usages of the texture clamp to the edge; only such textures are packed into atlases, see texture_packing_config */
+		bool mClampsToEdge = false;
+	};
+
+	/** The position of a texture in an atlas */
+	struct texture_atlas_placement
+	{
+		/** The index of the texture in the candidates passed to plan_texture_packing */
+		size_t mCandidate;
+		/** The position of the texture's first texel in the atlas, i.e. inside its padding */
+		uint32_t mX;
+		uint32_t mY;
+	};
+
+	/** A texture atlas, planned by plan_texture_packing */
+	struct texture_atlas_plan
+	{
+		vk::Format mFormat;
+		vk::Extent3D mExtent;
+		/** The number of MIP levels which can be sampled without blending neighboring textures */
+		uint32_t mLevels = 1;
+		/** The padding around every texture, in texels */
+		uint32_t mPadding = 0;
+		std::vector<texture_atlas_placement> mPlacements;
+	};
+
+	/** A 2D array texture, planned by plan_texture_packing */
+	struct texture_array_plan
+	{
+		/** The indices of the textures in the candidates passed to plan_texture_packing, in the order of their layers */
+		std::vector<size_t> mCandidates;
+	};
+
+	/** Which textures are packed into atlases and array textures, and which ones are not packed */
+	struct texture_packing_plan
+	{
+		std::vector<texture_atlas_plan> mAtlases;
+		std::vector<texture_array_plan> mArrays;
+		/** The indices of the candidates which are not packed */
+		std::vector<size_t> mUnpacked;
+	};
+
+	/** Plans how textures are packed into atlases and array textures.
+	 *	Atlases are filled with shelves of textures, sorted by height. An atlas is only created if it contains at least
+	 *	two textures. The remaining textures are grouped into array textures if aConfig.mMinArrayLayers is set.
+	 *	@param	aCandidates		The textures to pack
+	 *	@param	aConfig			Which textures are packed, and how
+	 *	@returns				The atlases and array textures, each of which contains at least two textures, and the textures which are not packed
+	 */
+	texture_packing_plan plan_texture_packing(std::span<const texture_packing_candidate> aCandidates, const texture_packing_config& aConfig);
+
+	/** Transforms the offset and tiling of a texture such that it addresses the texture's area in an atlas.
+	 *	Texture coordinates are transformed like `uv * tiling + offset` in shaders, see material_gpu_data. The result addresses
+	 *	the texture's area only for coordinates within [0, 1] (plus the padding), since they are not clamped to the area.
+	 *	@param	aOffsetTiling	The offset (xy) and tiling (zw) of the texture
+	 *	@param	aAtlas			The atlas
+	 *	@param	aPlacement		The position of the texture in the atlas
+	 *	@param	aTextureExtent	The extent of the texture
+	 *	@returns				The offset (xy) and tiling (zw) which address the texture in the atlas
+	 */
+	glm::vec4 atlas_offset_tiling(const glm::vec4& aOffsetTiling, const texture_atlas_plan& aAtlas, const texture_atlas_placement& aPlacement, vk::Extent3D aTextureExtent);
+
+	/** Creates an atlas on the GPU and uploads the textures into it, with padding which repeats their edge texels.
+	 *	Only the textures' first levels are uploaded, the atlas' MIP levels are generated on the GPU.
+	 *	@param	aAtlas			The atlas
+	 *	@param	aTextures		All candidates passed to plan_texture_packing
+	 *	@param	aImageUsage		The usage of the atlas. If it is not avk::image_usage::mip_mapped, the atlas has only one level.
+	 *	@param	aSyncHandler	How to synchronize the upload
+	 */
+	avk::image create_texture_atlas(const texture_atlas_plan& aAtlas, std::span<image_data> aTextures, avk::image_usage aImageUsage, avk::sync aSyncHandler);
+
+	/** Creates a 2D array texture on the GPU and uploads the textures into its layers, including their MIP levels.
+	 *	@param	aArray			The array texture
+	 *	@param	aTextures		All candidates passed to plan_texture_packing
+	 *	@param	aImageUsage		The usage of the array texture
+	 *	@param	aSyncHandler	How to synchronize the upload
+	 */
+	avk::image create_texture_array(const texture_array_plan& aArray, std::span<image_data> aTextures, avk::image_usage aImageUsage, avk::sync aSyncHandler);
+
+	/** Encodes the index of an image sampler of a 2D array texture and a layer into a texture index of material_gpu_data.
+	 *	The image samplers of array textures are returned separately from the other image samplers by convert_for_gpu_usage,
+	 *	i.e. they have an index space of their own. Shaders decode texture indices like follows, where the layer is negative for
+	 *	textures which are not packed into an array:
+	 *
+	 *		layout(set = 0, binding = 0) uniform sampler2D textures[];
+	 *		layout(set = 0, binding = 1) uniform sampler2DArray arrayTextures[];
+	 *
+	 *		vec4 sampleMaterialTexture(int texIndex, vec2 uv)
+	 *		{
+	 *			int layer = (texIndex >> 16) - 1;
+	 *			if (layer < 0) {
+	 *				return texture(textures[nonuniformEXT(texIndex)], uv);
+	 *			}
+	 *			return texture(arrayTextures[nonuniformEXT(texIndex & 0xFFFF)], vec3(uv, float(layer)));
+	 *		}
+	 *
+	 *	@param	aImageSamplerIndex	The index of the image sampler among the image samplers of array textures, which must be less than 65536
+	 *	@param	aLayer				The layer, which must be less than 32767
+	 */
+	inline int32_t array_texture_index(uint32_t aImageSamplerIndex, uint32_t aLayer)
+	{
+		assert(aImageSamplerIndex < 0x10000u);
+		assert(aLayer < 0x7FFFu);
+		return static_cast<int32_t>(aImageSamplerIndex | ((aLayer + 1u) << 16));
+	}
+
+	/** Whether the image sampler samples a 2D array texture, which has to be bound to a sampler2DArray in shaders */
+	inline bool is_array_texture(const avk::image_sampler_t& aImageSampler)
+	{
+		return vk::ImageViewType::e2DArray == aImageSampler.get_image_view()->create_info().viewType;
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Statistics of a texture_registry */
+	struct texture_registry_statistics
+	{
+		/** The number of textures in the registry */
+		size_t mNumTextures = 0;
+		/** The number of image_views handed out by the registry which are still alive, i.e. the references held outside of the registry */
+		size_t mNumReferences = 0;
+		/** The GPU memory of all textures in the registry, in bytes */
+		size_t mRegisteredBytes = 0;
+		/** The number of textures which have been taken from the registry instead of being loaded again */
+		size_t mNumHits = 0;
+		/** The sum of the sizes of all textures which have been taken from the registry instead of being decoded and uploaded again, in bytes */
+		size_t mBytesSaved = 0;
+	};
+
+	/** Shares the images of textures between everything that loads them, e.g. models and scenes which are converted separately.
+	 *
+	 *	Textures are identified by a hash of their file contents and of all the parameters which influence the resulting image
+	 *	(see texture_registry::key), so that identical textures are deduplicated even if they are stored in files with different
+	 *	names. The registry hands out avk::image_views with shared ownership: An image stays alive as long as any image_view
+	 *	referencing it is alive, and release_unused() removes the textures which are only referenced by the registry anymore.
+	 *
+	 *	All methods can be invoked from multiple threads. A process-wide registry is provided by global_texture_registry().
+	 */
+	class texture_registry
+	{
+	public:
+		texture_registry() = default;
+		texture_registry(texture_registry&&) noexcept = delete;
+		texture_registry(const texture_registry&) = delete;
+		texture_registry& operator=(texture_registry&&) noexcept = delete;
+		texture_registry& operator=(const texture_registry&) = delete;
+		~texture_registry() = default;
+
+		/** Computes the key of a texture loaded from a file. The file's contents are hashed, i.e. the whole file is read, unless
+		 *	it has been hashed by this registry before and its last modification time and size have not changed since.
+		 *	The parameters correspond to those of get_image_data and create_image_from_image_data_cached.
+		 *	@param	aPath								Path to the texture file
+		 *	@param	aLoadSrgbIfApplicable				Whether the texture is loaded in an sRGB format
+		 *	@param	aFlip								Whether the texture is flipped vertically
+		 *	@param	aPreferredNumberOfTextureComponents	The number of components which the texture is loaded with
+		 *	@param	aImageUsage							The usage of the texture's image, which also decides whether it has MIP-maps
+		 *	@param	aCompression						The block compression which is applied to the texture before it is uploaded
+		 *	@param	aMaxExtent							The maximum extent to which the texture's resolution is reduced, see image_data::downscale
+		 */
+		uint64_t key(const std::string& aPath, bool aLoadSrgbIfApplicable, bool aFlip, int aPreferredNumberOfTextureComponents, avk::image_usage aImageUsage, texture_compression aCompression = texture_compression::none, std::optional<uint32_t> aMaxExtent = {});
+
+		/** Returns a shared image_view of the texture with the given key, if it is in the registry.
+		 *	Every returned image_view counts as a hit, and the size of the texture is added to the saved bytes.
+		 */
+		std::optional<avk::image_view> acquire(uint64_t aKey);
+
+		/** Adds a texture to the registry, unless there already is one with the same key.
+		 *	@param	aKey		The key of the texture, see key()
+		 *	@param	aImageView	The image_view of the texture. Shared ownership is enabled for it.
+		 *	@param	aSize		The GPU memory of the texture, in bytes
+		 *	@returns			A shared image_view of the texture in the registry, which is aImageView if there was none with the same key
+		 */
+		avk::image_view add(uint64_t aKey, avk::image_view aImageView, size_t aSize);
+
+		/** Removes the textures which are not referenced outside of the registry anymore.
+		 *	@returns	The GPU memory of the removed textures, in bytes
+		 */
+		size_t release_unused();
+
+		/** Removes all textures from the registry. Textures which are still referenced elsewhere stay alive until their last image_view is destroyed. */
+		void clear();
+
+		/** The current statistics */
+		texture_registry_statistics statistics() const;
+
+	private:
+		struct registered_texture
+		{
+			avk::image_view mImageView;
+			size_t mSize;
+		};
+
+		struct file_hash
+		{
+			std::filesystem::file_time_type mLastWriteTime;
+			uintmax_t mSize;
+			uint64_t mHash;
+		};
+
+		/** The hash of a file's contents, which is taken from mFileHashes if the file has not changed */
+		uint64_t file_contents_hash(const std::string& aPath);
+
+		/** The number of image_views referencing a texture outside of the registry */
+		static size_t references_outside(const registered_texture& aTexture);
+
+		mutable std::mutex mMutex;
+		std::unordered_map<uint64_t, registered_texture> mTextures;
+		std::unordered_map<std::string, file_hash> mFileHashes;
+		size_t mNumHits = 0;
+		size_t mBytesSaved = 0;
+	};
+
+	/** The process-wide texture registry */
+	inline texture_registry& global_texture_registry()
+	{
+		// The registry destroys images => the context must be destroyed after it, i.e. constructed before it:
+		context();
+		static texture_registry sTextureRegistry;
+		return sTextureRegistry;
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Limits the resolution of textures when they are loaded, e.g. to use the same assets on machines with less GPU memory.
+	 *	Textures which exceed their maximum extent are reduced in resolution on the CPU, see image_data::downscale: The finest
+	 *	levels are dropped from files which contain MIP-map chains, other textures are resampled.
+	 */
+	struct texture_resolution_policy
+	{
+		/** The maximum width and height of diffuse, specular, ambient, emissive, reflection, lightmap, and extra textures */
+		std::optional<uint32_t> mMaxColorTextureExtent;
+
+		/** The maximum width and height of normal maps */
+		std::optional<uint32_t> mMaxNormalMapExtent;
+
+		/** The maximum width and height of height, shininess, opacity, and displacement textures */
+		std::optional<uint32_t> mMaxMaskExtent;
+
+		/** If set, the maximum extent of all textures is halved until their estimated GPU memory fits into this budget, in bytes */
+		std::optional<size_t> mMemoryBudget;
+
+		/** The memory budget does not reduce the maximum extent below this one */
+		uint32_t mMinExtent = 128;
+
+		/** The filter for resampling textures which do not contain MIP-map chains */
+		mip_filter mFilter = mip_filter::kaiser;
+	};
+
+	/** A texture whose resolution is chosen by fit_texture_resolutions */
+	struct texture_resolution_request
+	{
+		/** The extent of the texture in full resolution, see query_image_extent */
+		vk::Extent3D mExtent;
+		/** The maximum width and height of the texture, e.g. from the material slot it is used in */
+		std::optional<uint32_t> mMaxExtent;
+		/** The GPU memory which one texel occupies, e.g. 4 for RGBA8 textures, or 1 for BC7-compressed textures */
+		float mBytesPerTexel = 4.0f;
+	};
+
+	/** Chooses the maximum extents of textures such that all of them together fit into a memory budget.
+	 *	The maximum extent is halved for all textures at once, i.e. the largest textures are reduced first, until the estimated
+	 *	GPU memory of all textures fits into the budget, or until the minimum extent is reached.
+	 *	@param	aTextures		The textures with their individual maximum extents
+	 *	@param	aMemoryBudget	The budget for all textures, in bytes. If not set, only the individual maximum extents are applied.
+	 *	@param	aMinExtent		The budget does not reduce the maximum extent below this one
+	 *	@param	aMipMapped		Whether the textures have MIP-map chains, which take a third more memory
+	 *	@returns				The maximum extent of every texture, which has no value if the texture is used in full resolution
+	 */
+	std::vector<std::optional<uint32_t>> fit_texture_resolutions(std::span<const texture_resolution_request> aTextures, std::optional<size_t> aMemoryBudget, uint32_t aMinExtent, bool aMipMapped);
+
+	/** The GPU memory which one texel of a texture with the given compression occupies, assuming RGBA8 textures if uncompressed */
+	float bytes_per_texel(texture_compression aCompression);
+}
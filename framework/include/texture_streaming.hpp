@@ -0,0 +1,137 @@
+#pragma once
+#include <gvk.hpp>
+
+namespace gvk
+{
+	/** Configuration of a texture_streamer */
+	struct texture_streaming_config
+	{
+		/** The GPU memory which the resident levels of all streamed textures may occupy, in bytes.
+		 *	The coarse tails of the textures are always resident, even if they exceed the budget.
+		 */
+		size_t mResidencyBudget = size_t{ 512 } * 1024 * 1024;
+
+		/** Levels whose width and height do not exceed this extent form the coarse tail of a texture.
+		 *	The tail is uploaded when a texture is added, and it is never evicted.
+		 */
+		uint32_t mTailExtent = 128;
+
+		/** The maximum number of bytes which are uploaded during one update. At least one texture is updated per update, though. */
+		size_t mMaxUploadBytesPerUpdate = size_t{ 32 } * 1024 * 1024;
+
+		/** The number of updates after which a texture whose screen coverage has not been reported is considered invisible */
+		uint32_t mCoverageRetentionUpdates = 60;
+
+		/** Shifts the levels which are requested for a given screen coverage. Positive values request coarser levels. */
+		float mLevelBias = 0.0f;
+	};
+
+	/** Streams the MIP-map levels of textures to the GPU, depending on how much of the screen they cover.
+	 *
+	 *	When a texture is added, only the coarse tail of its MIP-map chain is uploaded. The finer levels are uploaded during
+	 *	later calls to update(), which do not wait for the uploads to complete. Textures which cover more of the screen are
+	 *	served first. Whenever the resident levels of all textures would exceed the residency budget, the finest levels of the
+	 *	textures with the lowest screen coverage are evicted.
+	 *
+	 *	The image of a streamed texture contains only its resident levels, so that evicting levels actually frees GPU memory.
+	 *	Whenever levels are uploaded or evicted, the texture gets a new image and image_sampler, into which the levels that stay
+	 *	resident are copied on the GPU, i.e. only newly resident levels are uploaded. Therefore, image_sampler()
+	 *	must be queried again after every update, e.g. when descriptor bindings are assembled for a frame. Previous images
+	 *	are kept alive until the frame in which they have been replaced has been rendered.
+	 *
+	 *	The texture_streamer can be added to a composition to have update() invoked every frame, or update() can be called manually.
+	 *	Uploads are submitted with their lifetime handled by the main window.
+	 */
+	class texture_streamer : public invokee
+	{
+	public:
+		/** @param	aConfig	The budgets and the mapping of screen coverage to levels */
+		explicit texture_streamer(texture_streaming_config aConfig = {});
+
+		texture_streamer(texture_streamer&&) noexcept = delete;
+		texture_streamer(const texture_streamer&) = delete;
+		texture_streamer& operator=(texture_streamer&&) noexcept = delete;
+		texture_streamer& operator=(const texture_streamer&) = delete;
+		~texture_streamer() override = default;
+
+		/** Adds a 2D texture and uploads the coarse tail of its MIP-map chain.
+		 *	The image data is loaded if it has not been loaded yet, and its MIP-map chain is generated on the CPU if it has none.
+		 *	If the image data has only one level (e.g. because MIP-maps cannot be generated for its format), it is uploaded completely and never streamed.
+		 *	All levels are kept in CPU memory, so that evicted levels can be streamed in again.
+		 *	@param	aImageData	The image data of the texture. Cubemaps and texture arrays are not supported.
+		 *	@param	aSampler	The sampler for the texture, which is used for all of its image_samplers
+		 *	@param	aImageUsage	The usage of the texture's images, to which transfer_source is added
+		 *	@returns			The index of the texture, to refer to it in the other methods
+		 */
+		size_t add_texture(image_data aImageData, avk::sampler aSampler, avk::image_usage aImageUsage = avk::image_usage::general_texture);
+
+		/** Reports how much of the screen a texture covers in the current frame. If it is reported multiple times during a frame, the largest value counts.
+		 *	The level which is requested for the texture is the one whose number of texels best matches the covered pixels.
+		 *	@param	aTexture		The index of the texture, as returned by add_texture
+		 *	@param	aCoveredPixels	The (approximate) number of pixels covered by surfaces which use the texture
+		 */
+		void report_screen_coverage(size_t aTexture, float aCoveredPixels);
+
+		/** Uploads the levels requested by the reported screen coverages, and evicts levels to stay within the residency budget.
+		 *	Resets the reported screen coverages for the next frame.
+		 */
+		void update() override;
+
+		/** The current image_sampler of a texture, which refers to an image containing only the resident levels.
+		 *	It is replaced whenever update() changes the resident levels of the texture.
+		 */
+		const avk::image_sampler& image_sampler(size_t aTexture) const { return mTextures[aTexture].mImageSampler; }
+
+		/** The finest level of a texture which is resident on the GPU, i.e. level 0 of its current image */
+		uint32_t first_resident_level(size_t aTexture) const { return mTextures[aTexture].mFirstResidentLevel; }
+
+		/** The finest level of a texture which is requested by its reported screen coverage */
+		uint32_t requested_level(size_t aTexture) const;
+
+		/** The number of streamed textures */
+		size_t number_of_textures() const { return mTextures.size(); }
+
+		/** The GPU memory which the resident levels of all textures occupy, in bytes */
+		size_t resident_bytes() const { return mResidentBytes; }
+
+		/** The configuration */
+		const texture_streaming_config& config() const { return mConfig; }
+
+		/** Changes the configuration. A lower residency budget leads to evictions during the next update. */
+		void set_config(texture_streaming_config aConfig) { mConfig = aConfig; }
+
+	private:
+		struct streamed_texture
+		{
+			image_data mImageData;
+			avk::sampler mSampler;
+			avk::image_usage mImageUsage;
+			avk::image_sampler mImageSampler;
+			/** Sizes of all levels, in bytes */
+			std::vector<size_t> mLevelSizes;
+			/** The coarsest level which can be evicted, i.e. the finest level of the tail */
+			uint32_t mTailLevel = 0;
+			uint32_t mFirstResidentLevel = 0;
+			float mCoveredPixels = 0.0f;
+			uint32_t mUpdatesSinceReport = 0;
+		};
+
+		/** The GPU memory occupied by a texture if the given level is its finest resident level */
+		static size_t bytes_from_level(const streamed_texture& aTexture, uint32_t aFirstLevel);
+
+		/** Creates a new image which contains the levels from aFirstLevel on, and replaces the texture's image_sampler.
+		 *	The levels which have been resident before are copied from the previous image, only the others are uploaded.
+		 *	@returns	The number of bytes which have been uploaded
+		 */
+		size_t make_resident_from_level(streamed_texture& aTexture, uint32_t aFirstLevel);
+
+		/** Evicts the finest levels of textures with a lower screen coverage than aCoveredPixels, until aBytes more bytes fit into the budget.
+		 *	@returns	True if enough memory could be freed
+		 */
+		bool make_room(size_t aBytes, float aCoveredPixels, const streamed_texture* aExcluded);
+
+		texture_streaming_config mConfig;
+		std::vector<streamed_texture> mTextures;
+		size_t mResidentBytes = 0;
+	};
+}
@@ -0,0 +1,175 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	async_file_streambuf::async_file_streambuf(std::string_view aPath, size_t aChunkSize, size_t aMaxBytesInFlight)
+		: mPath{ aPath }
+		, mFile{ mPath, std::ios::out | std::ios::binary | std::ios::trunc }
+		, mChunkSize{ std::max(aChunkSize, size_t{ 1 }) }
+		, mMaxBytesInFlight{ std::max(aMaxBytesInFlight, mChunkSize) }
+	{
+		if (!mFile.is_open()) {
+			throw gvk::runtime_error(fmt::format("Unable to open file '{}' for writing.", mPath));
+		}
+		start_new_chunk();
+		mWriterThread = std::thread([this]() { write_chunks(); });
+	}
+
+	async_file_streambuf::~async_file_streambuf()
+	{
+		if (0 != sync()) {
+			LOG_ERROR(fmt::format("Not all data could be written to file '{}'.", mPath));
+		}
+		{
+			std::scoped_lock lock(mMutex);
+			mStop = true;
+		}
+		mChunkSubmitted.notify_all();
+		mWriterThread.join();
+	}
+
+	async_file_streambuf::int_type async_file_streambuf::overflow(int_type aChar)
+	{
+		const bool submitted = submit_current_chunk();
+		start_new_chunk();
+		if (!submitted) {
+			return traits_type::eof();
+		}
+		if (traits_type::eq_int_type(aChar, traits_type::eof())) {
+			return traits_type::not_eof(aChar);
+		}
+		*pptr() = traits_type::to_char_type(aChar);
+		pbump(1);
+		return aChar;
+	}
+
+	std::streamsize async_file_streambuf::xsputn(const char* aData, std::streamsize aCount)
+	{
+		const auto count = static_cast<size_t>(aCount);
+		if (count >= mMaxBytesInFlight) {
+			// A block which exceeds the whole budget could not be written in parallel anyway => write it directly, without copying it
+			const bool submitted = submit_current_chunk();
+			start_new_chunk();
+			if (!submitted) {
+				return 0;
+			}
+			std::unique_lock lock(mMutex);
+			mChunkWritten.wait(lock, [this]() { return 0 == mBytesInFlight; });
+			// The writer thread is idle now, and only this thread hands over chunks => it is safe to access mFile:
+			mFile.write(aData, aCount);
+			if (!mFile.good()) {
+				mFailed = true;
+				LOG_ERROR(fmt::format("Writing to file '{}' failed.", mPath));
+				return 0;
+			}
+			return aCount;
+		}
+
+		// Everything else is copied into chunks, which are recycled once they have been written:
+		size_t written = 0;
+		while (written < count) {
+			const auto available = static_cast<size_t>(epptr() - pptr());
+			if (0 == available) {
+				const bool submitted = submit_current_chunk();
+				start_new_chunk();
+				if (!submitted) {
+					break;
+				}
+				continue;
+			}
+			const auto n = std::min(available, count - written);
+			std::memcpy(pptr(), aData + written, n);
+			pbump(static_cast<int>(n));
+			written += n;
+		}
+		return static_cast<std::streamsize>(written);
+	}
+
+	int async_file_streambuf::sync()
+	{
+		submit_current_chunk();
+		start_new_chunk();
+
+		std::unique_lock lock(mMutex);
+		mChunkWritten.wait(lock, [this]() { return 0 == mBytesInFlight; });
+		// The writer thread is idle now, it is safe to access mFile:
+		mFile.flush();
+		if (!mFile.good()) {
+			mFailed = true;
+		}
+		return mFailed ? -1 : 0;
+	}
+
+	void async_file_streambuf::start_new_chunk()
+	{
+		{
+			std::scoped_lock lock(mMutex);
+			if (!mRecycledChunks.empty()) {
+				mCurrentChunk = std::move(mRecycledChunks.back());
+				mRecycledChunks.pop_back();
+			}
+		}
+		mCurrentChunk.resize(mChunkSize);
+		setp(mCurrentChunk.data(), mCurrentChunk.data() + mCurrentChunk.size());
+	}
+
+	bool async_file_streambuf::submit_current_chunk()
+	{
+		const auto size = static_cast<size_t>(pptr() - pbase());
+		setp(nullptr, nullptr);
+		if (0 == size) {
+			return true;
+		}
+		mCurrentChunk.resize(size);
+		const bool submitted = submit(std::move(mCurrentChunk));
+		mCurrentChunk = {};
+		return submitted;
+	}
+
+	bool async_file_streambuf::submit(std::vector<char>&& aChunk)
+	{
+		const auto size = aChunk.size();
+		{
+			std::unique_lock lock(mMutex);
+			// Wait until the budget allows to hand over the chunk. A chunk larger than the budget is handed over when everything else has been written.
+			mChunkWritten.wait(lock, [this, size]() { return 0 == mBytesInFlight || mBytesInFlight + size <= mMaxBytesInFlight; });
+			if (mFailed) {
+				return false;
+			}
+			mBytesInFlight += size;
+			mPendingChunks.push_back(std::move(aChunk));
+		}
+		mChunkSubmitted.notify_one();
+		return true;
+	}
+
+	void async_file_streambuf::write_chunks()
+	{
+		std::unique_lock lock(mMutex);
+		while (true) {
+			mChunkSubmitted.wait(lock, [this]() { return mStop || !mPendingChunks.empty(); });
+			if (mPendingChunks.empty()) {
+				return; // => mStop
+			}
+			auto chunk = std::move(mPendingChunks.front());
+			mPendingChunks.pop_front();
+
+			lock.unlock();
+			mFile.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+			const bool failed = !mFile.good();
+			lock.lock();
+
+			if (failed && !mFailed) {
+				mFailed = true;
+				LOG_ERROR(fmt::format("Writing to file '{}' failed.", mPath));
+			}
+			mBytesInFlight -= chunk.size();
+			// Keep as many chunks of the regular size around as can be in flight, to avoid reallocating them over and over again:
+			if (chunk.capacity() == mChunkSize && mRecycledChunks.size() < std::max(mMaxBytesInFlight / mChunkSize, size_t{ 1 })) {
+				chunk.clear();
+				mRecycledChunks.push_back(std::move(chunk));
+			}
+			mChunkWritten.notify_all();
+		}
+	}
+}
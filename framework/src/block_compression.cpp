@@ -0,0 +1,1148 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	namespace
+	{
+		// LZ4 block format constants
+		constexpr size_t sMinMatch = 4;
+		constexpr size_t sLastLiterals = 5;     // The last 5 bytes are always literals
+		constexpr size_t sMatchSearchLimit = 12; // The last match must start at least 12 bytes before the end
+		constexpr size_t sMaxOffset = 65535;
+		constexpr int sHashBits = 16;
+
+		// Frame header: size of the uncompressed chunk, and size of the stored data, whose highest bit marks uncompressed chunks
+		constexpr size_t sFrameHeaderSize = 2 * sizeof(uint32_t);
+		constexpr uint32_t sUncompressedFlag = 0x80000000u;
+
+		uint32_t read32(const uint8_t* aPtr)
+		{
+			uint32_t value;
+			std::memcpy(&value, aPtr, sizeof(value));
+			return value;
+		}
+
+		uint32_t hash_sequence(uint32_t aSequence)
+		{
+			return (aSequence * 2654435761u) >> (32 - sHashBits);
+		}
+
+		// Writes a length which does not fit into the 4 bits of the token
+		uint8_t* write_length(uint8_t* aOut, size_t aLength)
+		{
+			for (; aLength >= 255; aLength -= 255) {
+				*aOut++ = 255;
+			}
+			*aOut++ = static_cast<uint8_t>(aLength);
+			return aOut;
+		}
+
+		struct frame
+		{
+			size_t mSourceOffset;
+			size_t mStoredSize;
+			bool mUncompressed;
+			size_t mTargetOffset;
+			size_t mTargetSize;
+		};
+
+		// Reads the header of the frame at aOffset and advances aOffset to the frame's data
+		frame read_frame_header(std::span<const std::byte> aFrames, size_t& aOffset)
+		{
+			if (aFrames.size() - aOffset < sFrameHeaderSize) {
+				throw gvk::runtime_error("Compressed data is truncated.");
+			}
+			uint32_t rawSize, storedSizeField;
+			std::memcpy(&rawSize, aFrames.data() + aOffset, sizeof(uint32_t));
+			std::memcpy(&storedSizeField, aFrames.data() + aOffset + sizeof(uint32_t), sizeof(uint32_t));
+			const bool uncompressed = 0 != (storedSizeField & sUncompressedFlag);
+			const size_t storedSize = storedSizeField & ~sUncompressedFlag;
+			aOffset += sFrameHeaderSize;
+			if (aFrames.size() - aOffset < storedSize || (uncompressed && storedSize != rawSize)) {
+				throw gvk::runtime_error("Compressed data is truncated.");
+			}
+			return frame{ aOffset, storedSize, uncompressed, 0, rawSize };
+		}
+
+		// Decompresses the data of one frame into aTarget, whose size must be the frame's mTargetSize
+		void decompress_frame(std::span<const std::byte> aFrames, const frame& aFrame, compression_codec aCodec, std::span<std::byte> aTarget)
+		{
+			const auto source = aFrames.subspan(aFrame.mSourceOffset, aFrame.mStoredSize);
+			if (aFrame.mUncompressed) {
+				std::memcpy(aTarget.data(), source.data(), source.size());
+			}
+			else if (compression_codec::lz4 == aCodec) {
+				lz4_decompress(source, aTarget);
+			}
+			else {
+				throw gvk::runtime_error(fmt::format("Unsupported compression codec {}.", static_cast<uint32_t>(aCodec)));
+			}
+		}
+
+		// Compresses one chunk into aOut as a frame, and returns the frame's size
+		size_t write_frame(std::span<const std::byte> aChunk, compression_codec aCodec, std::byte* aOut)
+		{
+			const auto rawSize = static_cast<uint32_t>(aChunk.size());
+			size_t storedSize = 0;
+			if (compression_codec::lz4 == aCodec) {
+				storedSize = lz4_compress(aChunk, std::span<std::byte>(aOut + sFrameHeaderSize, aChunk.size()));
+			}
+			uint32_t storedSizeField = static_cast<uint32_t>(storedSize);
+			if (0 == storedSize || storedSize >= aChunk.size()) {
+				// Not worth it => store as is
+				std::memcpy(aOut + sFrameHeaderSize, aChunk.data(), aChunk.size());
+				storedSize = aChunk.size();
+				storedSizeField = rawSize | sUncompressedFlag;
+			}
+			std::memcpy(aOut, &rawSize, sizeof(uint32_t));
+			std::memcpy(aOut + sizeof(uint32_t), &storedSizeField, sizeof(uint32_t));
+			return sFrameHeaderSize + storedSize;
+		}
+	}
+
+	size_t lz4_compress(std::span<const std::byte> aSource, std::span<std::byte> aDestination)
+	{
+		const auto* src = reinterpret_cast<const uint8_t*>(aSource.data());
+		const size_t n = aSource.size();
+		auto* out = reinterpret_cast<uint8_t*>(aDestination.data());
+		auto* const outEnd = out + aDestination.size();
+
+		auto emit = [&](size_t aLiteralsBegin, size_t aLiteralsEnd, size_t aOffset, size_t aMatchLength) -> bool {
+			const size_t literals = aLiteralsEnd - aLiteralsBegin;
+			// Worst case size of this sequence:
+			if (static_cast<size_t>(outEnd - out) < 1 + literals / 255 + 1 + literals + 2 + aMatchLength / 255 + 1) {
+				return false;
+			}
+			auto* token = out++;
+			*token = static_cast<uint8_t>(std::min<size_t>(literals, 15) << 4);
+			if (literals >= 15) {
+				out = write_length(out, literals - 15);
+			}
+			std::memcpy(out, src + aLiteralsBegin, literals);
+			out += literals;
+			if (0 == aMatchLength) {
+				return true; // The last sequence consists of literals only
+			}
+			*out++ = static_cast<uint8_t>(aOffset & 0xFF);
+			*out++ = static_cast<uint8_t>(aOffset >> 8);
+			const size_t matchCode = aMatchLength - sMinMatch;
+			*token |= static_cast<uint8_t>(std::min<size_t>(matchCode, 15));
+			if (matchCode >= 15) {
+				out = write_length(out, matchCode - 15);
+			}
+			return true;
+		};
+
+		size_t anchor = 0;
+		if (n > sMatchSearchLimit) {
+			// Positions + 1 of the last occurrence of every hashed 4-byte sequence, 0 means none
+			std::vector<uint32_t> table(size_t{ 1 } << sHashBits, 0);
+			const size_t searchLimit = n - sMatchSearchLimit;
+			const size_t matchLimit = n - sLastLiterals;
+			size_t ip = 0;
+			while (ip < searchLimit) {
+				const uint32_t sequence = read32(src + ip);
+				auto& entry = table[hash_sequence(sequence)];
+				const size_t candidate = entry;
+				entry = static_cast<uint32_t>(ip + 1);
+				if (0 == candidate || ip - (candidate - 1) > sMaxOffset || read32(src + candidate - 1) != sequence) {
+					// Skip faster through data which does not compress
+					ip += 1 + ((ip - anchor) >> 6);
+					continue;
+				}
+				const size_t ref = candidate - 1;
+				size_t matchLength = sMinMatch;
+				while (ip + matchLength < matchLimit && src[ref + matchLength] == src[ip + matchLength]) {
+					++matchLength;
+				}
+				if (!emit(anchor, ip, ip - ref, matchLength)) {
+					return 0;
+				}
+				ip += matchLength;
+				anchor = ip;
+				if (ip - 2 < searchLimit) {
+					table[hash_sequence(read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2 + 1);
+				}
+			}
+		}
+		if (!emit(anchor, n, 0, 0)) {
+			return 0;
+		}
+		return static_cast<size_t>(out - reinterpret_cast<uint8_t*>(aDestination.data()));
+	}
+
+	void lz4_decompress(std::span<const std::byte> aSource, std::span<std::byte> aDestination)
+	{
+		const auto* ip = reinterpret_cast<const uint8_t*>(aSource.data());
+		const auto* const ipEnd = ip + aSource.size();
+		auto* const opBegin = reinterpret_cast<uint8_t*>(aDestination.data());
+		auto* op = opBegin;
+		auto* const opEnd = op + aDestination.size();
+
+		auto corrupt = []() {
+			return gvk::runtime_error("Compressed data is corrupt.");
+		};
+		auto read_length = [&](size_t aLength) {
+			if (15 == aLength) {
+				uint8_t b;
+				do {
+					if (ip >= ipEnd) {
+						throw corrupt();
+					}
+					b = *ip++;
+					aLength += b;
+				} while (255 == b);
+			}
+			return aLength;
+		};
+
+		while (true) {
+			if (ip >= ipEnd) {
+				throw corrupt();
+			}
+			const uint8_t token = *ip++;
+			const size_t literals = read_length(token >> 4);
+			if (literals > static_cast<size_t>(ipEnd - ip) || literals > static_cast<size_t>(opEnd - op)) {
+				throw corrupt();
+			}
+			std::memcpy(op, ip, literals);
+			ip += literals;
+			op += literals;
+			if (ip == ipEnd) {
+				break; // The last sequence consists of literals only
+			}
+
+			if (ipEnd - ip < 2) {
+				throw corrupt();
+			}
+			const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+			ip += 2;
+			const size_t matchLength = read_length(token & 0xF) + sMinMatch;
+			if (0 == offset || offset > static_cast<size_t>(op - opBegin) || matchLength > static_cast<size_t>(opEnd - op)) {
+				throw corrupt();
+			}
+			const uint8_t* match = op - offset;
+			if (offset >= matchLength) {
+				std::memcpy(op, match, matchLength);
+				op += matchLength;
+			}
+			else {
+				// Overlapping match, e.g. a repeated pattern
+				for (size_t i = 0; i < matchLength; ++i) {
+					*op++ = *match++;
+				}
+			}
+		}
+
+		if (op != opEnd) {
+			throw gvk::runtime_error(fmt::format("Compressed data decompresses to {} bytes, but {} bytes were expected.", op - opBegin, aDestination.size()));
+		}
+	}
+
+	std::vector<std::byte> compress_chunked(std::span<const std::byte> aData, compression_codec aCodec, size_t aChunkSize)
+	{
+		const size_t numChunks = (aData.size() + aChunkSize - 1) / aChunkSize;
+		// Compress every chunk into its own worst case sized slot, then close the gaps:
+		std::vector<std::byte> result(numChunks * (sFrameHeaderSize + aChunkSize));
+		std::vector<size_t> frameSizes(numChunks);
+		parallel_for(numChunks, [&](size_t i) {
+			const auto chunk = aData.subspan(i * aChunkSize, std::min(aChunkSize, aData.size() - i * aChunkSize));
+			frameSizes[i] = write_frame(chunk, aCodec, result.data() + i * (sFrameHeaderSize + aChunkSize));
+		});
+		size_t size = 0;
+		for (size_t i = 0; i < numChunks; ++i) {
+			std::memmove(result.data() + size, result.data() + i * (sFrameHeaderSize + aChunkSize), frameSizes[i]);
+			size += frameSizes[i];
+		}
+		result.resize(size);
+		return result;
+	}
+
+	std::vector<std::byte> decompress_chunked(std::span<const std::byte> aFrames, compression_codec aCodec)
+	{
+		// Gather all frames first, to know where each chunk ends up:
+		std::vector<frame> frames;
+		size_t offset = 0;
+		size_t totalSize = 0;
+		while (offset < aFrames.size()) {
+			auto& f = frames.emplace_back(read_frame_header(aFrames, offset));
+			f.mTargetOffset = totalSize;
+			offset += f.mStoredSize;
+			totalSize += f.mTargetSize;
+		}
+
+		std::vector<std::byte> result(totalSize);
+		parallel_for(frames.size(), [&](size_t i) {
+			const auto& f = frames[i];
+			decompress_frame(aFrames, f, aCodec, std::span<std::byte>(result.data() + f.mTargetOffset, f.mTargetSize));
+		});
+		return result;
+	}
+
+	compressing_streambuf::compressing_streambuf(std::unique_ptr<std::streambuf> aDestination, compression_codec aCodec, size_t aChunkSize)
+		: mDestination{ std::move(aDestination) }
+		, mCodec{ aCodec }
+		, mChunk(std::max(aChunkSize, size_t{ 1 }))
+		, mCompressed(sFrameHeaderSize + mChunk.size())
+	{
+		setp(mChunk.data(), mChunk.data() + mChunk.size());
+	}
+
+	compressing_streambuf::~compressing_streambuf()
+	{
+		if (!write_chunk()) {
+			LOG_ERROR("Not all compressed data could be written.");
+		}
+		// mDestination writes its remaining data when it is destroyed
+	}
+
+	compressing_streambuf::int_type compressing_streambuf::overflow(int_type aChar)
+	{
+		if (!write_chunk()) {
+			return traits_type::eof();
+		}
+		if (!traits_type::eq_int_type(aChar, traits_type::eof())) {
+			*pptr() = traits_type::to_char_type(aChar);
+			pbump(1);
+		}
+		return traits_type::not_eof(aChar);
+	}
+
+	int compressing_streambuf::sync()
+	{
+		if (!write_chunk()) {
+			return -1;
+		}
+		return mDestination->pubsync();
+	}
+
+	bool compressing_streambuf::write_chunk()
+	{
+		const auto size = static_cast<size_t>(pptr() - pbase());
+		setp(mChunk.data(), mChunk.data() + mChunk.size());
+		if (0 == size) {
+			return true;
+		}
+		const auto chunk = std::as_bytes(std::span<const char>(mChunk.data(), size));
+		const auto frameSize = static_cast<std::streamsize>(write_frame(chunk, mCodec, mCompressed.data()));
+		return frameSize == mDestination->sputn(reinterpret_cast<const char*>(mCompressed.data()), frameSize);
+	}
+
+	decompressing_streambuf::decompressing_streambuf(std::span<const std::byte> aFrames, compression_codec aCodec)
+		: mFrames{ aFrames }
+		, mCodec{ aCodec }
+	{
+		setg(nullptr, nullptr, nullptr);
+	}
+
+	std::span<const std::byte> decompressing_streambuf::view(size_t aSize)
+	{
+		if (egptr() == gptr()) {
+			next_chunk();
+		}
+		if (static_cast<size_t>(egptr() - gptr()) >= aSize) {
+			const auto* begin = reinterpret_cast<const std::byte*>(gptr());
+			setg(eback(), gptr() + aSize, egptr());
+			return std::span<const std::byte>(begin, aSize);
+		}
+		// The memory spans multiple chunks => assemble it:
+		mAssembled.resize(aSize);
+		const auto read = sgetn(reinterpret_cast<char*>(mAssembled.data()), static_cast<std::streamsize>(aSize));
+		if (static_cast<size_t>(read) != aSize) {
+			throw gvk::runtime_error(fmt::format("Attempted to read {} bytes, but only {} bytes remain in the cache file.", aSize, read));
+		}
+		return std::span<const std::byte>(mAssembled);
+	}
+
+	decompressing_streambuf::int_type decompressing_streambuf::underflow()
+	{
+		if (gptr() == egptr() && !next_chunk()) {
+			return traits_type::eof();
+		}
+		return traits_type::to_int_type(*gptr());
+	}
+
+	bool decompressing_streambuf::next_chunk()
+	{
+		if (mOffset >= mFrames.size()) {
+			return false;
+		}
+		const auto f = read_frame_header(mFrames, mOffset);
+		mOffset += f.mStoredSize;
+		if (f.mUncompressed) {
+			// Read uncompressed chunks in place:
+			auto* begin = const_cast<char*>(reinterpret_cast<const char*>(mFrames.data() + f.mSourceOffset));
+			setg(begin, begin, begin + f.mTargetSize);
+			return true;
+		}
+		mChunk.resize(f.mTargetSize);
+		decompress_frame(mFrames, f, mCodec, std::as_writable_bytes(std::span<char>(mChunk)));
+		setg(mChunk.data(), mChunk.data(), mChunk.data() + mChunk.size());
+		return true;
+	}
+
+	namespace
+	{
+		// Zstandard format (RFC 8878) constants
+		constexpr uint32_t sZstdMagic = 0xFD2FB528u;
+		constexpr uint32_t sZstdSkippableMagicMask = 0xFFFFFFF0u;
+		constexpr uint32_t sZstdSkippableMagic = 0x184D2A50u;
+		constexpr size_t sZstdMaxBlockSize = 128 * 1024;
+		constexpr int sZstdMaxHuffmanBits = 11;
+		constexpr int sZstdMaxLiteralsLengthLog = 9;
+		constexpr int sZstdMaxMatchLengthLog = 9;
+		constexpr int sZstdMaxOffsetLog = 8;
+		constexpr size_t sZstdMaxLiteralsLengthCode = 35;
+		constexpr size_t sZstdMaxMatchLengthCode = 52;
+		constexpr size_t sZstdMaxOffsetCode = 31;
+
+		gvk::runtime_error zstd_corrupt()
+		{
+			return gvk::runtime_error("Zstandard compressed data is corrupt.");
+		}
+
+		int highest_bit(uint32_t aValue)
+		{
+			assert(0 != aValue);
+			return std::bit_width(aValue) - 1;
+		}
+
+		// Reads bits from the lowest to the highest bit of a little-endian byte sequence, used for FSE table descriptions
+		class forward_bit_reader
+		{
+		public:
+			explicit forward_bit_reader(std::span<const uint8_t> aData) : mData{ aData } {}
+
+			uint32_t peek(int aCount) const
+			{
+				uint32_t value = 0;
+				for (int i = 0; i < aCount; ++i) {
+					const size_t bit = mBitPos + i;
+					if (bit / 8 < mData.size()) {
+						value |= static_cast<uint32_t>((mData[bit / 8] >> (bit % 8)) & 1) << i;
+					}
+				}
+				return value;
+			}
+
+			void consume(int aCount)
+			{
+				mBitPos += aCount;
+				if ((mBitPos + 7) / 8 > mData.size()) {
+					throw zstd_corrupt();
+				}
+			}
+
+			uint32_t read(int aCount)
+			{
+				const auto value = peek(aCount);
+				consume(aCount);
+				return value;
+			}
+
+			size_t bytes_consumed() const { return (mBitPos + 7) / 8; }
+
+		private:
+			std::span<const uint8_t> mData;
+			size_t mBitPos = 0;
+		};
+
+		// Reads bits from the end to the beginning of a bitstream whose last byte contains a 1-bit end mark.
+		// Used for Huffman-coded literals and for FSE-coded sequences. Bits below the beginning read as zeros,
+		// which decoders are allowed to peek at; whether such bits have been consumed is reported by overflowed().
+		class backward_bit_reader
+		{
+		public:
+			explicit backward_bit_reader(std::span<const uint8_t> aData) : mData{ aData }
+			{
+				if (aData.empty() || 0 == aData.back()) {
+					throw zstd_corrupt();
+				}
+				mBitPos = static_cast<int64_t>(aData.size() - 1) * 8 + highest_bit(aData.back());
+			}
+
+			// Returns the next aCount bits (at most 56) without consuming them
+			uint64_t peek(int aCount) const
+			{
+				if (0 == aCount) {
+					return 0;
+				}
+				const int64_t pos = mBitPos - aCount;
+				const uint64_t mask = (uint64_t{ 1 } << aCount) - 1;
+				if (pos >= 0) {
+					return (load(static_cast<size_t>(pos >> 3)) >> (pos & 7)) & mask;
+				}
+				// Partially before the beginning => fill up with zeros
+				if (-pos >= aCount) {
+					return 0;
+				}
+				return (load(0) << -pos) & mask;
+			}
+
+			// Returns the bits below the current position, with the next bit to read as the highest bit.
+			// At least 57 bits are valid. Requires at least 64 remaining bits.
+			uint64_t peek_high() const
+			{
+				assert(mBitPos >= 64);
+				const int64_t firstByte = ((mBitPos + 7) >> 3) - 8;
+				return load(static_cast<size_t>(firstByte)) << ((firstByte + 8) * 8 - mBitPos);
+			}
+
+			void consume(int aCount) { mBitPos -= aCount; }
+
+			uint64_t read(int aCount)
+			{
+				const auto value = peek(aCount);
+				consume(aCount);
+				return value;
+			}
+
+			int64_t bits_remaining() const { return mBitPos; }
+			bool overflowed() const { return mBitPos < 0; }
+
+		private:
+			uint64_t load(size_t aByte) const
+			{
+				uint64_t value = 0;
+				if (aByte + sizeof(value) <= mData.size()) {
+					std::memcpy(&value, mData.data() + aByte, sizeof(value));
+				}
+				else {
+					std::memcpy(&value, mData.data() + aByte, mData.size() - aByte);
+				}
+				return value;
+			}
+
+			std::span<const uint8_t> mData;
+			int64_t mBitPos;
+		};
+
+		struct fse_entry
+		{
+			uint8_t mSymbol;
+			uint8_t mNumBits;
+			uint16_t mBaseline;
+		};
+
+		struct fse_table
+		{
+			int mAccuracyLog = 0;
+			std::vector<fse_entry> mEntries;
+
+			bool empty() const { return mEntries.empty(); }
+
+			// Sets the initial state from the bitstream
+			uint32_t init_state(backward_bit_reader& aBits) const
+			{
+				return static_cast<uint32_t>(aBits.read(mAccuracyLog));
+			}
+
+			uint32_t next_state(uint32_t aState, backward_bit_reader& aBits) const
+			{
+				const auto& e = mEntries[aState];
+				return e.mBaseline + static_cast<uint32_t>(aBits.read(e.mNumBits));
+			}
+		};
+
+		// Spreads the symbols of a normalized distribution over the states of a decoding table, as specified by the format
+		fse_table build_fse_table(std::span<const int16_t> aDistribution, int aAccuracyLog)
+		{
+			const uint32_t tableSize = 1u << aAccuracyLog;
+			fse_table table{ aAccuracyLog, std::vector<fse_entry>(tableSize) };
+			std::vector<uint32_t> symbolNext(aDistribution.size());
+
+			uint32_t highThreshold = tableSize - 1;
+			for (size_t s = 0; s < aDistribution.size(); ++s) {
+				if (-1 == aDistribution[s]) {
+					table.mEntries[highThreshold--].mSymbol = static_cast<uint8_t>(s);
+					symbolNext[s] = 1;
+				}
+				else {
+					symbolNext[s] = static_cast<uint32_t>(std::max<int16_t>(aDistribution[s], 0));
+				}
+			}
+
+			const uint32_t mask = tableSize - 1;
+			const uint32_t step = (tableSize >> 1) + (tableSize >> 3) + 3;
+			uint32_t position = 0;
+			for (size_t s = 0; s < aDistribution.size(); ++s) {
+				for (int16_t i = 0; i < aDistribution[s]; ++i) {
+					table.mEntries[position].mSymbol = static_cast<uint8_t>(s);
+					do {
+						position = (position + step) & mask;
+					} while (position > highThreshold);
+				}
+			}
+			if (0 != position) {
+				throw zstd_corrupt();
+			}
+
+			for (auto& e : table.mEntries) {
+				const uint32_t next = symbolNext[e.mSymbol]++;
+				e.mNumBits = static_cast<uint8_t>(aAccuracyLog - highest_bit(next));
+				e.mBaseline = static_cast<uint16_t>((next << e.mNumBits) - tableSize);
+			}
+			return table;
+		}
+
+		// Table which always decodes the same symbol, without reading any bits
+		fse_table build_rle_fse_table(uint8_t aSymbol)
+		{
+			return fse_table{ 0, { fse_entry{ aSymbol, 0, 0 } } };
+		}
+
+		// Reads an FSE table description, and returns the table and the number of bytes it occupies
+		std::tuple<fse_table, size_t> read_fse_table(std::span<const uint8_t> aData, int aMaxAccuracyLog, size_t aMaxSymbol)
+		{
+			forward_bit_reader bits(aData);
+			const int accuracyLog = static_cast<int>(bits.read(4)) + 5;
+			if (accuracyLog > aMaxAccuracyLog) {
+				throw zstd_corrupt();
+			}
+
+			std::vector<int16_t> distribution;
+			int32_t remaining = (1 << accuracyLog) + 1;
+			int32_t threshold = 1 << accuracyLog;
+			int numBits = accuracyLog + 1;
+			while (remaining > 1) {
+				if (distribution.size() > aMaxSymbol) {
+					throw zstd_corrupt();
+				}
+				const int32_t max = (2 * threshold - 1) - remaining;
+				int32_t value;
+				if (static_cast<int32_t>(bits.peek(numBits - 1)) < max) {
+					value = static_cast<int32_t>(bits.read(numBits - 1));
+				}
+				else {
+					value = static_cast<int32_t>(bits.read(numBits));
+					if (value >= threshold) {
+						value -= max;
+					}
+				}
+				const int32_t probability = value - 1;
+				remaining -= std::abs(probability);
+				distribution.push_back(static_cast<int16_t>(probability));
+
+				if (0 == probability) {
+					// Followed by the number of further zero probabilities, in 2-bit repeat flags
+					uint32_t repeat;
+					do {
+						repeat = bits.read(2);
+						distribution.insert(std::end(distribution), repeat, int16_t{ 0 });
+					} while (3 == repeat);
+				}
+				while (remaining < threshold && threshold > 1) {
+					--numBits;
+					threshold >>= 1;
+				}
+			}
+			if (1 != remaining || distribution.size() > aMaxSymbol + 1) {
+				throw zstd_corrupt();
+			}
+			return { build_fse_table(distribution, accuracyLog), bits.bytes_consumed() };
+		}
+
+		struct huffman_entry
+		{
+			uint8_t mSymbol;
+			uint8_t mNumBits;
+		};
+
+		struct huffman_table
+		{
+			int mMaxBits = 0;
+			std::vector<huffman_entry> mEntries;
+
+			bool empty() const { return mEntries.empty(); }
+
+			uint8_t decode(backward_bit_reader& aBits) const
+			{
+				const auto& e = mEntries[aBits.peek(mMaxBits)];
+				aBits.consume(e.mNumBits);
+				return e.mSymbol;
+			}
+		};
+
+		// Reads a Huffman tree description, and returns the table and the number of bytes it occupies
+		std::tuple<huffman_table, size_t> read_huffman_table(std::span<const uint8_t> aData)
+		{
+			if (aData.empty()) {
+				throw zstd_corrupt();
+			}
+			std::vector<uint8_t> weights;
+			size_t size;
+			const uint8_t header = aData[0];
+			if (header >= 128) {
+				// Weights stored directly as 4-bit values
+				const size_t count = header - 127u;
+				size = 1 + (count + 1) / 2;
+				if (size > aData.size()) {
+					throw zstd_corrupt();
+				}
+				for (size_t i = 0; i < count; ++i) {
+					const uint8_t b = aData[1 + i / 2];
+					weights.push_back(0 == i % 2 ? b >> 4 : b & 0xF);
+				}
+			}
+			else {
+				// Weights compressed with FSE, with two interleaved states
+				size = 1 + size_t{ header };
+				if (size > aData.size()) {
+					throw zstd_corrupt();
+				}
+				const auto [table, tableSize] = read_fse_table(aData.subspan(1, header), 6, 255);
+				if (tableSize >= header) {
+					throw zstd_corrupt();
+				}
+				backward_bit_reader bits(aData.subspan(1 + tableSize, header - tableSize));
+				uint32_t states[2] = { table.init_state(bits), table.init_state(bits) };
+				for (int s = 0; ; s ^= 1) {
+					if (weights.size() >= 255) {
+						throw zstd_corrupt();
+					}
+					weights.push_back(table.mEntries[states[s]].mSymbol);
+					states[s] = table.next_state(states[s], bits);
+					if (bits.overflowed()) {
+						weights.push_back(table.mEntries[states[s ^ 1]].mSymbol);
+						break;
+					}
+				}
+			}
+
+			// The weight of the last symbol is implied by the others
+			uint32_t total = 0;
+			for (const auto w : weights) {
+				if (w > sZstdMaxHuffmanBits) {
+					throw zstd_corrupt();
+				}
+				total += w > 0 ? 1u << (w - 1) : 0u;
+			}
+			if (0 == total) {
+				throw zstd_corrupt();
+			}
+			const int maxBits = highest_bit(total) + 1;
+			const uint32_t rest = (1u << maxBits) - total;
+			if (maxBits > sZstdMaxHuffmanBits || !std::has_single_bit(rest) || weights.size() >= 256) {
+				throw zstd_corrupt();
+			}
+			weights.push_back(static_cast<uint8_t>(highest_bit(rest) + 1));
+
+			// Codes are assigned in order of increasing weight, and in symbol order for equal weights
+			huffman_table table{ maxBits, std::vector<huffman_entry>(size_t{ 1 } << maxBits) };
+			size_t position = 0;
+			for (int w = 1; w <= maxBits; ++w) {
+				for (size_t s = 0; s < weights.size(); ++s) {
+					if (weights[s] == w) {
+						const size_t count = size_t{ 1 } << (w - 1);
+						std::fill_n(std::begin(table.mEntries) + position, count, huffman_entry{ static_cast<uint8_t>(s), static_cast<uint8_t>(maxBits + 1 - w) });
+						position += count;
+					}
+				}
+			}
+			return { std::move(table), size };
+		}
+
+		void decode_huffman_stream(const huffman_table& aTable, std::span<const uint8_t> aStream, uint8_t* aOut, size_t aCount)
+		{
+			backward_bit_reader bits(aStream);
+			const int shift = 64 - aTable.mMaxBits;
+			size_t i = 0;
+			// Decode four symbols (at most 44 bits) per load while enough bits remain:
+			while (aCount - i >= 4 && bits.bits_remaining() >= 64) {
+				uint64_t window = bits.peek_high();
+				int consumed = 0;
+				for (size_t j = 0; j < 4; ++j) {
+					const auto& e = aTable.mEntries[window >> shift];
+					aOut[i++] = e.mSymbol;
+					window <<= e.mNumBits;
+					consumed += e.mNumBits;
+				}
+				bits.consume(consumed);
+			}
+			for (; i < aCount; ++i) {
+				aOut[i] = aTable.decode(bits);
+			}
+			if (0 != bits.bits_remaining()) {
+				throw zstd_corrupt();
+			}
+		}
+
+		// Baselines and numbers of extra bits of the literals length and match length codes
+		constexpr uint32_t sLiteralsLengthBaselines[36] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768, 65536 };
+		constexpr uint8_t sLiteralsLengthBits[36] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+		constexpr uint32_t sMatchLengthBaselines[53] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+			35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027, 2051, 4099, 8195, 16387, 32771, 65539 };
+		constexpr uint8_t sMatchLengthBits[53] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+
+		// Predefined distributions of the sequence codes
+		constexpr int16_t sDefaultLiteralsLengthDistribution[36] = { 4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1, -1, -1, -1, -1 };
+		constexpr int16_t sDefaultMatchLengthDistribution[53] = { 1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1 };
+		constexpr int16_t sDefaultOffsetDistribution[29] = { 1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1 };
+
+		// State which persists across the blocks of a frame
+		struct zstd_frame_state
+		{
+			huffman_table mHuffman;
+			fse_table mLiteralsLengths;
+			fse_table mOffsets;
+			fse_table mMatchLengths;
+			uint32_t mRepeatedOffsets[3] = { 1, 4, 8 };
+			std::vector<uint8_t> mLiterals = std::vector<uint8_t>(sZstdMaxBlockSize);
+		};
+
+		// Decodes the literals section of a compressed block into aState.mLiterals, and returns the number of literals and the section's size
+		std::tuple<size_t, size_t> decode_literals(std::span<const uint8_t> aBlock, zstd_frame_state& aState)
+		{
+			if (aBlock.empty()) {
+				throw zstd_corrupt();
+			}
+			const uint32_t type = aBlock[0] & 3;
+			const uint32_t sizeFormat = (aBlock[0] >> 2) & 3;
+			auto header_value = [&](size_t aHeaderSize) {
+				if (aHeaderSize > aBlock.size()) {
+					throw zstd_corrupt();
+				}
+				uint64_t value = 0;
+				for (size_t i = 0; i < aHeaderSize; ++i) {
+					value |= static_cast<uint64_t>(aBlock[i]) << (8 * i);
+				}
+				return value;
+			};
+
+			if (type < 2) {
+				// Raw or RLE literals
+				size_t headerSize, count;
+				switch (sizeFormat) {
+				case 1:  headerSize = 2; count = static_cast<size_t>(header_value(2) >> 4); break;
+				case 3:  headerSize = 3; count = static_cast<size_t>(header_value(3) >> 4); break;
+				default: headerSize = 1; count = aBlock[0] >> 3; break;
+				}
+				if (count > sZstdMaxBlockSize) {
+					throw zstd_corrupt();
+				}
+				if (0 == type) {
+					if (headerSize + count > aBlock.size()) {
+						throw zstd_corrupt();
+					}
+					std::memcpy(aState.mLiterals.data(), aBlock.data() + headerSize, count);
+					return { count, headerSize + count };
+				}
+				if (headerSize >= aBlock.size()) {
+					throw zstd_corrupt();
+				}
+				std::fill_n(aState.mLiterals.data(), count, aBlock[headerSize]);
+				return { count, headerSize + 1 };
+			}
+
+			// Huffman-coded literals, in one or four streams
+			const size_t headerSize = sizeFormat < 2 ? 3 : sizeFormat + 2;
+			const int sizeBits = 0 == sizeFormat || 1 == sizeFormat ? 10 : 2 == sizeFormat ? 14 : 18;
+			const bool fourStreams = 0 != sizeFormat;
+			const uint64_t value = header_value(headerSize) >> 4;
+			const size_t count = static_cast<size_t>(value & ((uint64_t{ 1 } << sizeBits) - 1));
+			const size_t compressedSize = static_cast<size_t>(value >> sizeBits);
+			if (count > sZstdMaxBlockSize || headerSize + compressedSize > aBlock.size()) {
+				throw zstd_corrupt();
+			}
+			auto data = aBlock.subspan(headerSize, compressedSize);
+			if (2 == type) {
+				auto [table, tableSize] = read_huffman_table(data);
+				aState.mHuffman = std::move(table);
+				data = data.subspan(tableSize);
+			}
+			else if (aState.mHuffman.empty()) {
+				throw zstd_corrupt(); // Treeless literals without a previous table
+			}
+
+			if (!fourStreams) {
+				decode_huffman_stream(aState.mHuffman, data, aState.mLiterals.data(), count);
+			}
+			else {
+				if (data.size() < 6) {
+					throw zstd_corrupt();
+				}
+				const size_t sizes[3] = { size_t{ data[0] } | (size_t{ data[1] } << 8), size_t{ data[2] } | (size_t{ data[3] } << 8), size_t{ data[4] } | (size_t{ data[5] } << 8) };
+				if (6 + sizes[0] + sizes[1] + sizes[2] > data.size()) {
+					throw zstd_corrupt();
+				}
+				const size_t countPerStream = (count + 3) / 4;
+				if (3 * countPerStream > count) {
+					throw zstd_corrupt();
+				}
+				size_t offset = 6;
+				for (size_t i = 0; i < 4; ++i) {
+					const size_t streamSize = i < 3 ? sizes[i] : data.size() - offset;
+					const size_t streamCount = i < 3 ? countPerStream : count - 3 * countPerStream;
+					decode_huffman_stream(aState.mHuffman, data.subspan(offset, streamSize), aState.mLiterals.data() + i * countPerStream, streamCount);
+					offset += streamSize;
+				}
+			}
+			return { count, headerSize + compressedSize };
+		}
+
+		// Sets up the decoding table of one kind of sequence code, according to its compression mode, and returns the number of bytes read
+		size_t read_sequence_table(uint32_t aMode, std::span<const uint8_t> aData, fse_table& aTable, std::span<const int16_t> aDefaultDistribution, int aDefaultAccuracyLog, int aMaxAccuracyLog, size_t aMaxSymbol)
+		{
+			switch (aMode) {
+			case 0: // Predefined distribution
+				aTable = build_fse_table(aDefaultDistribution, aDefaultAccuracyLog);
+				return 0;
+			case 1: // RLE
+				if (aData.empty() || aData[0] > aMaxSymbol) {
+					throw zstd_corrupt();
+				}
+				aTable = build_rle_fse_table(aData[0]);
+				return 1;
+			case 2: { // FSE compressed
+				auto [table, size] = read_fse_table(aData, aMaxAccuracyLog, aMaxSymbol);
+				aTable = std::move(table);
+				return size;
+			}
+			default: // Repeat the table of the previous block
+				if (aTable.empty()) {
+					throw zstd_corrupt();
+				}
+				return 0;
+			}
+		}
+
+		// Decodes a compressed block, and returns the new output position
+		uint8_t* decode_compressed_block(std::span<const uint8_t> aBlock, zstd_frame_state& aState, const uint8_t* aFrameBegin, uint8_t* aOut, const uint8_t* aOutEnd)
+		{
+			const auto [numLiterals, literalsSize] = decode_literals(aBlock, aState);
+			auto data = aBlock.subspan(literalsSize);
+			const uint8_t* literals = aState.mLiterals.data();
+			const uint8_t* const literalsEnd = literals + numLiterals;
+
+			if (data.empty()) {
+				throw zstd_corrupt();
+			}
+			size_t numSequences = data[0];
+			size_t headerSize = 1;
+			if (255 == data[0]) {
+				headerSize = 3;
+			}
+			else if (data[0] >= 128) {
+				headerSize = 2;
+			}
+			if (headerSize > data.size()) {
+				throw zstd_corrupt();
+			}
+			if (3 == headerSize) {
+				numSequences = size_t{ data[1] } + (size_t{ data[2] } << 8) + 0x7F00;
+			}
+			else if (2 == headerSize) {
+				numSequences = ((numSequences - 128) << 8) + data[1];
+			}
+			data = data.subspan(headerSize);
+
+			if (numSequences > 0) {
+				if (data.empty()) {
+					throw zstd_corrupt();
+				}
+				const uint8_t modes = data[0];
+				data = data.subspan(1);
+				data = data.subspan(read_sequence_table(modes >> 6, data, aState.mLiteralsLengths, sDefaultLiteralsLengthDistribution, 6, sZstdMaxLiteralsLengthLog, sZstdMaxLiteralsLengthCode));
+				data = data.subspan(read_sequence_table((modes >> 4) & 3, data, aState.mOffsets, sDefaultOffsetDistribution, 5, sZstdMaxOffsetLog, sZstdMaxOffsetCode));
+				data = data.subspan(read_sequence_table((modes >> 2) & 3, data, aState.mMatchLengths, sDefaultMatchLengthDistribution, 6, sZstdMaxMatchLengthLog, sZstdMaxMatchLengthCode));
+
+				backward_bit_reader bits(data);
+				auto literalsLengthState = aState.mLiteralsLengths.init_state(bits);
+				auto offsetState = aState.mOffsets.init_state(bits);
+				auto matchLengthState = aState.mMatchLengths.init_state(bits);
+				auto& reps = aState.mRepeatedOffsets;
+
+				for (size_t i = 0; i < numSequences; ++i) {
+					const uint32_t offsetCode = aState.mOffsets.mEntries[offsetState].mSymbol;
+					const uint32_t matchLengthCode = aState.mMatchLengths.mEntries[matchLengthState].mSymbol;
+					const uint32_t literalsLengthCode = aState.mLiteralsLengths.mEntries[literalsLengthState].mSymbol;
+
+					const uint32_t offsetValue = (1u << offsetCode) + static_cast<uint32_t>(bits.read(static_cast<int>(offsetCode)));
+					const size_t matchLength = sMatchLengthBaselines[matchLengthCode] + static_cast<size_t>(bits.read(sMatchLengthBits[matchLengthCode]));
+					const size_t literalsLength = sLiteralsLengthBaselines[literalsLengthCode] + static_cast<size_t>(bits.read(sLiteralsLengthBits[literalsLengthCode]));
+
+					size_t offset;
+					if (offsetValue > 3) {
+						offset = offsetValue - 3;
+						reps[2] = reps[1];
+						reps[1] = reps[0];
+						reps[0] = static_cast<uint32_t>(offset);
+					}
+					else {
+						// Repeated offsets, shifted by one if there are no literals
+						const uint32_t index = offsetValue - 1 + (0 == literalsLength ? 1 : 0);
+						if (0 == index) {
+							offset = reps[0];
+						}
+						else {
+							offset = 3 == index ? reps[0] - 1 : reps[index];
+							if (1 != index) {
+								reps[2] = reps[1];
+							}
+							reps[1] = reps[0];
+							reps[0] = static_cast<uint32_t>(offset);
+						}
+					}
+
+					if (i + 1 < numSequences) {
+						literalsLengthState = aState.mLiteralsLengths.next_state(literalsLengthState, bits);
+						matchLengthState = aState.mMatchLengths.next_state(matchLengthState, bits);
+						offsetState = aState.mOffsets.next_state(offsetState, bits);
+					}
+
+					if (literalsLength > static_cast<size_t>(literalsEnd - literals) || literalsLength + matchLength > static_cast<size_t>(aOutEnd - aOut)) {
+						throw zstd_corrupt();
+					}
+					std::memcpy(aOut, literals, literalsLength);
+					literals += literalsLength;
+					aOut += literalsLength;
+
+					if (0 == offset || offset > static_cast<size_t>(aOut - aFrameBegin)) {
+						throw zstd_corrupt();
+					}
+					const uint8_t* match = aOut - offset;
+					if (offset >= matchLength) {
+						std::memcpy(aOut, match, matchLength);
+						aOut += matchLength;
+					}
+					else {
+						// Overlapping match, e.g. a repeated pattern
+						for (size_t j = 0; j < matchLength; ++j) {
+							*aOut++ = *match++;
+						}
+					}
+				}
+				if (0 != bits.bits_remaining()) {
+					throw zstd_corrupt();
+				}
+			}
+
+			// The remaining literals follow the last sequence
+			const size_t remaining = static_cast<size_t>(literalsEnd - literals);
+			if (remaining > static_cast<size_t>(aOutEnd - aOut)) {
+				throw zstd_corrupt();
+			}
+			std::memcpy(aOut, literals, remaining);
+			return aOut + remaining;
+		}
+	}
+
+	void zstd_decompress(std::span<const std::byte> aSource, std::span<std::byte> aDestination)
+	{
+		const auto source = std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(aSource.data()), aSource.size());
+		auto* const opBegin = reinterpret_cast<uint8_t*>(aDestination.data());
+		auto* op = opBegin;
+		auto* const opEnd = op + aDestination.size();
+
+		size_t ip = 0;
+		auto read_le = [&](size_t aSize) {
+			if (aSize > source.size() - ip) {
+				throw zstd_corrupt();
+			}
+			uint64_t value = 0;
+			for (size_t i = 0; i < aSize; ++i) {
+				value |= static_cast<uint64_t>(source[ip + i]) << (8 * i);
+			}
+			ip += aSize;
+			return value;
+		};
+
+		while (ip < source.size()) {
+			const auto magic = static_cast<uint32_t>(read_le(4));
+			if (sZstdSkippableMagic == (magic & sZstdSkippableMagicMask)) {
+				const auto size = static_cast<size_t>(read_le(4));
+				if (size > source.size() - ip) {
+					throw zstd_corrupt();
+				}
+				ip += size;
+				continue;
+			}
+			if (sZstdMagic != magic) {
+				throw gvk::runtime_error("Data is not in the Zstandard format.");
+			}
+
+			// Frame header
+			const auto descriptor = static_cast<uint8_t>(read_le(1));
+			const uint32_t contentSizeFlag = descriptor >> 6;
+			const bool singleSegment = 0 != (descriptor & 0x20);
+			const bool hasChecksum = 0 != (descriptor & 0x04);
+			const uint32_t dictionaryIdFlag = descriptor & 3;
+			if (0 != (descriptor & 0x08)) {
+				throw zstd_corrupt();
+			}
+			if (!singleSegment) {
+				read_le(1); // The window size is irrelevant, since the whole output is in memory
+			}
+			const size_t dictionaryIdSizes[4] = { 0, 1, 2, 4 };
+			if (0 != read_le(dictionaryIdSizes[dictionaryIdFlag])) {
+				throw gvk::runtime_error("Zstandard compressed data which requires a dictionary is not supported.");
+			}
+			const size_t contentSizeSizes[4] = { size_t{ singleSegment ? 1u : 0u }, 2, 4, 8 };
+			std::optional<uint64_t> contentSize;
+			if (contentSizeSizes[contentSizeFlag] > 0) {
+				contentSize = read_le(contentSizeSizes[contentSizeFlag]) + (1 == contentSizeFlag ? 256 : 0);
+			}
+
+			// Blocks
+			zstd_frame_state state;
+			auto* const frameBegin = op;
+			bool lastBlock = false;
+			while (!lastBlock) {
+				const auto blockHeader = static_cast<uint32_t>(read_le(3));
+				lastBlock = 0 != (blockHeader & 1);
+				const uint32_t blockType = (blockHeader >> 1) & 3;
+				const size_t blockSize = blockHeader >> 3;
+				if (blockSize > sZstdMaxBlockSize) {
+					throw zstd_corrupt();
+				}
+				switch (blockType) {
+				case 0: // Raw
+					if (blockSize > source.size() - ip || blockSize > static_cast<size_t>(opEnd - op)) {
+						throw zstd_corrupt();
+					}
+					if (blockSize > 0) { // Empty data has no destination memory
+						std::memcpy(op, source.data() + ip, blockSize);
+						op += blockSize;
+					}
+					ip += blockSize;
+					break;
+				case 1: // RLE, the block size is the number of repetitions of a single byte
+					if (ip >= source.size() || blockSize > static_cast<size_t>(opEnd - op)) {
+						throw zstd_corrupt();
+					}
+					if (blockSize > 0) {
+						std::memset(op, source[ip], blockSize);
+						op += blockSize;
+					}
+					ip += 1;
+					break;
+				case 2:
+					if (blockSize > source.size() - ip) {
+						throw zstd_corrupt();
+					}
+					op = decode_compressed_block(source.subspan(ip, blockSize), state, frameBegin, op, opEnd);
+					ip += blockSize;
+					break;
+				default:
+					throw zstd_corrupt();
+				}
+			}
+			if (contentSize.has_value() && *contentSize != static_cast<uint64_t>(op - frameBegin)) {
+				throw zstd_corrupt();
+			}
+			if (hasChecksum) {
+				// The checksum consists of the lower 32 bits of the XXH64 of the decompressed content of the frame:
+				const auto checksum = static_cast<uint32_t>(read_le(4));
+				if (checksum != static_cast<uint32_t>(hash64(std::as_bytes(std::span<const uint8_t>(frameBegin, op))))) {
+					throw gvk::runtime_error("The content checksum of Zstandard compressed data does not match the decompressed data.");
+				}
+			}
+		}
+
+		if (op != opEnd) {
+			throw gvk::runtime_error(fmt::format("Compressed data decompresses to {} bytes, but {} bytes were expected.", op - opBegin, aDestination.size()));
+		}
+	}
+}
@@ -0,0 +1,448 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	namespace
+	{
+		constexpr uint32_t sCacheFileMagic = 0x434B5647; // "GVKC"
+
+		// Header: magic number, version, and codec, footer: offset, size, and checksum of the table of contents, and magic number.
+		// Members are written individually, so that no padding bytes end up in the file.
+		constexpr size_t sHeaderSize = sizeof(uint32_t) * 3;
+		constexpr size_t sFooterSize = sizeof(uint64_t) * 3 + sizeof(uint32_t);
+
+		template <typename T>
+		void write_raw(std::fstream& aFile, const T& aValue)
+		{
+			aFile.write(reinterpret_cast<const char*>(&aValue), sizeof(T));
+		}
+
+		template <typename T>
+		T read_raw(std::span<const std::byte> aData, size_t aOffset)
+		{
+			T value;
+			std::memcpy(&value, aData.data() + aOffset, sizeof(T));
+			return value;
+		}
+
+		void write_header(std::fstream& aFile, compression_codec aCodec)
+		{
+			write_raw(aFile, sCacheFileMagic);
+			write_raw(aFile, static_cast<uint32_t>(SERIALIZER_CACHE_FILE_VERSION));
+			write_raw(aFile, static_cast<uint32_t>(aCodec));
+		}
+
+		// Writes the table of contents and the footer at the given offset, closes the file, and cuts off anything behind the footer.
+		// Returns the end of the footer.
+		uint64_t write_table_of_contents(std::fstream& aFile, const std::string& aPath, std::vector<cache_file_entry>& aEntries, uint64_t aOffset)
+		{
+			auto tocSerializer = serializer::serialize_to_memory();
+			tocSerializer.archive(aEntries);
+			const auto toc = tocSerializer.take_serialized_memory();
+
+			aFile.seekp(static_cast<std::streamoff>(aOffset));
+			aFile.write(toc.data(), static_cast<std::streamsize>(toc.size()));
+			write_raw(aFile, aOffset);
+			write_raw(aFile, static_cast<uint64_t>(toc.size()));
+			write_raw(aFile, hash64(std::as_bytes(std::span<const char>(toc.data(), toc.size()))));
+			write_raw(aFile, sCacheFileMagic);
+			aFile.close();
+			if (aFile.fail()) {
+				throw gvk::runtime_error(fmt::format("Writing to cache file '{}' failed.", aPath));
+			}
+
+			// Cut off the remainder of a write which has failed before:
+			const auto fileSize = aOffset + toc.size() + sFooterSize;
+			if (std::filesystem::file_size(aPath) != fileSize) {
+				std::filesystem::resize_file(aPath, fileSize);
+			}
+			return fileSize;
+		}
+
+		// Whether a valid footer begins at the given offset, i.e. one which refers to a table of contents right in front of it with a matching checksum
+		bool is_footer(std::span<const std::byte> aData, size_t aFooterOffset)
+		{
+			if (read_raw<uint32_t>(aData, aFooterOffset + 3 * sizeof(uint64_t)) != sCacheFileMagic) {
+				return false;
+			}
+			const auto tocOffset = read_raw<uint64_t>(aData, aFooterOffset);
+			const auto tocSize = read_raw<uint64_t>(aData, aFooterOffset + sizeof(uint64_t));
+			const auto tocChecksum = read_raw<uint64_t>(aData, aFooterOffset + 2 * sizeof(uint64_t));
+			return tocOffset >= sHeaderSize && tocSize <= aFooterOffset && tocOffset == aFooterOffset - tocSize
+				&& hash64(aData.subspan(tocOffset, tocSize)) == tocChecksum;
+		}
+	}
+
+	cache_file::cache_file(std::string_view aPath, compression_codec aCodec)
+		: mPath{ aPath }
+		, mCodec{ aCodec }
+	{
+		if (does_cache_file_exist(mPath)) {
+			open();
+		}
+		else {
+			create();
+		}
+	}
+
+	cache_file::~cache_file()
+	{
+		try {
+			flush();
+		}
+		catch (const std::exception& e) {
+			LOG_ERROR(fmt::format("Writing the table of contents of cache file '{}' failed: {}", mPath, e.what()));
+		}
+	}
+
+	void cache_file::flush()
+	{
+		std::scoped_lock lock(mMutex);
+		write_table_of_contents_if_outdated();
+	}
+
+	void cache_file::write_table_of_contents_if_outdated()
+	{
+		if (!mTableOfContentsOutdated) {
+			return;
+		}
+		std::fstream file(mPath, std::ios::in | std::ios::out | std::ios::binary);
+		if (!file.is_open()) {
+			throw gvk::runtime_error(fmt::format("Unable to open cache file '{}' for writing.", mPath));
+		}
+		const auto end = write_table_of_contents(file, mPath, mEntries, mEndOfFile);
+		mTableOfContentsSize = end - mEndOfFile;
+		mEndOfFile = end;
+		mTableOfContentsOutdated = false;
+	}
+
+	compression_codec cache_file::codec() const
+	{
+		std::scoped_lock lock(mMutex);
+		return mCodec;
+	}
+
+	std::vector<cache_file_entry> cache_file::entries() const
+	{
+		std::scoped_lock lock(mMutex);
+		return mEntries;
+	}
+
+	bool cache_file::contains(std::string_view aKey, std::optional<uint64_t> aInputHash) const
+	{
+		std::scoped_lock lock(mMutex);
+		const auto* entry = find(aKey);
+		return nullptr != entry && (!aInputHash.has_value() || entry->mInputHash == aInputHash.value());
+	}
+
+	cache_file_statistics cache_file::statistics() const
+	{
+		std::scoped_lock lock(mMutex);
+		return mStatistics;
+	}
+
+	void cache_file::record_entry_time(std::string_view aKey, bool aProduced, double aSeconds)
+	{
+		std::scoped_lock lock(mMutex);
+		if (aProduced) {
+			++mStatistics.mEntriesProduced;
+			mStatistics.mProduceSeconds += aSeconds;
+		}
+		else {
+			mStatistics.mLoadSeconds += aSeconds;
+		}
+		mStatistics.mSecondsPerEntry[std::string(aKey)] += aSeconds;
+	}
+
+	uint64_t cache_file::unreferenced_bytes() const
+	{
+		std::scoped_lock lock(mMutex);
+		uint64_t referenced = 0;
+		for (const auto& entry : mEntries) {
+			referenced += entry.mSize;
+		}
+		return mEndOfFile - sHeaderSize - mTableOfContentsSize - referenced;
+	}
+
+	std::vector<cache_file_issue> cache_file::verify()
+	{
+		std::vector<cache_file_entry> entries;
+		std::shared_ptr<const memory_mapped_file> mapping;
+		uint64_t dataEnd;
+		compression_codec codec;
+		{
+			std::scoped_lock lock(mMutex);
+			entries = mEntries;
+			codec = mCodec;
+			// Map the whole file as it is now, the data of all current entries is contained:
+			mMapping = std::make_shared<const memory_mapped_file>(mPath);
+			mapping = mMapping;
+			dataEnd = mEndOfFile;
+		}
+
+		// Entries are immutable once written => check them without holding the lock
+		std::vector<cache_file_issue> issues;
+		for (const auto& entry : entries) {
+			if (entry.mOffset < sHeaderSize || entry.mOffset + entry.mSize > dataEnd || entry.mOffset + entry.mSize > mapping->size()) {
+				issues.push_back({ entry.mKey, fmt::format("Data at offset {} with size {} lies outside of the file's data section.", entry.mOffset, entry.mSize) });
+				continue;
+			}
+			const auto data = mapping->span().subspan(entry.mOffset, entry.mSize);
+			const auto checksum = hash64(data);
+			if (checksum != entry.mChecksum) {
+				issues.push_back({ entry.mKey, fmt::format("Checksum mismatch, stored {:016x}, computed {:016x}.", entry.mChecksum, checksum) });
+				continue;
+			}
+			if (compression_codec::none == codec) {
+				if (entry.mSize != entry.mUncompressedSize) {
+					issues.push_back({ entry.mKey, fmt::format("Size {} does not match the serialized size {}.", entry.mSize, entry.mUncompressedSize) });
+				}
+				continue;
+			}
+			try {
+				const auto decompressedSize = decompress_chunked(data, codec).size();
+				if (decompressedSize != entry.mUncompressedSize) {
+					issues.push_back({ entry.mKey, fmt::format("Decompressed size {} does not match the serialized size {}.", decompressedSize, entry.mUncompressedSize) });
+				}
+			}
+			catch (const gvk::runtime_error& e) {
+				issues.push_back({ entry.mKey, fmt::format("Decompression failed: {}", e.what()) });
+			}
+		}
+		return issues;
+	}
+
+	uint64_t cache_file::compact(std::function<bool(const cache_file_entry&)> aKeep)
+	{
+		std::scoped_lock lock(mMutex);
+		// Measure the size of the file including the table of contents of all entries:
+		write_table_of_contents_if_outdated();
+		const auto sizeBefore = std::filesystem::file_size(mPath);
+		const auto compactPath = mPath + ".compact";
+		{
+			std::fstream file(compactPath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file.is_open()) {
+				throw gvk::runtime_error(fmt::format("Unable to create file '{}' for compacting cache file '{}'.", compactPath, mPath));
+			}
+			write_header(file, mCodec);
+
+			// Copy the data of the kept entries from the mapped file, one after another:
+			const auto mapping = std::make_shared<const memory_mapped_file>(mPath);
+			std::vector<cache_file_entry> keptEntries;
+			uint64_t offset = sHeaderSize;
+			for (const auto& entry : mEntries) {
+				if (aKeep && !aKeep(entry)) {
+					continue;
+				}
+				const auto data = mapping->span().subspan(entry.mOffset, entry.mSize);
+				file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+				keptEntries.push_back(entry);
+				keptEntries.back().mOffset = offset;
+				offset += entry.mSize;
+			}
+			write_table_of_contents(file, compactPath, keptEntries, offset);
+		}
+
+		// Replace the original file. A file which is mapped cannot be replaced on all platforms => release the mapping first.
+		mMapping.reset();
+		std::filesystem::rename(compactPath, mPath);
+		open();
+		// The new table of contents may be larger than the dropped data, e.g. if nothing has been dropped:
+		const auto sizeAfter = std::filesystem::file_size(mPath);
+		return sizeAfter < sizeBefore ? sizeBefore - sizeAfter : 0;
+	}
+
+	const cache_file_entry* cache_file::find(std::string_view aKey) const
+	{
+		const auto it = mIndexOfKey.find(std::string(aKey));
+		return mIndexOfKey.end() == it ? nullptr : &mEntries[it->second];
+	}
+
+	std::shared_ptr<const memory_mapped_file> cache_file::mapping_for(const cache_file_entry& aEntry)
+	{
+		if (!mMapping || aEntry.mOffset + aEntry.mSize > mMapping->size()) {
+			// The entry has been appended after the file has been mapped:
+			mMapping = std::make_shared<const memory_mapped_file>(mPath);
+		}
+		return mMapping;
+	}
+
+	std::optional<serializer> cache_file::read_entry(std::string_view aKey, std::optional<uint64_t> aInputHash)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		std::span<const std::byte> data;
+		std::shared_ptr<const memory_mapped_file> mapping;
+		compression_codec codec;
+		{
+			std::scoped_lock lock(mMutex);
+			codec = mCodec;
+			const auto* entry = find(aKey);
+			if (nullptr == entry) {
+				return {};
+			}
+			if (aInputHash.has_value() && entry->mInputHash != aInputHash.value()) {
+				LOG_INFO(fmt::format("Cache entry '{}' in cache file '{}' is outdated and will be recreated.", aKey, mPath));
+				return {};
+			}
+			mapping = mapping_for(*entry);
+			data = mapping->span().subspan(entry->mOffset, entry->mSize);
+		}
+
+		// Entries are immutable once written => decompress and read them without holding the lock
+		if (compression_codec::none == codec) {
+			const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::scoped_lock lock(mMutex);
+			++mStatistics.mEntriesLoaded;
+			mStatistics.mBytesRead += data.size();
+			mStatistics.mBytesDecompressed += data.size();
+			mStatistics.mReadSeconds += seconds;
+			return serializer::deserialize_from_memory(data, std::move(mapping));
+		}
+
+		const auto decompressStart = std::chrono::steady_clock::now();
+		auto decompressed = std::make_shared<const std::vector<std::byte>>(decompress_chunked(data, codec));
+		const auto end = std::chrono::steady_clock::now();
+		{
+			std::scoped_lock lock(mMutex);
+			++mStatistics.mEntriesLoaded;
+			mStatistics.mBytesRead += data.size();
+			mStatistics.mBytesDecompressed += decompressed->size();
+			mStatistics.mDecompressSeconds += std::chrono::duration<double>(end - decompressStart).count();
+			mStatistics.mReadSeconds += std::chrono::duration<double>(end - start).count();
+		}
+		return serializer::deserialize_from_memory(std::span<const std::byte>(*decompressed), decompressed);
+	}
+
+	void cache_file::write_entry(std::string_view aKey, std::span<const std::byte> aData, uint64_t aInputHash, std::string_view aDescription)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		cache_file_entry entry{ std::string(aKey), 0, 0, aInputHash, aData.size(), 0, std::string(aDescription) };
+		compression_codec codec;
+		{
+			std::scoped_lock lock(mMutex);
+			codec = mCodec;
+		}
+		// Compress and hash without holding the lock, so that multiple producers can do so in parallel
+		std::vector<std::byte> compressed;
+		if (compression_codec::none != codec) {
+			compressed = compress_chunked(aData, codec);
+		}
+		const std::span<const std::byte> stored = compression_codec::none != codec ? std::span<const std::byte>(compressed) : aData;
+		entry.mChecksum = hash64(stored);
+
+		std::scoped_lock lock(mMutex);
+		write_stored_entry(std::move(entry), stored);
+		++mStatistics.mEntriesWritten;
+		mStatistics.mBytesSerialized += aData.size();
+		mStatistics.mBytesWritten += stored.size();
+		mStatistics.mWriteSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void cache_file::write_stored_entry(cache_file_entry aEntry, std::span<const std::byte> aData)
+	{
+		std::fstream file(mPath, std::ios::in | std::ios::out | std::ios::binary);
+		if (!file.is_open()) {
+			throw gvk::runtime_error(fmt::format("Unable to open cache file '{}' for writing.", mPath));
+		}
+
+		// The new entry's data is appended behind the last written table of contents and footer, which stay valid until flush
+		// writes the next ones behind the appended data. If the process terminates before, only the appended entries are lost.
+		const uint64_t offset = mEndOfFile;
+		aEntry.mOffset = offset;
+		aEntry.mSize = aData.size();
+		file.seekp(static_cast<std::streamoff>(aEntry.mOffset));
+		file.write(reinterpret_cast<const char*>(aData.data()), static_cast<std::streamsize>(aData.size()));
+		file.close();
+		if (file.fail()) {
+			// The partially written data is overwritten by the next entry, or cut off when the table of contents is written
+			throw gvk::runtime_error(fmt::format("Writing to cache file '{}' failed.", mPath));
+		}
+
+		const auto it = mIndexOfKey.find(aEntry.mKey);
+		if (mIndexOfKey.end() != it) {
+			// Supersede the existing entry. Its data remains in the file, but is no longer referenced.
+			mEntries[it->second] = std::move(aEntry);
+		}
+		else {
+			mIndexOfKey.emplace(aEntry.mKey, mEntries.size());
+			mEntries.push_back(std::move(aEntry));
+		}
+		mEndOfFile = offset + aData.size();
+		mTableOfContentsOutdated = true;
+	}
+
+	void cache_file::create()
+	{
+		// Release the mapping before truncating the file
+		mMapping.reset();
+		std::fstream file(mPath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			throw gvk::runtime_error(fmt::format("Unable to create cache file '{}'.", mPath));
+		}
+		write_header(file, mCodec);
+		mEntries.clear();
+		mIndexOfKey.clear();
+		mEndOfFile = write_table_of_contents(file, mPath, mEntries, sHeaderSize);
+		mTableOfContentsSize = mEndOfFile - sHeaderSize;
+		mTableOfContentsOutdated = false;
+	}
+
+	void cache_file::open()
+	{
+		mMapping = std::make_shared<const memory_mapped_file>(mPath);
+		const auto data = mMapping->span();
+		if (data.size() < sHeaderSize + sFooterSize || read_raw<uint32_t>(data, 0) != sCacheFileMagic) {
+			throw gvk::runtime_error(fmt::format("The file '{}' is not a cache file.", mPath));
+		}
+		if (read_raw<uint32_t>(data, sizeof(uint32_t)) != SERIALIZER_CACHE_FILE_VERSION) {
+			LOG_INFO(fmt::format("Versions of serializer and cache file '{}' do not match. The cache file is recreated.", mPath));
+			create();
+			return;
+		}
+		mCodec = static_cast<compression_codec>(read_raw<uint32_t>(data, 2 * sizeof(uint32_t)));
+
+		size_t footerOffset = data.size() - sFooterSize;
+		if (!is_footer(data, footerOffset)) {
+			// Most likely, the process has terminated after entries have been appended, but before the table of contents has
+			// been written behind them => fall back to the last footer which has been written, and drop the data behind it:
+			while (footerOffset > sHeaderSize && !is_footer(data, footerOffset)) {
+				--footerOffset;
+			}
+			if (!is_footer(data, footerOffset)) {
+				LOG_WARNING(fmt::format("The table of contents of cache file '{}' is damaged. The cache file is recreated.", mPath));
+				create();
+				return;
+			}
+			LOG_WARNING(fmt::format("Cache file '{}' ends with entries which have been written after its last flush. These entries are dropped.", mPath));
+			mMapping.reset();
+			std::filesystem::resize_file(mPath, footerOffset + sFooterSize);
+			open();
+			return;
+		}
+		const auto tocOffset = read_raw<uint64_t>(data, footerOffset);
+		const auto tocSize = read_raw<uint64_t>(data, footerOffset + sizeof(uint64_t));
+
+		try {
+			auto tocSerializer = serializer::deserialize_from_memory(data.subspan(tocOffset, tocSize));
+			mEntries.clear();
+			tocSerializer.archive(mEntries);
+		}
+		catch (const std::exception& e) {
+			LOG_WARNING(fmt::format("The table of contents of cache file '{}' cannot be read ({}). The cache file is recreated.", mPath, e.what()));
+			create();
+			return;
+		}
+		mIndexOfKey.clear();
+		for (size_t i = 0; i < mEntries.size(); ++i) {
+			if (mEntries[i].mOffset < sHeaderSize || mEntries[i].mOffset + mEntries[i].mSize > tocOffset) {
+				LOG_WARNING(fmt::format("Entry '{}' of cache file '{}' lies outside of the file's data section. The cache file is recreated.", mEntries[i].mKey, mPath));
+				create();
+				return;
+			}
+			mIndexOfKey[mEntries[i].mKey] = i;
+		}
+		mEndOfFile = data.size();
+		mTableOfContentsSize = data.size() - tocOffset;
+		mTableOfContentsOutdated = false;
+	}
+}
@@ -0,0 +1,204 @@
+#include <gvk.hpp>
+#include <glm/gtc/packing.hpp>
+
+namespace gvk
+{
+	namespace
+	{
+		// The texture indices and offsets/tilings of all slots, in the order of material_texture_slot
+		std::array<int32_t, material_texture_slot_count> tex_indices(const material_gpu_data& aMaterial)
+		{
+			return {
+				aMaterial.mDiffuseTexIndex, aMaterial.mSpecularTexIndex, aMaterial.mAmbientTexIndex, aMaterial.mEmissiveTexIndex,
+				aMaterial.mHeightTexIndex, aMaterial.mNormalsTexIndex, aMaterial.mShininessTexIndex, aMaterial.mOpacityTexIndex,
+				aMaterial.mDisplacementTexIndex, aMaterial.mReflectionTexIndex, aMaterial.mLightmapTexIndex, aMaterial.mExtraTexIndex
+			};
+		}
+
+		std::array<glm::vec4, material_texture_slot_count> offset_tilings(const material_gpu_data& aMaterial)
+		{
+			return {
+				aMaterial.mDiffuseTexOffsetTiling, aMaterial.mSpecularTexOffsetTiling, aMaterial.mAmbientTexOffsetTiling, aMaterial.mEmissiveTexOffsetTiling,
+				aMaterial.mHeightTexOffsetTiling, aMaterial.mNormalsTexOffsetTiling, aMaterial.mShininessTexOffsetTiling, aMaterial.mOpacityTexOffsetTiling,
+				aMaterial.mDisplacementTexOffsetTiling, aMaterial.mReflectionTexOffsetTiling, aMaterial.mLightmapTexOffsetTiling, aMaterial.mExtraTexOffsetTiling
+			};
+		}
+
+		std::array<const std::string*, material_texture_slot_count> texture_paths(const material_config& aMaterialConfig)
+		{
+			return {
+				&aMaterialConfig.mDiffuseTex, &aMaterialConfig.mSpecularTex, &aMaterialConfig.mAmbientTex, &aMaterialConfig.mEmissiveTex,
+				&aMaterialConfig.mHeightTex, &aMaterialConfig.mNormalsTex, &aMaterialConfig.mShininessTex, &aMaterialConfig.mOpacityTex,
+				&aMaterialConfig.mDisplacementTex, &aMaterialConfig.mReflectionTex, &aMaterialConfig.mLightmapTex, &aMaterialConfig.mExtraTex
+			};
+		}
+
+		std::array<uint32_t, 2> pack_half4(const glm::vec4& aValue)
+		{
+			return { glm::packHalf2x16(glm::vec2{ aValue.x, aValue.y }), glm::packHalf2x16(glm::vec2{ aValue.z, aValue.w }) };
+		}
+
+		glm::vec4 unpack_half4(const std::array<uint32_t, 2>& aValue)
+		{
+			return glm::vec4{ glm::unpackHalf2x16(aValue[0]), glm::unpackHalf2x16(aValue[1]) };
+		}
+
+		uint32_t pack_16bit_pair(uint32_t aLower, uint32_t aUpper)
+		{
+			return (aLower & 0xFFFFu) | (aUpper << 16);
+		}
+
+		uint32_t unpack_16bit(const std::array<uint32_t, material_texture_slot_count / 2>& aPairs, size_t aIndex)
+		{
+			return (aPairs[aIndex / 2] >> (16 * (aIndex % 2))) & 0xFFFFu;
+		}
+	}
+
+	compact_material_table pack_materials(std::span<const material_config> aMaterialConfigs, std::span<const material_gpu_data> aMaterials)
+	{
+		assert(aMaterialConfigs.size() == aMaterials.size());
+		constexpr uint32_t noTexture = 0xFFFFu;
+		const glm::vec4 identity{ 0.f, 0.f, 1.f, 1.f };
+
+		compact_material_table result;
+		result.mMaterials.reserve(aMaterials.size());
+		result.mOffsetTilings.push_back(identity);
+		std::unordered_map<glm::vec4, uint32_t> offsetTilingIndices;
+		offsetTilingIndices.emplace(identity, 0u);
+
+		bool colorsClamped = false;
+		auto packColor = [&colorsClamped](const glm::vec4& bColor) {
+			colorsClamped = colorsClamped || glm::any(glm::lessThan(bColor, glm::vec4{ 0.f })) || glm::any(glm::greaterThan(bColor, glm::vec4{ 1.f }));
+			return glm::packUnorm4x8(bColor);
+		};
+
+		for (size_t i = 0; i < aMaterials.size(); ++i) {
+			const auto& m = aMaterials[i];
+			auto& packed = result.mMaterials.emplace_back();
+			packed.mDiffuseReflectivity		= packColor(m.mDiffuseReflectivity);
+			packed.mAmbientReflectivity		= packColor(m.mAmbientReflectivity);
+			packed.mSpecularReflectivity	= packColor(m.mSpecularReflectivity);
+			packed.mTransparentColor		= packColor(m.mTransparentColor);
+			packed.mReflectiveColor			= packColor(m.mReflectiveColor);
+			packed.mAlbedo					= packColor(m.mAlbedo);
+
+			packed.mEmissiveColor			= pack_half4(m.mEmissiveColor);
+			packed.mAnisotropyRotation		= pack_half4(m.mAnisotropyRotation);
+			packed.mCustomData				= pack_half4(m.mCustomData);
+
+			packed.mScalars = {
+				glm::packHalf2x16(glm::vec2{ m.mOpacity,			m.mBumpScaling			}),
+				glm::packHalf2x16(glm::vec2{ m.mShininess,			m.mShininessStrength	}),
+				glm::packHalf2x16(glm::vec2{ m.mRefractionIndex,	m.mReflectivity			}),
+				glm::packHalf2x16(glm::vec2{ m.mMetallic,			m.mSmoothness			}),
+				glm::packHalf2x16(glm::vec2{ m.mSheen,				m.mThickness			}),
+				glm::packHalf2x16(glm::vec2{ m.mRoughness,			m.mAnisotropy			})
+			};
+
+			const auto texIndices = tex_indices(m);
+			const auto offsetTilings = offset_tilings(m);
+			const auto texPaths = texture_paths(aMaterialConfigs[i]);
+			std::array<uint32_t, material_texture_slot_count> texIndices16;
+			std::array<uint32_t, material_texture_slot_count> offsetTilingIndices16;
+			packed.mFeatures = 0u;
+			for (uint32_t slot = 0; slot < material_texture_slot_count; ++slot) {
+				if (texIndices[slot] >= static_cast<int32_t>(noTexture)) {
+					throw gvk::runtime_error(fmt::format("The texture index {} of material {} does not fit into 16 bits. Textures which are packed into array textures cannot be used with compact materials.", texIndices[slot], i));
+				}
+				texIndices16[slot] = texIndices[slot] < 0 ? noTexture : static_cast<uint32_t>(texIndices[slot]);
+
+				const auto [it, inserted] = offsetTilingIndices.try_emplace(offsetTilings[slot], static_cast<uint32_t>(result.mOffsetTilings.size()));
+				if (inserted) {
+					if (result.mOffsetTilings.size() > 0xFFFFu) {
+						throw gvk::runtime_error("There are more distinct texture offsets and tilings than can be referenced with 16-bit indices.");
+					}
+					result.mOffsetTilings.push_back(offsetTilings[slot]);
+				}
+				offsetTilingIndices16[slot] = it->second;
+
+				if (!texPaths[slot]->empty()) {
+					packed.mFeatures |= has_texture_bit(static_cast<material_texture_slot>(slot));
+				}
+				if (0u != it->second) {
+					packed.mFeatures |= has_offset_tiling_bit(static_cast<material_texture_slot>(slot));
+				}
+			}
+			for (uint32_t pair = 0; pair < material_texture_slot_count / 2; ++pair) {
+				packed.mTexIndices[pair] = pack_16bit_pair(texIndices16[2 * pair], texIndices16[2 * pair + 1]);
+				packed.mOffsetTilingIndices[pair] = pack_16bit_pair(offsetTilingIndices16[2 * pair], offsetTilingIndices16[2 * pair + 1]);
+			}
+			packed.mPadding = 0u;
+		}
+
+		if (colorsClamped) {
+			LOG_WARNING("Some material colors are outside of [0, 1], and have been clamped when they were packed into unsigned normalized components.");
+		}
+		return result;
+	}
+
+	material_gpu_data unpack_material(const compact_material_gpu_data& aMaterial, std::span<const glm::vec4> aOffsetTilings)
+	{
+		material_gpu_data result;
+		result.mDiffuseReflectivity		= glm::unpackUnorm4x8(aMaterial.mDiffuseReflectivity);
+		result.mAmbientReflectivity		= glm::unpackUnorm4x8(aMaterial.mAmbientReflectivity);
+		result.mSpecularReflectivity	= glm::unpackUnorm4x8(aMaterial.mSpecularReflectivity);
+		result.mTransparentColor		= glm::unpackUnorm4x8(aMaterial.mTransparentColor);
+		result.mReflectiveColor			= glm::unpackUnorm4x8(aMaterial.mReflectiveColor);
+		result.mAlbedo					= glm::unpackUnorm4x8(aMaterial.mAlbedo);
+
+		result.mEmissiveColor			= unpack_half4(aMaterial.mEmissiveColor);
+		result.mAnisotropyRotation		= unpack_half4(aMaterial.mAnisotropyRotation);
+		result.mCustomData				= unpack_half4(aMaterial.mCustomData);
+
+		std::array<glm::vec2, 6> scalars;
+		for (size_t i = 0; i < scalars.size(); ++i) {
+			scalars[i] = glm::unpackHalf2x16(aMaterial.mScalars[i]);
+		}
+		result.mOpacity				= scalars[0].x;
+		result.mBumpScaling			= scalars[0].y;
+		result.mShininess			= scalars[1].x;
+		result.mShininessStrength	= scalars[1].y;
+		result.mRefractionIndex		= scalars[2].x;
+		result.mReflectivity		= scalars[2].y;
+		result.mMetallic			= scalars[3].x;
+		result.mSmoothness			= scalars[3].y;
+		result.mSheen				= scalars[4].x;
+		result.mThickness			= scalars[4].y;
+		result.mRoughness			= scalars[5].x;
+		result.mAnisotropy			= scalars[5].y;
+
+		auto texIndex = [&aMaterial](material_texture_slot bSlot) {
+			const auto index = unpack_16bit(aMaterial.mTexIndices, static_cast<size_t>(bSlot));
+			return 0xFFFFu == index ? -1 : static_cast<int32_t>(index);
+		};
+		auto offsetTiling = [&aMaterial, &aOffsetTilings](material_texture_slot bSlot) {
+			return aOffsetTilings[unpack_16bit(aMaterial.mOffsetTilingIndices, static_cast<size_t>(bSlot))];
+		};
+		result.mDiffuseTexIndex				= texIndex(material_texture_slot::diffuse);
+		result.mSpecularTexIndex			= texIndex(material_texture_slot::specular);
+		result.mAmbientTexIndex				= texIndex(material_texture_slot::ambient);
+		result.mEmissiveTexIndex			= texIndex(material_texture_slot::emissive);
+		result.mHeightTexIndex				= texIndex(material_texture_slot::height);
+		result.mNormalsTexIndex				= texIndex(material_texture_slot::normals);
+		result.mShininessTexIndex			= texIndex(material_texture_slot::shininess);
+		result.mOpacityTexIndex				= texIndex(material_texture_slot::opacity);
+		result.mDisplacementTexIndex		= texIndex(material_texture_slot::displacement);
+		result.mReflectionTexIndex			= texIndex(material_texture_slot::reflection);
+		result.mLightmapTexIndex			= texIndex(material_texture_slot::lightmap);
+		result.mExtraTexIndex				= texIndex(material_texture_slot::extra);
+
+		result.mDiffuseTexOffsetTiling		= offsetTiling(material_texture_slot::diffuse);
+		result.mSpecularTexOffsetTiling		= offsetTiling(material_texture_slot::specular);
+		result.mAmbientTexOffsetTiling		= offsetTiling(material_texture_slot::ambient);
+		result.mEmissiveTexOffsetTiling		= offsetTiling(material_texture_slot::emissive);
+		result.mHeightTexOffsetTiling		= offsetTiling(material_texture_slot::height);
+		result.mNormalsTexOffsetTiling		= offsetTiling(material_texture_slot::normals);
+		result.mShininessTexOffsetTiling	= offsetTiling(material_texture_slot::shininess);
+		result.mOpacityTexOffsetTiling		= offsetTiling(material_texture_slot::opacity);
+		result.mDisplacementTexOffsetTiling	= offsetTiling(material_texture_slot::displacement);
+		result.mReflectionTexOffsetTiling	= offsetTiling(material_texture_slot::reflection);
+		result.mLightmapTexOffsetTiling		= offsetTiling(material_texture_slot::lightmap);
+		result.mExtraTexOffsetTiling		= offsetTiling(material_texture_slot::extra);
+		return result;
+	}
+}
@@ -0,0 +1,110 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	avk::image_view constant_color_texture_pool::image_view(std::array<uint8_t, 4> aColor, vk::Format aFormat, avk::image_usage aImageUsage)
+	{
+		std::scoped_lock lock(mMutex);
+		return get_or_create(aColor, aFormat, aImageUsage).mImageView;
+	}
+
+	avk::image_sampler constant_color_texture_pool::image_sampler(std::array<uint8_t, 4> aColor, vk::Format aFormat, avk::image_usage aImageUsage, avk::filter_mode aFilterMode)
+	{
+		std::scoped_lock lock(mMutex);
+		auto& texture = get_or_create(aColor, aFormat, aImageUsage);
+		auto it = texture.mImageSamplers.find(aFilterMode);
+		if (texture.mImageSamplers.end() == it) {
+			auto smplr = context().create_sampler(aFilterMode, avk::border_handling_mode::repeat);
+			auto imageSampler = context().create_image_sampler(avk::shared(texture.mImageView), avk::owned(smplr));
+			imageSampler.enable_shared_ownership();
+			it = texture.mImageSamplers.emplace(aFilterMode, std::move(imageSampler)).first;
+		}
+		return it->second;
+	}
+
+	uint32_t constant_color_texture_pool::layer(std::array<uint8_t, 4> aColor, vk::Format aFormat)
+	{
+		std::scoped_lock lock(mMutex);
+		auto& arrayTexture = mArrayTextures[aFormat];
+		const auto it = std::find(std::begin(arrayTexture.mColors), std::end(arrayTexture.mColors), aColor);
+		if (std::end(arrayTexture.mColors) != it) {
+			return static_cast<uint32_t>(std::distance(std::begin(arrayTexture.mColors), it));
+		}
+		arrayTexture.mColors.push_back(aColor);
+		arrayTexture.mImageViews.clear();
+		return static_cast<uint32_t>(arrayTexture.mColors.size() - 1);
+	}
+
+	avk::image_view constant_color_texture_pool::array_image_view(vk::Format aFormat, avk::image_usage aImageUsage)
+	{
+		std::scoped_lock lock(mMutex);
+		const auto it = mArrayTextures.find(aFormat);
+		if (mArrayTextures.end() == it || it->second.mColors.empty()) {
+			throw gvk::logic_error(fmt::format("No colors have been added to the array texture of format {}.", vk::to_string(aFormat)));
+		}
+		auto& arrayTexture = it->second;
+		if (const auto viewIt = arrayTexture.mImageViews.find(aImageUsage); arrayTexture.mImageViews.end() != viewIt) {
+			return viewIt->second;
+		}
+
+		const auto numLayers = static_cast<uint32_t>(arrayTexture.mColors.size());
+		auto sync = avk::sync::wait_idle();
+		auto& commandBuffer = sync.get_or_create_command_buffer();
+		sync.establish_barrier_before_the_operation(avk::pipeline_stage::transfer, avk::read_memory_access{ avk::memory_access::transfer_read_access });
+
+		auto img = context().create_image(1u, 1u, aFormat, static_cast<int>(numLayers), avk::memory_usage::device, aImageUsage);
+		auto finalTargetLayout = img->target_layout(); // save for later, because first, we need to transfer something into it
+		img->transition_to_layout(vk::ImageLayout::eTransferDstOptimal, avk::sync::auxiliary_with_barriers(sync, {}, {}));
+
+		std::vector<avk::buffer> stagingBuffers;
+		for (uint32_t layer = 0; layer < numLayers; ++layer) {
+			auto& sb = stagingBuffers.emplace_back(context().create_buffer(
+				AVK_STAGING_BUFFER_MEMORY_USAGE,
+				vk::BufferUsageFlagBits::eTransferSrc,
+				avk::generic_buffer_meta::create_from_size(sizeof(std::array<uint8_t, 4>))
+			));
+			sb->fill(arrayTexture.mColors[layer].data(), 0, avk::sync::not_required());
+			// Memory writes are not overlapping => no barriers should be fine.
+			avk::copy_buffer_to_image_layer_mip_level(avk::const_referenced(sb), avk::referenced(img), layer, 0, {}, avk::sync::auxiliary_with_barriers(sync, {}, {}));
+		}
+		commandBuffer.set_custom_deleter([lOwnedStagingBuffers = std::move(stagingBuffers)](){});
+
+		img->transition_to_layout(finalTargetLayout, avk::sync::auxiliary_with_barriers(sync, {}, {}));
+		sync.establish_barrier_after_the_operation(avk::pipeline_stage::transfer, avk::write_memory_access{ avk::memory_access::transfer_write_access });
+		auto result = sync.submit_and_sync();
+		assert(!result.has_value());
+
+		// Also a single color is accessed as an array texture:
+		auto imageView = context().create_image_view(avk::owned(img), {}, {}, [](avk::image_view_t& bImageView) {
+			bImageView.create_info().setViewType(vk::ImageViewType::e2DArray);
+		});
+		imageView.enable_shared_ownership();
+		return arrayTexture.mImageViews.emplace(aImageUsage, std::move(imageView)).first->second;
+	}
+
+	size_t constant_color_texture_pool::number_of_textures() const
+	{
+		std::scoped_lock lock(mMutex);
+		return mTextures.size();
+	}
+
+	void constant_color_texture_pool::clear()
+	{
+		std::scoped_lock lock(mMutex);
+		mTextures.clear();
+		mArrayTextures.clear();
+	}
+
+	constant_color_texture_pool::constant_color_texture& constant_color_texture_pool::get_or_create(std::array<uint8_t, 4> aColor, vk::Format aFormat, avk::image_usage aImageUsage)
+	{
+		const auto it = mTextures.find({ aColor, aFormat, aImageUsage });
+		if (mTextures.end() != it) {
+			return it->second;
+		}
+
+		constant_color_texture texture;
+		texture.mImageView = context().create_image_view(create_1px_texture(aColor, aFormat, avk::memory_usage::device, aImageUsage, avk::sync::wait_idle()));
+		texture.mImageView.enable_shared_ownership();
+		return mTextures.emplace(texture_key{ aColor, aFormat, aImageUsage }, std::move(texture)).first->second;
+	}
+}
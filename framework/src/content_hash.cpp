@@ -0,0 +1,134 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	namespace
+	{
+		constexpr uint64_t sPrime1 = 0x9E3779B185EBCA87ull;
+		constexpr uint64_t sPrime2 = 0xC2B2AE3D27D4EB4Full;
+		constexpr uint64_t sPrime3 = 0x165667B19E3779F9ull;
+		constexpr uint64_t sPrime4 = 0x85EBCA77C2B2AE63ull;
+		constexpr uint64_t sPrime5 = 0x27D4EB2F165667C5ull;
+
+		uint64_t rotl(uint64_t aValue, int aBits)
+		{
+			return (aValue << aBits) | (aValue >> (64 - aBits));
+		}
+
+		template <typename T>
+		uint64_t read(const std::byte* aData)
+		{
+			T value;
+			std::memcpy(&value, aData, sizeof(T));
+			return static_cast<uint64_t>(value);
+		}
+
+		uint64_t xxh_round(uint64_t aAccumulator, uint64_t aInput)
+		{
+			aAccumulator += aInput * sPrime2;
+			aAccumulator = rotl(aAccumulator, 31);
+			return aAccumulator * sPrime1;
+		}
+
+		uint64_t merge_round(uint64_t aAccumulator, uint64_t aValue)
+		{
+			aAccumulator ^= xxh_round(0, aValue);
+			return aAccumulator * sPrime1 + sPrime4;
+		}
+	}
+
+	uint64_t hash64(std::span<const std::byte> aData, uint64_t aSeed)
+	{
+		const std::byte* p = aData.data();
+		const std::byte* const end = p + aData.size();
+		uint64_t h;
+
+		if (aData.size() >= 32) {
+			uint64_t v1 = aSeed + sPrime1 + sPrime2;
+			uint64_t v2 = aSeed + sPrime2;
+			uint64_t v3 = aSeed;
+			uint64_t v4 = aSeed - sPrime1;
+			const std::byte* const limit = end - 32;
+			do {
+				v1 = xxh_round(v1, read<uint64_t>(p));
+				p += 8;
+				v2 = xxh_round(v2, read<uint64_t>(p));
+				p += 8;
+				v3 = xxh_round(v3, read<uint64_t>(p));
+				p += 8;
+				v4 = xxh_round(v4, read<uint64_t>(p));
+				p += 8;
+			} while (p <= limit);
+			h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+			h = merge_round(h, v1);
+			h = merge_round(h, v2);
+			h = merge_round(h, v3);
+			h = merge_round(h, v4);
+		}
+		else {
+			h = aSeed + sPrime5;
+		}
+
+		h += static_cast<uint64_t>(aData.size());
+
+		while (p + 8 <= end) {
+			h ^= xxh_round(0, read<uint64_t>(p));
+			h = rotl(h, 27) * sPrime1 + sPrime4;
+			p += 8;
+		}
+		if (p + 4 <= end) {
+			h ^= read<uint32_t>(p) * sPrime1;
+			h = rotl(h, 23) * sPrime2 + sPrime3;
+			p += 4;
+		}
+		while (p < end) {
+			h ^= static_cast<uint64_t>(*p) * sPrime5;
+			h = rotl(h, 11) * sPrime1;
+			++p;
+		}
+
+		// Final avalanche
+		h ^= h >> 33;
+		h *= sPrime2;
+		h ^= h >> 29;
+		h *= sPrime3;
+		h ^= h >> 32;
+		return h;
+	}
+
+	content_hash& content_hash::add(std::span<const std::byte> aData)
+	{
+		mValue = hash64(aData, mValue);
+		return *this;
+	}
+
+	content_hash& content_hash::add(std::string_view aString)
+	{
+		// Include the length, so that e.g. "ab","c" and "a","bc" result in different hashes
+		add(static_cast<uint64_t>(aString.size()));
+		return add(std::as_bytes(std::span<const char>(aString.data(), aString.size())));
+	}
+
+	content_hash& content_hash::add_file(std::string_view aPath, file_hash_mode aMode)
+	{
+		if (!std::filesystem::exists(aPath)) {
+			throw gvk::runtime_error(fmt::format("Unable to hash file '{}', since it does not exist.", aPath));
+		}
+		switch (aMode) {
+		case file_hash_mode::contents:
+		{
+			const memory_mapped_file file(aPath);
+			add(static_cast<uint64_t>(file.size()));
+			return add(file.span());
+		}
+		case file_hash_mode::timestamp_and_size:
+		{
+			const auto timestamp = std::filesystem::last_write_time(aPath).time_since_epoch().count();
+			add(static_cast<uint64_t>(std::filesystem::file_size(aPath)));
+			return add(static_cast<int64_t>(timestamp));
+		}
+		default:
+			throw gvk::runtime_error("Unknown file_hash_mode.");
+		}
+	}
+}
@@ -38,6 +38,8 @@ namespace gvk
 		return supportedValidationLayers;
 	}
 
+	context_vulkan::context_vulkan() = default;
+
 	context_vulkan::~context_vulkan()
 	{
 		mContextState = gvk::context_state::about_to_finalize;
@@ -48,6 +50,10 @@ namespace gvk
 
 		mLogicalDevice.waitIdle();
 
+		// The constant-color textures are referenced by the context => destroy them while the device is still alive
+		mConstantColorTextures.reset();
+		mStagingRing.reset();
+
 #if defined(AVK_USE_VMA)
 		vmaDestroyAllocator(mMemoryAllocator);
 #endif
@@ -948,6 +954,24 @@ namespace gvk
 		LOG_INFO(fmt::format("Going to use {}", mPhysicalDevice.getProperties().deviceName));
 	}
 
+	constant_color_texture_pool& context_vulkan::constant_color_textures()
+	{
+		std::scoped_lock<std::mutex> guard(sConcurrentAccessMutex);
+		if (!mConstantColorTextures) {
+			mConstantColorTextures = std::make_unique<constant_color_texture_pool>();
+		}
+		return *mConstantColorTextures;
+	}
+
+	staging_ring_buffer& context_vulkan::staging_ring()
+	{
+		std::scoped_lock<std::mutex> guard(sConcurrentAccessMutex);
+		if (!mStagingRing) {
+			mStagingRing = std::make_unique<staging_ring_buffer>(64 * 1024 * 1024);
+		}
+		return *mStagingRing;
+	}
+
 	glm::uvec2 context_vulkan::get_resolution_for_window(window* aWindow)
 	{
 		auto srfCaps = mPhysicalDevice.getSurfaceCapabilitiesKHR(aWindow->surface());
@@ -26,7 +26,11 @@ namespace gvk
 		{
 			for (auto& r : image_data_implementors)
 			{
-				r->load();
+				// The faces have already been loaded by load_image_data_from_file in the constructor
+				if (r->empty())
+				{
+					r->load();
+				}
 
 				assert(!r->empty());
 				assert(r->layers() == 1);
@@ -283,6 +287,157 @@ namespace gvk
 		gli::texture gliTex;
 	};
 
+	/** Implementation of image_data_implementor interface for loading KTX2 files, including files with Zstandard-supercompressed levels
+	*/
+	class image_data_ktx2 : public image_data_implementor
+	{
+	public:
+		explicit image_data_ktx2(const std::string& aPath, const bool aLoadHdrIfPossible = false, const bool aLoadSrgbIfApplicable = false, const bool aFlip = false, const int aPreferredNumberOfTextureComponents = 4)
+			: image_data_implementor(aPath, aLoadHdrIfPossible, aLoadSrgbIfApplicable, aFlip, aPreferredNumberOfTextureComponents)
+		{
+		}
+
+		void load()
+		{
+			// The format is taken from the file, i.e. HDR and sRGB preferences and the number of components do not apply
+			mFile = std::make_unique<ktx2_file>(path());
+
+			// Read the levels one after the other into a single allocation
+			mLevelOffsets.clear();
+			size_t totalSize = 0;
+			for (uint32_t level = 0; level < mFile->levels(); ++level)
+			{
+				mLevelOffsets.push_back(totalSize);
+				totalSize += mFile->level_size(level);
+			}
+			allocate(totalSize);
+			for (uint32_t level = 0; level < mFile->levels(); ++level)
+			{
+				mFile->read_level(level, mMemory.subspan(mLevelOffsets[level], mFile->level_size(level)));
+			}
+
+			if (mFlip)
+			{
+				if (can_flip())
+				{
+					flip();
+				}
+				else
+				{
+					LOG_WARNING(fmt::format("The KTX2 file '{}' cannot be flipped, because its format is block-compressed or it is not a 2D texture.", path()));
+				}
+			}
+		}
+
+		vk::Format get_format() const
+		{
+			return mFile->format();
+		};
+
+		vk::ImageType target() const
+		{
+			return mFile->target();
+		}
+
+		extent_type extent(const uint32_t level = 0) const
+		{
+			return mFile->extent(level);
+		};
+
+		void* get_data(const uint32_t layer, const uint32_t face, const uint32_t level)
+		{
+			return mMemory.data() + mLevelOffsets[level] + (static_cast<size_t>(layer) * mFile->faces() + face) * mFile->image_size(level);
+		};
+
+		size_t size() const
+		{
+			return mMemory.size();
+		}
+
+		size_t size(const uint32_t level) const
+		{
+			return mFile->image_size(level);
+		}
+
+		uint32_t levels() const
+		{
+			return mFile->levels();
+		};
+
+		uint32_t layers() const
+		{
+			return mFile->layers();
+		};
+
+		uint32_t faces() const
+		{
+			return mFile->faces();
+		};
+
+		bool can_flip() const
+		{
+			return mFile && vk::ImageType::e2D == mFile->target() && !avk::is_block_compressed_format(mFile->format());
+		};
+
+		bool empty() const
+		{
+			return mMemory.empty();
+		};
+
+	protected:
+		// Takes the memory from the output allocator if possible, so that the levels are read straight into it.
+		// Not if the levels are flipped, because that reads them again, and the memory of the output allocator may be slow to read.
+		void allocate(size_t aSize)
+		{
+			if (mOutputAllocator && !(mFlip && can_flip()))
+			{
+				// Every level begins at a multiple of the texel block size if the first one does:
+				const auto alignment = std::lcm<size_t>(16, texel_block_size(mFile->format(), mFile->extent(0), mFile->image_size(0)));
+				if (auto region = mOutputAllocator(aSize, alignment))
+				{
+					mOutput = std::move(region->mOwner);
+					mMemory = region->mMemory;
+					return;
+				}
+			}
+			mData.resize(aSize);
+			mMemory = std::span<std::byte>(mData);
+		}
+
+		void flip()
+		{
+			assert(can_flip());
+
+			std::vector<std::byte> row;
+			for (uint32_t level = 0; level < levels(); ++level)
+			{
+				const auto height = extent(level).height;
+				const size_t rowSize = mFile->image_size(level) / height;
+				row.resize(rowSize);
+				for (uint32_t image = 0; image < layers() * faces(); ++image)
+				{
+					auto* data = mMemory.data() + mLevelOffsets[level] + image * mFile->image_size(level);
+					for (uint32_t y = 0; y < height / 2; ++y)
+					{
+						auto* top = data + y * rowSize;
+						auto* bottom = data + (height - 1 - y) * rowSize;
+						std::memcpy(row.data(), top, rowSize);
+						std::memcpy(top, bottom, rowSize);
+						std::memcpy(bottom, row.data(), rowSize);
+					}
+				}
+			}
+		};
+
+	private:
+		std::unique_ptr<ktx2_file> mFile;
+		std::vector<size_t> mLevelOffsets;
+		// The levels, which are either in mData or in memory from the output allocator
+		std::span<std::byte> mMemory;
+		std::vector<std::byte> mData;
+		std::shared_ptr<void> mOutput;
+	};
+
 	/** Implementation of image_data_implementor interface for loading image files with the stbi image library
 	*/
 	class image_data_stb : public image_data_implementor
@@ -298,24 +453,34 @@ namespace gvk
 
 		void load()
 		{
-			stbi_set_flip_vertically_on_load(mFlip);
+			// Set the flip state only for the current thread, so that multiple images can be decoded concurrently
+			stbi_set_flip_vertically_on_load_thread(mFlip);
 
 			int w = 0, h = 0;
 
 			mLoadHdrIfPossible = mLoadHdrIfPossible && stbi_is_hdr(path().c_str());
+			sizeofPixelPerChannel = mLoadHdrIfPossible ? sizeof(float) : sizeof(stbi_uc);
+
+			// If memory is provided for the image, it is decoded with the components which are stored in the file, and then expanded
+			// to the preferred number of components straight into the provided memory, instead of into another allocation of stb_image:
+			std::optional<image_data_output_region> output;
+			if (mOutputAllocator && stbi_info(path().c_str(), &w, &h, &mChannelsInFile))
+			{
+				const size_t texelSize = mPreferredNumberOfTextureComponents * sizeofPixelPerChannel;
+				output = mOutputAllocator(static_cast<size_t>(w) * h * texelSize, std::lcm<size_t>(16, texelSize));
+			}
+			const int desiredChannels = output.has_value() ? 0 : map_to_stbi_channels(mPreferredNumberOfTextureComponents);
 
 			// TODO: load 16 bit per channel files?
 			if (mLoadHdrIfPossible)
 			{
-				void* data = stbi_loadf(path().c_str(), &w, &h, &mChannelsInFile, map_to_stbi_channels(mPreferredNumberOfTextureComponents));
+				void* data = stbi_loadf(path().c_str(), &w, &h, &mChannelsInFile, desiredChannels);
 				mData = std::unique_ptr<void, decltype(&deleter)>(data, &deleter);
-				sizeofPixelPerChannel = sizeof(float);
 			}
 			else
 			{
-				void* data = stbi_load(path().c_str(), &w, &h, &mChannelsInFile, map_to_stbi_channels(mPreferredNumberOfTextureComponents));
+				void* data = stbi_load(path().c_str(), &w, &h, &mChannelsInFile, desiredChannels);
 				mData = std::unique_ptr<void, decltype(&deleter)>(data, &deleter);
-				sizeofPixelPerChannel = sizeof(stbi_uc);
 			}
 
 			if (!mData) {
@@ -328,6 +493,23 @@ namespace gvk
 			mExtent = vk::Extent3D(w, h, 1);
 
 			mFormat = select_format(mPreferredNumberOfTextureComponents, mLoadHdrIfPossible, mLoadSrgbIfApplicable);
+
+			if (output.has_value())
+			{
+				assert(output->mMemory.size() == size());
+				const auto numTexels = static_cast<size_t>(w) * h;
+				if (mLoadHdrIfPossible)
+				{
+					convert_components(static_cast<const float*>(mData.get()), mChannelsInFile, reinterpret_cast<float*>(output->mMemory.data()), mPreferredNumberOfTextureComponents, numTexels, 1.0f);
+				}
+				else
+				{
+					convert_components(static_cast<const stbi_uc*>(mData.get()), mChannelsInFile, reinterpret_cast<stbi_uc*>(output->mMemory.data()), mPreferredNumberOfTextureComponents, numTexels, stbi_uc{ 255 });
+				}
+				// Only the expanded image is kept:
+				mData.reset();
+				mOutput = std::move(*output);
+			}
 		};
 
 		vk::Format get_format() const
@@ -354,7 +536,7 @@ namespace gvk
 			// stb_image does not support layers, faces or levels
 			assert(layer == 0 && face == 0 && level == 0);
 
-			return mData.get();
+			return mOutput.mMemory.empty() ? mData.get() : mOutput.mMemory.data();
 		};
 
 		size_t size() const
@@ -371,10 +553,60 @@ namespace gvk
 
 		bool empty() const
 		{
-			return mData == nullptr;
+			return mData == nullptr && mOutput.mMemory.empty();
 		};
 
 	private:
+		/** Convert texels between numbers of components like stb_image does, i.e. grey values are replicated into RGB, RGB is converted to luminance, and missing alpha values are opaque
+		* @param aSrc				the tightly packed source texels
+		* @param aSrcComponents		the number of components of the source texels, must be 1, 2, 3, or 4
+		* @param aDst				the memory for the tightly packed destination texels
+		* @param aDstComponents		the number of components of the destination texels, must be 1, 2, 3, or 4
+		* @param aNumTexels			the number of texels
+		* @param aOpaque			the alpha value of opaque texels
+		*/
+		template <typename T>
+		static void convert_components(const T* aSrc, const int aSrcComponents, T* aDst, const int aDstComponents, const size_t aNumTexels, const T aOpaque)
+		{
+			if (aSrcComponents == aDstComponents)
+			{
+				std::memcpy(aDst, aSrc, aNumTexels * aDstComponents * sizeof(T));
+				return;
+			}
+
+			const bool srcIsGrey = aSrcComponents < 3;
+			const bool srcHasAlpha = 2 == aSrcComponents || 4 == aSrcComponents;
+			for (size_t i = 0; i < aNumTexels; ++i, aSrc += aSrcComponents, aDst += aDstComponents)
+			{
+				if (aDstComponents < 3)
+				{
+					if (srcIsGrey)
+					{
+						aDst[0] = aSrc[0];
+					}
+					else if constexpr (std::is_floating_point_v<T>)
+					{
+						aDst[0] = (aSrc[0] * 77 + aSrc[1] * 150 + aSrc[2] * 29) / 256;
+					}
+					else
+					{
+						// Same weights as stbi__compute_y
+						aDst[0] = static_cast<T>((aSrc[0] * 77 + aSrc[1] * 150 + aSrc[2] * 29) >> 8);
+					}
+				}
+				else
+				{
+					aDst[0] = aSrc[0];
+					aDst[1] = aSrc[srcIsGrey ? 0 : 1];
+					aDst[2] = aSrc[srcIsGrey ? 0 : 2];
+				}
+				if (2 == aDstComponents || 4 == aDstComponents)
+				{
+					aDst[aDstComponents - 1] = srcHasAlpha ? aSrc[aSrcComponents - 1] : aOpaque;
+				}
+			}
+		}
+
 		/** Map preferred number of texture components to stbi channels
 		* @param aPreferredNumberOfTextureComponents the preferred number of texture components, must be 1, 2, 3, or 4. 
 		* @return the stbi internal constant that represents the given number of texture components
@@ -479,18 +711,32 @@ namespace gvk
 		vk::Format mFormat;
 
 		std::unique_ptr<void, decltype(&deleter)> mData;
+		// The texels if they have been expanded into memory from the output allocator, in which case mData is empty
+		image_data_output_region mOutput;
 	};
 
-	std::unique_ptr<image_data_implementor> image_data_interface::load_image_data_from_file(const std::string& aPath, const bool aLoadHdrIfPossible, const bool aLoadSrgbIfApplicable, const bool aFlip, const int aPreferredNumberOfTextureComponents)
+	std::unique_ptr<image_data_implementor> image_data_interface::load_image_data_from_file(const std::string& aPath, const bool aLoadHdrIfPossible, const bool aLoadSrgbIfApplicable, const bool aFlip, const int aPreferredNumberOfTextureComponents, const image_data_output_allocator& aOutputAllocator)
 	{
+		std::unique_ptr<image_data_implementor> retval;
+
+		// KTX2 files are not supported by GLI
+		if (ktx2_file::has_ktx2_identifier(aPath))
+		{
+			retval = std::unique_ptr<image_data_implementor>(new image_data_ktx2(aPath, aLoadHdrIfPossible, aLoadSrgbIfApplicable, aFlip, aPreferredNumberOfTextureComponents));
+			retval->set_output_allocator(aOutputAllocator);
+			retval->load();
+			return retval;
+		}
+
 		// try loading with GLI
-		std::unique_ptr<image_data_implementor> retval(new image_data_gli(aPath, aLoadHdrIfPossible, aLoadSrgbIfApplicable, aFlip, aPreferredNumberOfTextureComponents));
+		retval = std::unique_ptr<image_data_implementor>(new image_data_gli(aPath, aLoadHdrIfPossible, aLoadSrgbIfApplicable, aFlip, aPreferredNumberOfTextureComponents));
 		retval->load();
 
 		// try loading with stb
 		if (retval->empty())
 		{
 			retval = std::unique_ptr<image_data_implementor>(new image_data_stb(aPath, aLoadHdrIfPossible, aLoadSrgbIfApplicable, aFlip, aPreferredNumberOfTextureComponents));
+			retval->set_output_allocator(aOutputAllocator);
 			retval->load();
 		}
 
@@ -509,5 +755,156 @@ namespace gvk
 
 		return retval;
 	}
-	
+
+	void image_data::generate_mip_chain(const mip_generation_config& aConfig)
+	{
+		assert(!empty());
+
+		if (levels() > 1 || layers() != 1 || !can_generate_mip_chain_on_cpu(get_format()))
+		{
+			return;
+		}
+
+		std::vector<std::vector<mip_level>> generatedLevels;
+		for (uint32_t face = 0; face < faces(); ++face)
+		{
+			generatedLevels.push_back(gvk::generate_mip_chain(get_data(0, face, 0), extent(0), get_format(), aConfig));
+		}
+		if (!generatedLevels[0].empty())
+		{
+			mGeneratedLevels = std::move(generatedLevels);
+		}
+	}
+
+	void image_data::downscale(uint32_t aMaxExtent, mip_filter aFilter)
+	{
+		assert(!empty());
+
+		auto exceeds = [aMaxExtent](const extent_type& aExtent) {
+			return aExtent.width > aMaxExtent || aExtent.height > aMaxExtent;
+		};
+		const auto extent0 = extent(0);
+		if (!exceeds(extent0) || layers() != 1 || vk::ImageType::e2D != target())
+		{
+			return;
+		}
+
+		std::vector<std::vector<mip_level>> downscaledLevels;
+		if (levels() > 1)
+		{
+			// Drop the finest levels, but keep at least the coarsest one:
+			uint32_t firstLevel = 0;
+			while (firstLevel + 1 < levels() && exceeds(extent(firstLevel)))
+			{
+				++firstLevel;
+			}
+			for (uint32_t face = 0; face < faces(); ++face)
+			{
+				auto& faceLevels = downscaledLevels.emplace_back();
+				for (uint32_t level = firstLevel; level < levels(); ++level)
+				{
+					const auto* data = static_cast<const std::byte*>(get_data(0, face, level));
+					faceLevels.push_back(mip_level{ extent(level), std::vector<std::byte>(data, data + size(level)) });
+				}
+			}
+		}
+		else if (can_generate_mip_chain_on_cpu(get_format()))
+		{
+			// Scale the longer side to aMaxExtent, and the shorter side proportionally:
+			const auto scale = static_cast<double>(aMaxExtent) / static_cast<double>(std::max(extent0.width, extent0.height));
+			const extent_type targetExtent{
+				std::clamp(static_cast<uint32_t>(std::lround(extent0.width * scale)), 1u, aMaxExtent),
+				std::clamp(static_cast<uint32_t>(std::lround(extent0.height * scale)), 1u, aMaxExtent),
+				1u
+			};
+			for (uint32_t face = 0; face < faces(); ++face)
+			{
+				downscaledLevels.emplace_back().push_back(mip_level{ targetExtent, resample_image(get_data(0, face, 0), extent0, get_format(), targetExtent, aFilter) });
+			}
+		}
+		else
+		{
+			return;
+		}
+
+		if (!mCompressedLevels.empty())
+		{
+			mCompressedLevels = std::move(downscaledLevels);
+		}
+		else
+		{
+			mDownscaledLevels = std::move(downscaledLevels);
+			mGeneratedLevels.clear();
+		}
+	}
+
+	void image_data::compress(texture_compression aCompression)
+	{
+		assert(!empty());
+
+		if (texture_compression::none == aCompression || layers() != 1 || !can_compress_texture(get_format()))
+		{
+			return;
+		}
+
+		const auto compressedFormat = compressed_format_for(aCompression, get_format());
+		std::vector<std::vector<mip_level>> compressedLevels;
+		for (uint32_t face = 0; face < faces(); ++face)
+		{
+			auto& faceLevels = compressedLevels.emplace_back();
+			for (uint32_t level = 0; level < levels(); ++level)
+			{
+				faceLevels.push_back(mip_level{ extent(level), compress_texture(get_data(0, face, level), extent(level), get_format(), aCompression) });
+			}
+		}
+		mCompressedLevels = std::move(compressedLevels);
+		mCompressedFormat = compressedFormat;
+		// The uncompressed levels are not needed anymore:
+		mGeneratedLevels.clear();
+	}
+
+	void load_image_data_in_parallel(std::span<image_data> aImageData, std::optional<mip_generation_config> aMipChainConfig, size_t aNumThreads, std::span<const std::optional<uint32_t>> aMaxExtents, mip_filter aDownscaleFilter)
+	{
+		assert(aMaxExtents.empty() || aMaxExtents.size() == aImageData.size());
+		parallel_for(aImageData.size(), [&](size_t i)
+		{
+			aImageData[i].load();
+			if (!aMaxExtents.empty() && aMaxExtents[i].has_value())
+			{
+				aImageData[i].downscale(*aMaxExtents[i], aDownscaleFilter);
+			}
+			if (aMipChainConfig.has_value())
+			{
+				aImageData[i].generate_mip_chain(*aMipChainConfig);
+			}
+		}, aNumThreads);
+	}
+
+	std::optional<vk::Extent3D> query_image_extent(const std::string& aPath)
+	{
+		if (ktx2_file::has_ktx2_identifier(aPath))
+		{
+			try {
+				return ktx2_file(aPath).extent(0);
+			}
+			catch (const gvk::runtime_error& e) {
+				LOG_WARNING(fmt::format("Unable to query the extent of '{}': {}", aPath, e.what()));
+				return {};
+			}
+		}
+
+		int w, h, comp;
+		if (stbi_info(aPath.c_str(), &w, &h, &comp))
+		{
+			return vk::Extent3D{ static_cast<uint32_t>(w), static_cast<uint32_t>(h), 1u };
+		}
+
+		const auto gliTex = gli::load(aPath);
+		if (!gliTex.empty())
+		{
+			const auto e = gliTex.extent(0);
+			return vk::Extent3D(e[0], e[1], e[2]);
+		}
+		return {};
+	}
 }
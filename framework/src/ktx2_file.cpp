@@ -0,0 +1,182 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	namespace
+	{
+		// «KTX 20»\r\n\x1A\n
+		constexpr std::array<uint8_t, 12> sKtx2Identifier = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+		// Sizes of the parts of the file before the level index: identifier, header, and index of the data format descriptor, key/value data, and supercompression global data
+		constexpr size_t sHeaderSize = sKtx2Identifier.size() + 9 * sizeof(uint32_t);
+		constexpr size_t sIndexSize = 4 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+		constexpr size_t sLevelIndexEntrySize = 3 * sizeof(uint64_t);
+
+		// Color models of the data format descriptor, which identify universal textures
+		constexpr uint8_t sColorModelEtc1s = 163;
+		constexpr uint8_t sColorModelUastc = 166;
+
+		// The number of texel blocks of one image of the given extent, like in texel_block_size
+		uint64_t number_of_texel_blocks(vk::Format aFormat, vk::Extent3D aExtent)
+		{
+			if (avk::is_block_compressed_format(aFormat)) {
+				return static_cast<uint64_t>((aExtent.width + 3) / 4) * ((aExtent.height + 3) / 4) * aExtent.depth;
+			}
+			return static_cast<uint64_t>(aExtent.width) * aExtent.height * aExtent.depth;
+		}
+
+		template <typename T>
+		T read_value(std::span<const std::byte> aData, size_t aOffset)
+		{
+			T value;
+			std::memcpy(&value, aData.data() + aOffset, sizeof(T));
+			return value;
+		}
+	}
+
+	ktx2_file::ktx2_file(std::string_view aPath)
+		: mPath{ aPath }
+		, mFile{ aPath }
+	{
+		const auto data = mFile.span();
+		if (data.size() < sHeaderSize + sIndexSize || 0 != std::memcmp(data.data(), sKtx2Identifier.data(), sKtx2Identifier.size())) {
+			throw gvk::runtime_error(fmt::format("'{}' is not a KTX2 file.", mPath));
+		}
+
+		size_t offset = sKtx2Identifier.size();
+		const auto vkFormat = read_value<uint32_t>(data, offset);
+		const auto pixelWidth = read_value<uint32_t>(data, offset + 8);
+		const auto pixelHeight = read_value<uint32_t>(data, offset + 12);
+		const auto pixelDepth = read_value<uint32_t>(data, offset + 16);
+		const auto layerCount = read_value<uint32_t>(data, offset + 20);
+		const auto faceCount = read_value<uint32_t>(data, offset + 24);
+		const auto levelCount = read_value<uint32_t>(data, offset + 28);
+		const auto supercompressionScheme = read_value<uint32_t>(data, offset + 32);
+		offset = sHeaderSize;
+		const auto dfdByteOffset = read_value<uint32_t>(data, offset);
+		const auto dfdByteLength = read_value<uint32_t>(data, offset + 4);
+
+		mFormat = static_cast<vk::Format>(vkFormat);
+		// Unused dimensions are 0 in the file, and stay 0 in mExtent to distinguish e.g. 2D textures from 3D textures with a depth of 1:
+		mExtent = vk::Extent3D{ pixelWidth, pixelHeight, pixelDepth };
+		mLayers = std::max(layerCount, 1u);
+		mFaces = faceCount;
+		mSupercompression = static_cast<ktx2_supercompression>(supercompressionScheme);
+		if (0 == pixelWidth || (0 == pixelHeight && 0 != pixelDepth) || (1 != faceCount && 6 != faceCount)) {
+			throw gvk::runtime_error(fmt::format("The header of the KTX2 file '{}' is invalid.", mPath));
+		}
+
+		// A level count of 0 means that only level 0 is stored, and that the application should generate the other levels
+		const uint32_t numLevels = std::max(levelCount, 1u);
+		// A full MIP chain ends with a 1x1x1 level, i.e. it has 1 + floor(log2(largest dimension)) levels:
+		const auto maxNumLevels = static_cast<uint32_t>(std::bit_width(std::max({ pixelWidth, pixelHeight, pixelDepth })));
+		if (numLevels > maxNumLevels) {
+			throw gvk::runtime_error(fmt::format("The KTX2 file '{}' has {} levels, but an extent of {}x{}x{} allows for at most {}.", mPath, numLevels, pixelWidth, pixelHeight, pixelDepth, maxNumLevels));
+		}
+		if (data.size() < sHeaderSize + sIndexSize + numLevels * sLevelIndexEntrySize) {
+			throw gvk::runtime_error(fmt::format("The KTX2 file '{}' is truncated.", mPath));
+		}
+		offset = sHeaderSize + sIndexSize;
+		for (uint32_t level = 0; level < numLevels; ++level) {
+			auto& entry = mLevelIndex.emplace_back(level_index_entry{
+				read_value<uint64_t>(data, offset),
+				read_value<uint64_t>(data, offset + 8),
+				read_value<uint64_t>(data, offset + 16)
+			});
+			offset += sLevelIndexEntrySize;
+			if (entry.mByteOffset > data.size() || entry.mByteLength > data.size() - entry.mByteOffset) {
+				throw gvk::runtime_error(fmt::format("The level index of the KTX2 file '{}' is invalid.", mPath));
+			}
+		}
+
+		// Only levels which can be copied or decompressed into their Vulkan format are supported:
+		if (vk::Format::eUndefined == mFormat) {
+			uint8_t colorModel = 0;
+			if (dfdByteLength >= 16 && dfdByteOffset <= data.size() - 16) {
+				// The color model follows the total size, the vendor and descriptor type, and the version and block size of the first descriptor block
+				colorModel = read_value<uint8_t>(data, dfdByteOffset + 12);
+			}
+			if (sColorModelUastc == colorModel || sColorModelEtc1s == colorModel) {
+				throw gvk::runtime_error(fmt::format("The KTX2 file '{}' is in the universal {} format, which has to be transcoded with Basis Universal. "
+					"Transcode it into a BC format in advance, e.g. with 'ktx transcode --target bc7'.", mPath, sColorModelUastc == colorModel ? "UASTC" : "ETC1S"));
+			}
+			throw gvk::runtime_error(fmt::format("The KTX2 file '{}' does not specify a Vulkan format.", mPath));
+		}
+		if (ktx2_supercompression::none != mSupercompression && ktx2_supercompression::zstd != mSupercompression) {
+			throw gvk::runtime_error(fmt::format("The KTX2 file '{}' is supercompressed with scheme {}, but only Zstandard supercompression is supported.", mPath, supercompressionScheme));
+		}
+
+		// The size of a texel block is stored in bytesPlane0 of the data format descriptor, which follows the texel block
+		// dimensions. It may be 0 for supercompressed files, in which case it is derived from the size of level 0:
+		const uint64_t imagesPerLevel = static_cast<uint64_t>(mLayers) * mFaces;
+		uint64_t blockSize = 0;
+		if (dfdByteLength >= 24 && dfdByteOffset <= data.size() - 24) {
+			blockSize = read_value<uint8_t>(data, dfdByteOffset + 20);
+		}
+		if (0 == blockSize) {
+			blockSize = texel_block_size(mFormat, extent(0), static_cast<size_t>(mLevelIndex[0].mUncompressedByteLength / imagesPerLevel));
+		}
+		for (uint32_t level = 0; level < numLevels; ++level) {
+			// Every level has to contain exactly the texel blocks of all its layers and faces, since levels are copied into
+			// staging memory whose size is computed from the level index:
+			const auto& entry = mLevelIndex[level];
+			if (entry.mUncompressedByteLength != blockSize * number_of_texel_blocks(mFormat, extent(level)) * imagesPerLevel
+				|| (ktx2_supercompression::none == mSupercompression && entry.mByteLength != entry.mUncompressedByteLength)) {
+				throw gvk::runtime_error(fmt::format("The size of level {} in the level index of the KTX2 file '{}' does not match its format and extent.", level, mPath));
+			}
+		}
+	}
+
+	bool ktx2_file::has_ktx2_identifier(std::string_view aPath)
+	{
+		std::ifstream file(std::filesystem::path(aPath), std::ios::binary);
+		std::array<uint8_t, sKtx2Identifier.size()> identifier = {};
+		file.read(reinterpret_cast<char*>(identifier.data()), identifier.size());
+		return file.gcount() == static_cast<std::streamsize>(identifier.size()) && sKtx2Identifier == identifier;
+	}
+
+	vk::ImageType ktx2_file::target() const
+	{
+		if (0 != mExtent.depth) {
+			return vk::ImageType::e3D;
+		}
+		return 0 != mExtent.height ? vk::ImageType::e2D : vk::ImageType::e1D;
+	}
+
+	vk::Extent3D ktx2_file::extent(uint32_t aLevel) const
+	{
+		assert(aLevel < levels());
+		return vk::Extent3D{
+			std::max(mExtent.width >> aLevel, 1u),
+			std::max(mExtent.height >> aLevel, 1u),
+			std::max(mExtent.depth >> aLevel, 1u)
+		};
+	}
+
+	size_t ktx2_file::image_size(uint32_t aLevel) const
+	{
+		return level_size(aLevel) / (static_cast<size_t>(mLayers) * mFaces);
+	}
+
+	size_t ktx2_file::level_size(uint32_t aLevel) const
+	{
+		assert(aLevel < levels());
+		return static_cast<size_t>(mLevelIndex[aLevel].mUncompressedByteLength);
+	}
+
+	void ktx2_file::read_level(uint32_t aLevel, std::span<std::byte> aDestination) const
+	{
+		assert(aLevel < levels());
+		const auto& entry = mLevelIndex[aLevel];
+		if (aDestination.size() != entry.mUncompressedByteLength) {
+			throw gvk::logic_error(fmt::format("Level {} of '{}' has a size of {} bytes, but the destination has {} bytes.", aLevel, mPath, entry.mUncompressedByteLength, aDestination.size()));
+		}
+		const auto stored = mFile.span().subspan(static_cast<size_t>(entry.mByteOffset), static_cast<size_t>(entry.mByteLength));
+		if (ktx2_supercompression::zstd == mSupercompression) {
+			zstd_decompress(stored, aDestination);
+		}
+		else {
+			std::memcpy(aDestination.data(), stored.data(), stored.size());
+		}
+	}
+}
@@ -2,6 +2,27 @@
 
 namespace gvk
 {
+	// Stores the hash of the files which an image is loaded from, and of the parameters of loading them, in the cache file,
+	// and compares it with the current files when reading the cache file, so that stale images are not used silently.
+	// If the files do not exist when reading the cache file, e.g. because only the cache file is shipped, it is trusted.
+	static void archive_source_files_hash(gvk::serializer& aSerializer, const std::vector<std::string>& aPaths, bool aLoadHdrIfPossible, bool aLoadSrgbIfApplicable, bool aFlip, int aPreferredNumberOfTextureComponents)
+	{
+		const bool filesExist = std::all_of(std::begin(aPaths), std::end(aPaths), [](const std::string& path) { return std::filesystem::exists(path); });
+		uint64_t currentHash = 0;
+		if (filesExist || aSerializer.mode() == gvk::serializer::mode::serialize) {
+			content_hash hash;
+			for (const auto& path : aPaths) {
+				hash.add_file(path, file_hash_mode::timestamp_and_size);
+			}
+			currentHash = hash.add(aLoadHdrIfPossible).add(aLoadSrgbIfApplicable).add(aFlip).add(aPreferredNumberOfTextureComponents).value();
+		}
+		auto storedHash = currentHash;
+		aSerializer.archive(storedHash);
+		if (filesExist && storedHash != currentHash) {
+			throw gvk::runtime_error(fmt::format("The image file '{}' (or one of the files of its cube map) has changed since the cache file has been written. Please delete the existing cache file and let it be recreated!", aPaths.front()));
+		}
+	}
+
 	avk::image create_cubemap_from_image_data_cached(image_data& aImageData, avk::memory_usage aMemoryUsage, avk::image_usage aImageUsage, avk::sync aSyncHandler, std::optional<std::reference_wrapper<gvk::serializer>> aSerializer)
 	{
 		// image must have flag set to be used for cube map
@@ -13,6 +34,9 @@ namespace gvk
 	avk::image create_cubemap_from_file_cached(const std::string& aPath, bool aLoadHdrIfPossible, bool aLoadSrgbIfApplicable, bool aFlip,
 		int aPreferredNumberOfTextureComponents, avk::memory_usage aMemoryUsage, avk::image_usage aImageUsage, avk::sync aSyncHandler, std::optional<std::reference_wrapper<gvk::serializer>> aSerializer)
 	{
+		if (aSerializer) {
+			archive_source_files_hash(aSerializer->get(), { aPath }, aLoadHdrIfPossible, aLoadSrgbIfApplicable, aFlip, aPreferredNumberOfTextureComponents);
+		}
 		auto cubemapImageData = get_image_data(aPath, aLoadHdrIfPossible, aLoadSrgbIfApplicable, aFlip, aPreferredNumberOfTextureComponents);
 
 		return create_cubemap_from_image_data_cached(cubemapImageData, aMemoryUsage, aImageUsage, std::move(aSyncHandler), aSerializer);
@@ -21,6 +45,9 @@ namespace gvk
 	avk::image create_cubemap_from_file_cached(const std::vector<std::string>& aPaths, bool aLoadHdrIfPossible, bool aLoadSrgbIfApplicable, bool aFlip,
 		int aPreferredNumberOfTextureComponents, avk::memory_usage aMemoryUsage, avk::image_usage aImageUsage, avk::sync aSyncHandler, std::optional<std::reference_wrapper<gvk::serializer>> aSerializer)
 	{
+		if (aSerializer) {
+			archive_source_files_hash(aSerializer->get(), aPaths, aLoadHdrIfPossible, aLoadSrgbIfApplicable, aFlip, aPreferredNumberOfTextureComponents);
+		}
 		auto cubemapImageData = get_image_data(aPaths, aLoadHdrIfPossible, aLoadSrgbIfApplicable, aFlip, aPreferredNumberOfTextureComponents);
 
 		return create_cubemap_from_image_data_cached(cubemapImageData, aMemoryUsage, aImageUsage, std::move(aSyncHandler), aSerializer);
@@ -41,6 +68,12 @@ namespace gvk
 
 			assert(!aImageData.empty());
 
+			// Generate the MIP-maps on the CPU if possible, so that they are stored in the cache file along with the base level,
+			// and do not have to be blitted on every run. Does nothing if aImageData already contains MIP-maps.
+			if ((static_cast<int>(aImageUsage) & static_cast<int>(avk::image_usage::mip_mapped)) > 0) {
+				aImageData.generate_mip_chain();
+			}
+
 			if (aImageData.target() != vk::ImageType::e2D) {
 				throw gvk::runtime_error(fmt::format("The image loaded from '{}' is not intended to be used as 2D image. Can't load it.", aImageData.path()));
 			}
@@ -117,6 +150,9 @@ namespace gvk
 		// 2. Copy buffer to image
 		// Load all Mipmap levels from file, or load only the base level and generate other levels from that
 
+		// The staging memory is taken from the context's ring buffer, and only if it is full, from dedicated staging buffers:
+		auto& stagingRing = context().staging_ring();
+		std::vector<std::shared_ptr<void>> stagingLeases;
 		std::vector<avk::buffer> stagingBuffers;
 
 		// TODO: Do we have to account for gliTex.base_level() and gliTex.max_level()?
@@ -151,26 +187,56 @@ namespace gvk
 				}
 #endif
 
-				auto& sb = stagingBuffers.emplace_back(context().create_buffer(
-					AVK_STAGING_BUFFER_MEMORY_USAGE,
-					vk::BufferUsageFlagBits::eTransferSrc,
-					avk::generic_buffer_meta::create_from_size(texSize)
-				));
-
-				if (!aSerializer) {
-					sb->fill(texData, 0, avk::sync::not_required());
+				// If the image data has been decoded into the ring buffer (see image_data::set_output_allocator), it does not have to be copied again:
+				auto staging = nullptr == texData ? std::optional<staging_allocation>{} : stagingRing.find(texData, texSize);
+				const bool isInStagingMemory = staging.has_value();
+				if (!staging.has_value()) {
+					staging = stagingRing.allocate(texSize, std::lcm<size_t>(16, texel_block_size(format, levelExtent, texSize)));
 				}
-				else if (aSerializer && aSerializer->get().mode() == gvk::serializer::mode::serialize) {
-					sb->fill(texData, 0, avk::sync::not_required());
-					aSerializer->get().archive_memory(texData, texSize);
+
+				if (staging.has_value()) {
+					if (!aSerializer) {
+						if (!isInStagingMemory) {
+							std::memcpy(staging->mMemory.data(), texData, texSize);
+						}
+					}
+					else if (aSerializer && aSerializer->get().mode() == gvk::serializer::mode::serialize) {
+						if (!isInStagingMemory) {
+							std::memcpy(staging->mMemory.data(), texData, texSize);
+						}
+						aSerializer->get().archive_memory(texData, texSize);
+					}
+					else if (aSerializer && aSerializer->get().mode() == gvk::serializer::mode::deserialize) {
+						aSerializer->get().archive_memory(staging->mMemory.data(), texSize);
+						LOG_INFO_EM("Buffer loaded from cache");
+					}
+
+					// Memory writes are not overlapping => no barriers should be fine.
+					stagingRing.record_copy_to_image_layer_mip_level(commandBuffer, *staging, img.get(), face, level);
+					stagingLeases.push_back(std::move(staging->mLease));
 				}
-				else if (aSerializer && aSerializer->get().mode() == gvk::serializer::mode::deserialize) {
-					aSerializer->get().archive_buffer(sb);
-					LOG_INFO_EM("Buffer loaded from cache");
+				else {
+					auto& sb = stagingBuffers.emplace_back(context().create_buffer(
+						AVK_STAGING_BUFFER_MEMORY_USAGE,
+						vk::BufferUsageFlagBits::eTransferSrc,
+						avk::generic_buffer_meta::create_from_size(texSize)
+					));
+
+					if (!aSerializer) {
+						sb->fill(texData, 0, avk::sync::not_required());
+					}
+					else if (aSerializer && aSerializer->get().mode() == gvk::serializer::mode::serialize) {
+						sb->fill(texData, 0, avk::sync::not_required());
+						aSerializer->get().archive_memory(texData, texSize);
+					}
+					else if (aSerializer && aSerializer->get().mode() == gvk::serializer::mode::deserialize) {
+						aSerializer->get().archive_buffer(sb);
+						LOG_INFO_EM("Buffer loaded from cache");
+					}
+
+					// Memory writes are not overlapping => no barriers should be fine.
+					avk::copy_buffer_to_image_layer_mip_level(avk::const_referenced(sb), avk::referenced(img), face, level, {}, avk::sync::auxiliary_with_barriers(aSyncHandler, {}, {}));
 				}
-
-				// Memory writes are not overlapping => no barriers should be fine.
-				avk::copy_buffer_to_image_layer_mip_level(avk::const_referenced(sb), avk::referenced(img), face, level, {}, avk::sync::auxiliary_with_barriers(aSyncHandler, {}, {}));
 				// There should be no need to make any memory available or visible, the transfer-execution dependency chain should be fine
 				// TODO: Verify the above ^ comment
 			}
@@ -185,7 +251,8 @@ namespace gvk
 			img->generate_mip_maps(avk::sync::auxiliary_with_barriers(aSyncHandler, {}, {}));
 		}
 
-		commandBuffer.set_custom_deleter([lOwnedStagingBuffers = std::move(stagingBuffers)](){});
+		// The ring buffer's regions are recycled when the leases are destroyed along with the command buffer:
+		commandBuffer.set_custom_deleter([lOwnedStagingBuffers = std::move(stagingBuffers), lStagingLeases = std::move(stagingLeases)](){});
 
 		// 3. Transition image layout to its target layout and handle lifetime of things via sync
 		img->transition_to_layout(finalTargetLayout, avk::sync::auxiliary_with_barriers(aSyncHandler, {}, {}));
@@ -198,11 +265,29 @@ namespace gvk
 
 	avk::image create_image_from_file_cached(const std::string& aPath, bool aLoadHdrIfPossible, bool aLoadSrgbIfApplicable, bool aFlip, int aPreferredNumberOfTextureComponents, avk::memory_usage aMemoryUsage, avk::image_usage aImageUsage, avk::sync aSyncHandler, std::optional<std::reference_wrapper<gvk::serializer>> aSerializer)
 	{
+		if (aSerializer) {
+			archive_source_files_hash(aSerializer->get(), { aPath }, aLoadHdrIfPossible, aLoadSrgbIfApplicable, aFlip, aPreferredNumberOfTextureComponents);
+		}
 		auto imageData = get_image_data(aPath, aLoadHdrIfPossible, aLoadSrgbIfApplicable, aFlip, aPreferredNumberOfTextureComponents);
+		// The image data is only used for this upload => decode it straight into staging memory, unless it is read again afterwards,
+		// i.e. when MIP-maps are generated from it or it is serialized, since staging memory is typically write-combined and slow to read:
+		if (!aSerializer && (static_cast<int>(aImageUsage) & static_cast<int>(avk::image_usage::mip_mapped)) == 0) {
+			imageData.set_output_allocator(context().staging_ring().output_allocator());
+		}
 
 		return gvk::create_image_from_image_data_cached(imageData, aMemoryUsage, aImageUsage, std::move(aSyncHandler), aSerializer);
 	}
 
+	std::tuple<compact_material_table, std::vector<avk::image_sampler>> convert_for_gpu_usage_compact(const std::vector<gvk::material_config>& aMaterialConfigs, bool aLoadTexturesInSrgb, bool aFlipTextures, avk::image_usage aImageUsage, avk::filter_mode aTextureFilterMode, avk::sync aSyncHandler, std::optional<texture_compression_config> aTextureCompression, std::optional<texture_resolution_policy> aTextureResolution, std::optional<std::reference_wrapper<texture_registry>> aTextureRegistry, std::optional<texture_packing_config> aTexturePacking)
+	{
+		// Fail before any texture is loaded; array texture indices do not fit into the 16 bits of the compact encoding:
+		if (aTexturePacking.has_value() && aTexturePacking->mMinArrayLayers.has_value()) {
+			throw gvk::logic_error("The textures of compact materials cannot be packed into array textures, i.e. mMinArrayLayers must not be set.");
+		}
+		auto [gpuMaterials, imageSamplers] = convert_for_gpu_usage<material_gpu_data>(aMaterialConfigs, aLoadTexturesInSrgb, aFlipTextures, aImageUsage, aTextureFilterMode, std::move(aSyncHandler), aTextureCompression, aTextureResolution, aTextureRegistry, aTexturePacking);
+		return std::make_tuple(pack_materials(aMaterialConfigs, gpuMaterials), std::move(imageSamplers));
+	}
+
 	std::tuple<std::vector<glm::vec3>, std::vector<uint32_t>> get_vertices_and_indices(const std::vector<std::tuple<avk::resource_reference<const gvk::model_t>, std::vector<mesh_index_t>>>& aModelsAndSelectedMeshes)
 	{
 		std::vector<glm::vec3> positionsData;
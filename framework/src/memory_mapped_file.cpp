@@ -0,0 +1,118 @@
+#include <gvk.hpp>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gvk
+{
+	memory_mapped_file::memory_mapped_file(std::string_view aPath)
+	{
+		const std::string path(aPath);
+#ifdef _WIN32
+		mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (INVALID_HANDLE_VALUE == mFile) {
+			throw gvk::runtime_error(fmt::format("Unable to open file '{}' for memory mapping.", path));
+		}
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(mFile, &fileSize)) {
+			unmap();
+			throw gvk::runtime_error(fmt::format("Unable to determine the size of file '{}'.", path));
+		}
+		mSize = static_cast<size_t>(fileSize.QuadPart);
+		if (0 == mSize) {
+			return;
+		}
+		mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (nullptr == mMapping) {
+			unmap();
+			throw gvk::runtime_error(fmt::format("Unable to create a file mapping for file '{}'.", path));
+		}
+		mData = static_cast<const std::byte*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+		if (nullptr == mData) {
+			unmap();
+			throw gvk::runtime_error(fmt::format("Unable to map file '{}' into memory.", path));
+		}
+#else
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw gvk::runtime_error(fmt::format("Unable to open file '{}' for memory mapping.", path));
+		}
+		struct stat fileStat;
+		if (fstat(fd, &fileStat) != 0) {
+			close(fd);
+			throw gvk::runtime_error(fmt::format("Unable to determine the size of file '{}'.", path));
+		}
+		mSize = static_cast<size_t>(fileStat.st_size);
+		if (0 == mSize) {
+			close(fd);
+			return;
+		}
+		void* mapped = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		// The mapping keeps its own reference to the file:
+		close(fd);
+		if (MAP_FAILED == mapped) {
+			mSize = 0;
+			throw gvk::runtime_error(fmt::format("Unable to map file '{}' into memory.", path));
+		}
+		// Cache files are mostly read front to back => let the kernel read ahead aggressively
+		madvise(mapped, mSize, MADV_SEQUENTIAL);
+		madvise(mapped, mSize, MADV_WILLNEED);
+		mData = static_cast<const std::byte*>(mapped);
+#endif
+	}
+
+	memory_mapped_file::memory_mapped_file(memory_mapped_file&& aOther) noexcept
+		: mData{ std::exchange(aOther.mData, nullptr) }
+		, mSize{ std::exchange(aOther.mSize, 0) }
+#ifdef _WIN32
+		, mFile{ std::exchange(aOther.mFile, INVALID_HANDLE_VALUE) }
+		, mMapping{ std::exchange(aOther.mMapping, nullptr) }
+#endif
+	{ }
+
+	memory_mapped_file& memory_mapped_file::operator=(memory_mapped_file&& aOther) noexcept
+	{
+		if (this != &aOther) {
+			unmap();
+			mData = std::exchange(aOther.mData, nullptr);
+			mSize = std::exchange(aOther.mSize, 0);
+#ifdef _WIN32
+			mFile = std::exchange(aOther.mFile, INVALID_HANDLE_VALUE);
+			mMapping = std::exchange(aOther.mMapping, nullptr);
+#endif
+		}
+		return *this;
+	}
+
+	memory_mapped_file::~memory_mapped_file()
+	{
+		unmap();
+	}
+
+	void memory_mapped_file::unmap()
+	{
+#ifdef _WIN32
+		if (nullptr != mData) {
+			UnmapViewOfFile(mData);
+		}
+		if (nullptr != mMapping) {
+			CloseHandle(mMapping);
+		}
+		if (INVALID_HANDLE_VALUE != mFile) {
+			CloseHandle(mFile);
+		}
+		mMapping = nullptr;
+		mFile = INVALID_HANDLE_VALUE;
+#else
+		if (nullptr != mData) {
+			munmap(const_cast<std::byte*>(mData), mSize);
+		}
+#endif
+		mData = nullptr;
+		mSize = 0;
+	}
+}
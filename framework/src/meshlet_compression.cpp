@@ -0,0 +1,242 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	namespace
+	{
+		// Appends aBytes to aData, padded with zeros to the next uint32 boundary
+		void append_padded_to_words(std::vector<uint32_t>& aData, const std::vector<uint8_t>& aBytes)
+		{
+			const auto wordOffset = aData.size();
+			aData.resize(wordOffset + (aBytes.size() + 3) / 4, 0u);
+			if (!aBytes.empty()) {
+				std::memcpy(aData.data() + wordOffset, aBytes.data(), aBytes.size());
+			}
+		}
+
+		// Returns the rotation of aTriangle which starts with aFirst, aSecond, if there is one
+		std::optional<std::array<uint8_t, 3>> rotation_starting_with(const std::array<uint8_t, 3>& aTriangle, uint8_t aFirst, uint8_t aSecond)
+		{
+			for (int r = 0; r < 3; ++r) {
+				if (aTriangle[r] == aFirst && aTriangle[(r + 1) % 3] == aSecond) {
+					return std::array<uint8_t, 3>{ aTriangle[r], aTriangle[(r + 1) % 3], aTriangle[(r + 2) % 3] };
+				}
+			}
+			return {};
+		}
+
+		// Returns the vertex which continues a strip whose last two entries are aPrev, aLast, if aTriangle can continue it
+		// at the given position. Odd positions within a strip have a swapped winding.
+		std::optional<uint8_t> strip_continuation(const std::array<uint8_t, 3>& aTriangle, uint8_t aPrev, uint8_t aLast, bool aOddPosition)
+		{
+			auto rotated = aOddPosition ? rotation_starting_with(aTriangle, aLast, aPrev) : rotation_starting_with(aTriangle, aPrev, aLast);
+			if (rotated.has_value()) {
+				return rotated.value()[2];
+			}
+			return {};
+		}
+
+		std::vector<uint8_t> encode_strip(const std::vector<std::array<uint8_t, 3>>& aTriangles)
+		{
+			std::vector<uint8_t> strip;
+			strip.reserve(aTriangles.size() * 3);
+			size_t trianglesInStrip = 0;
+			for (size_t t = 0; t < aTriangles.size(); ++t) {
+				const auto& tri = aTriangles[t];
+				if (trianglesInStrip > 0) {
+					auto next = strip_continuation(tri, strip[strip.size() - 2], strip[strip.size() - 1], (trianglesInStrip % 2) == 1);
+					if (next.has_value()) {
+						strip.push_back(next.value());
+						++trianglesInStrip;
+						continue;
+					}
+					strip.push_back(sMeshletStripRestart);
+				}
+
+				// Start a new strip. Pick the rotation that lets the following triangle continue it, if any:
+				auto start = tri;
+				if (t + 1 < aTriangles.size()) {
+					for (int r = 0; r < 3; ++r) {
+						std::array<uint8_t, 3> candidate{ tri[r], tri[(r + 1) % 3], tri[(r + 2) % 3] };
+						if (strip_continuation(aTriangles[t + 1], candidate[1], candidate[2], true).has_value()) {
+							start = candidate;
+							break;
+						}
+					}
+				}
+				strip.insert(std::end(strip), std::begin(start), std::end(start));
+				trianglesInStrip = 1;
+			}
+			return strip;
+		}
+
+		// Triangles with their global vertex indices, each in its lexicographically smallest rotation
+		std::vector<std::array<uint32_t, 3>> canonical_triangles(const meshlet& aMeshlet)
+		{
+			std::vector<std::array<uint32_t, 3>> result;
+			result.reserve(aMeshlet.mIndexCount / 3);
+			for (uint32_t i = 0; i + 2 < aMeshlet.mIndexCount; i += 3) {
+				std::array<uint32_t, 3> tri{ aMeshlet.mVertices[aMeshlet.mIndices[i]], aMeshlet.mVertices[aMeshlet.mIndices[i + 1]], aMeshlet.mVertices[aMeshlet.mIndices[i + 2]] };
+				auto smallest = tri;
+				for (int r = 1; r < 3; ++r) {
+					std::rotate(std::begin(tri), std::begin(tri) + 1, std::end(tri));
+					smallest = std::min(smallest, tri);
+				}
+				result.push_back(smallest);
+			}
+			return result;
+		}
+	}
+
+	std::tuple<std::vector<meshlet_compressed_gpu_data>, std::vector<uint32_t>> encode_meshlets_compressed(const std::vector<meshlet>& aMeshlets, meshlet_index_encoding aIndexEncoding)
+	{
+		std::vector<meshlet_compressed_gpu_data> gpuMeshlets;
+		std::vector<uint32_t> meshletData;
+		gpuMeshlets.reserve(aMeshlets.size());
+
+		std::vector<uint8_t> bytes;
+		std::vector<std::array<uint8_t, 3>> triangles;
+		for (auto& ml : aMeshlets) {
+			// 0xFF is reserved for strip restarts => at most 254 distinct local vertices
+			if (ml.mVertexCount >= sMeshletStripRestart || ml.mIndexCount / 3 > 255u) {
+				throw gvk::runtime_error(fmt::format("Meshlet with {} vertices and {} indices exceeds the limits of the compressed meshlet format.", ml.mVertexCount, ml.mIndexCount));
+			}
+
+			auto& newEntry = gpuMeshlets.emplace_back();
+			newEntry.mDataOffset = static_cast<uint32_t>(meshletData.size());
+			newEntry.mVertexCount = static_cast<uint8_t>(ml.mVertexCount);
+			newEntry.mPrimitiveCount = static_cast<uint8_t>(ml.mIndexCount / 3u);
+			newEntry.mIndexEncoding = static_cast<uint8_t>(aIndexEncoding);
+			newEntry.mPadding = 0;
+
+			// Vertex references: base vertex + narrowest offsets that fit
+			const auto verticesEnd = std::begin(ml.mVertices) + ml.mVertexCount;
+			const auto [minIt, maxIt] = std::minmax_element(std::begin(ml.mVertices), verticesEnd);
+			newEntry.mBaseVertex = ml.mVertexCount > 0 ? *minIt : 0u;
+			const uint32_t maxOffset = ml.mVertexCount > 0 ? *maxIt - newEntry.mBaseVertex : 0u;
+			const uint32_t offsetBytes = maxOffset <= 0xFFu ? 1u : (maxOffset <= 0xFFFFu ? 2u : 4u);
+			newEntry.mVertexOffsetBits = static_cast<uint8_t>(offsetBytes * 8u);
+
+			bytes.clear();
+			for (auto it = std::begin(ml.mVertices); it != verticesEnd; ++it) {
+				const uint32_t offset = *it - newEntry.mBaseVertex;
+				for (uint32_t b = 0; b < offsetBytes; ++b) {
+					bytes.push_back(static_cast<uint8_t>((offset >> (8u * b)) & 0xFFu));
+				}
+			}
+			append_padded_to_words(meshletData, bytes);
+
+			// Local indices
+			bytes.clear();
+			if (aIndexEncoding == meshlet_index_encoding::triangle_strip) {
+				triangles.clear();
+				for (uint32_t i = 0; i + 2 < ml.mIndexCount; i += 3) {
+					triangles.push_back({ ml.mIndices[i], ml.mIndices[i + 1], ml.mIndices[i + 2] });
+				}
+				bytes = encode_strip(triangles);
+			}
+			else {
+				bytes.assign(std::begin(ml.mIndices), std::begin(ml.mIndices) + newEntry.mPrimitiveCount * 3u);
+			}
+			newEntry.mIndexByteCount = static_cast<uint16_t>(bytes.size());
+			append_padded_to_words(meshletData, bytes);
+		}
+
+		return std::make_tuple(std::move(gpuMeshlets), std::move(meshletData));
+	}
+
+	std::tuple<std::vector<meshlet_compressed_gpu_data>, std::vector<uint32_t>> encode_meshlets_compressed_cached(serializer& aSerializer, const std::vector<meshlet>& aMeshlets, meshlet_index_encoding aIndexEncoding)
+	{
+		std::tuple<std::vector<meshlet_compressed_gpu_data>, std::vector<uint32_t>> result;
+		if (aSerializer.mode() == serializer::mode::serialize) {
+			result = encode_meshlets_compressed(aMeshlets, aIndexEncoding);
+		}
+		aSerializer.archive(std::get<0>(result));
+		aSerializer.archive(std::get<1>(result));
+		return result;
+	}
+
+	meshlet decode_meshlet_compressed(const meshlet_compressed_gpu_data& aMeshlet, const std::vector<uint32_t>& aMeshletData)
+	{
+		meshlet result{};
+		result.mVertexCount = aMeshlet.mVertexCount;
+		result.mVertices.reserve(aMeshlet.mVertexCount);
+
+		const auto* bytes = reinterpret_cast<const uint8_t*>(aMeshletData.data() + aMeshlet.mDataOffset);
+		const uint32_t offsetBytes = aMeshlet.mVertexOffsetBits / 8u;
+		for (uint32_t v = 0; v < aMeshlet.mVertexCount; ++v) {
+			uint32_t offset = 0;
+			for (uint32_t b = 0; b < offsetBytes; ++b) {
+				offset |= static_cast<uint32_t>(bytes[v * offsetBytes + b]) << (8u * b);
+			}
+			result.mVertices.push_back(aMeshlet.mBaseVertex + offset);
+		}
+
+		const auto* indexBytes = bytes + ((aMeshlet.mVertexCount * offsetBytes + 3u) / 4u) * 4u;
+		result.mIndices.reserve(aMeshlet.mPrimitiveCount * 3u);
+		if (aMeshlet.mIndexEncoding == static_cast<uint8_t>(meshlet_index_encoding::triangle_strip)) {
+			size_t stripLength = 0;
+			for (uint32_t i = 0; i < aMeshlet.mIndexByteCount; ++i) {
+				if (indexBytes[i] == sMeshletStripRestart) {
+					stripLength = 0;
+					continue;
+				}
+				++stripLength;
+				if (stripLength >= 3) {
+					const auto a = indexBytes[i - 2], b = indexBytes[i - 1], c = indexBytes[i];
+					if ((stripLength - 3) % 2 == 0) {
+						result.mIndices.insert(std::end(result.mIndices), { a, b, c });
+					}
+					else {
+						result.mIndices.insert(std::end(result.mIndices), { b, a, c });
+					}
+				}
+			}
+		}
+		else {
+			result.mIndices.assign(indexBytes, indexBytes + aMeshlet.mIndexByteCount);
+		}
+		result.mIndexCount = static_cast<uint32_t>(result.mIndices.size());
+		return result;
+	}
+
+	meshlet_compression_report report_meshlet_compression(const std::vector<meshlet>& aMeshlets, meshlet_index_encoding aIndexEncoding, size_t aFixedLayoutBytesPerMeshlet)
+	{
+		meshlet_compression_report report;
+		report.mNumMeshlets = aMeshlets.size();
+		report.mFixedLayoutBytes = aFixedLayoutBytesPerMeshlet * aMeshlets.size();
+		report.mRedirectedLayoutBytes = sizeof(meshlet_redirected_gpu_data) * aMeshlets.size();
+		for (auto& ml : aMeshlets) {
+			report.mNumTriangles += ml.mIndexCount / 3;
+			report.mRedirectedLayoutBytes += sizeof(uint32_t) * (ml.mVertexCount + (ml.mIndexCount + 3) / 4);
+		}
+
+		auto t0 = std::chrono::steady_clock::now();
+		auto [gpuMeshlets, meshletData] = encode_meshlets_compressed(aMeshlets, aIndexEncoding);
+		auto t1 = std::chrono::steady_clock::now();
+		std::vector<meshlet> decoded;
+		decoded.reserve(gpuMeshlets.size());
+		for (auto& ml : gpuMeshlets) {
+			decoded.push_back(decode_meshlet_compressed(ml, meshletData));
+		}
+		auto t2 = std::chrono::steady_clock::now();
+
+		report.mEncodeSeconds = std::chrono::duration<double>(t1 - t0).count();
+		report.mDecodeSeconds = std::chrono::duration<double>(t2 - t1).count();
+		report.mCompressedBytes = sizeof(meshlet_compressed_gpu_data) * gpuMeshlets.size() + sizeof(uint32_t) * meshletData.size();
+
+		report.mRoundTripValid = true;
+		for (size_t i = 0; i < aMeshlets.size() && report.mRoundTripValid; ++i) {
+			report.mRoundTripValid = canonical_triangles(aMeshlets[i]) == canonical_triangles(decoded[i]);
+		}
+
+		LOG_INFO(fmt::format("Meshlet compression ({}): {} meshlets, {} triangles | fixed layout: {} bytes, redirected layout: {} bytes, compressed: {} bytes ({:.1f}% of redirected) | encode: {:.2f} Mtris/s, decode: {:.2f} Mtris/s | round trip {}",
+			aIndexEncoding == meshlet_index_encoding::triangle_strip ? "triangle strips" : "triangle lists",
+			report.mNumMeshlets, report.mNumTriangles,
+			report.mFixedLayoutBytes, report.mRedirectedLayoutBytes, report.mCompressedBytes, 100.0 * report.ratio_to_redirected_layout(),
+			report.encode_triangles_per_second() * 1e-6, report.decode_triangles_per_second() * 1e-6,
+			report.mRoundTripValid ? "valid" : "INVALID"));
+
+		return report;
+	}
+}
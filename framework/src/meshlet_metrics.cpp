@@ -0,0 +1,164 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	namespace
+	{
+		meshlet_value_distribution make_distribution(std::vector<float> aValues)
+		{
+			meshlet_value_distribution result;
+			if (aValues.empty()) {
+				return result;
+			}
+			std::sort(std::begin(aValues), std::end(aValues));
+			result.mMin = aValues.front();
+			result.mMax = aValues.back();
+			result.mMean = static_cast<float>(std::accumulate(std::begin(aValues), std::end(aValues), 0.0) / static_cast<double>(aValues.size()));
+			result.mMedian = aValues[aValues.size() / 2];
+			result.mPercentile90 = aValues[std::min(aValues.size() - 1, aValues.size() * 9 / 10)];
+			return result;
+		}
+
+		// Ritter's bounding sphere, returns the radius
+		float bounding_sphere_radius(const std::vector<glm::vec3>& aPoints)
+		{
+			if (aPoints.empty()) {
+				return 0.0f;
+			}
+			auto farthestFrom = [&aPoints](const glm::vec3& aFrom) {
+				size_t farthest = 0;
+				float maxDist2 = -1.0f;
+				for (size_t i = 0; i < aPoints.size(); ++i) {
+					const auto d = aPoints[i] - aFrom;
+					const auto dist2 = glm::dot(d, d);
+					if (dist2 > maxDist2) {
+						maxDist2 = dist2;
+						farthest = i;
+					}
+				}
+				return aPoints[farthest];
+			};
+
+			const auto a = farthestFrom(aPoints[0]);
+			const auto b = farthestFrom(a);
+			auto center = (a + b) * 0.5f;
+			auto radius = glm::length(b - a) * 0.5f;
+			for (const auto& p : aPoints) {
+				const auto dist = glm::length(p - center);
+				if (dist > radius) {
+					const auto newRadius = (radius + dist) * 0.5f;
+					center += (p - center) * ((newRadius - radius) / dist);
+					radius = newRadius;
+				}
+			}
+			return radius;
+		}
+	}
+
+	meshlet_metrics compute_meshlet_metrics(const std::vector<glm::vec3>& aVertices, const std::vector<meshlet>& aMeshlets, uint32_t aMaxVertices, uint32_t aMaxIndices)
+	{
+		meshlet_metrics metrics;
+		metrics.mNumMeshlets = aMeshlets.size();
+		metrics.mMaxVertices = aMaxVertices;
+		metrics.mMaxIndices = aMaxIndices;
+
+		std::vector<bool> referenced(aVertices.size(), false);
+		std::vector<float> radii;
+		std::vector<float> coneAngles;
+		radii.reserve(aMeshlets.size());
+		coneAngles.reserve(aMeshlets.size());
+		std::vector<glm::vec3> points;
+		std::vector<glm::vec3> faceNormals;
+		size_t numCullable = 0;
+
+		for (const auto& ml : aMeshlets) {
+			const auto numTriangles = ml.mIndexCount / 3u;
+			metrics.mNumTriangles += numTriangles;
+			metrics.mNumMeshletVertices += ml.mVertexCount;
+			if (aMaxVertices > 0) {
+				metrics.mVertexFill += static_cast<double>(ml.mVertexCount) / static_cast<double>(aMaxVertices);
+			}
+			if (aMaxIndices >= 3) {
+				metrics.mTriangleFill += static_cast<double>(numTriangles) / static_cast<double>(aMaxIndices / 3u);
+			}
+
+			points.clear();
+			for (uint32_t i = 0; i < ml.mVertexCount; ++i) {
+				const auto v = ml.mVertices[i];
+				if (v >= aVertices.size()) {
+					throw gvk::runtime_error(fmt::format("Meshlet references vertex {}, but only {} vertices have been passed to compute_meshlet_metrics.", v, aVertices.size()));
+				}
+				referenced[v] = true;
+				points.push_back(aVertices[v]);
+			}
+			radii.push_back(bounding_sphere_radius(points));
+
+			// Normal cone around the average face normal; degenerate triangles are ignored
+			faceNormals.clear();
+			glm::vec3 axis{ 0.0f };
+			for (uint32_t t = 0; t < numTriangles; ++t) {
+				const auto& p0 = aVertices[ml.mVertices[ml.mIndices[3 * t + 0]]];
+				const auto& p1 = aVertices[ml.mVertices[ml.mIndices[3 * t + 1]]];
+				const auto& p2 = aVertices[ml.mVertices[ml.mIndices[3 * t + 2]]];
+				const auto n = glm::cross(p1 - p0, p2 - p0);
+				const auto len = glm::length(n);
+				if (len > std::numeric_limits<float>::epsilon()) {
+					faceNormals.push_back(n / len);
+					axis += n / len;
+				}
+			}
+			float coneAngle = glm::pi<float>();
+			if (!faceNormals.empty() && glm::length(axis) > std::numeric_limits<float>::epsilon()) {
+				axis = glm::normalize(axis);
+				float minDot = 1.0f;
+				for (const auto& n : faceNormals) {
+					minDot = std::min(minDot, glm::dot(axis, n));
+				}
+				coneAngle = std::acos(glm::clamp(minDot, -1.0f, 1.0f));
+			}
+			coneAngles.push_back(coneAngle);
+			if (coneAngle < glm::half_pi<float>()) {
+				++numCullable;
+			}
+		}
+
+		metrics.mNumUniqueVertices = static_cast<size_t>(std::count(std::begin(referenced), std::end(referenced), true));
+		if (metrics.mNumMeshlets > 0) {
+			metrics.mVertexFill /= static_cast<double>(metrics.mNumMeshlets);
+			metrics.mTriangleFill /= static_cast<double>(metrics.mNumMeshlets);
+			metrics.mCullableFraction = static_cast<double>(numCullable) / static_cast<double>(metrics.mNumMeshlets);
+		}
+		if (metrics.mNumUniqueVertices > 0) {
+			metrics.mVertexDuplicationFactor = static_cast<double>(metrics.mNumMeshletVertices) / static_cast<double>(metrics.mNumUniqueVertices);
+		}
+		metrics.mBoundingSphereRadius = make_distribution(std::move(radii));
+		metrics.mNormalConeAngle = make_distribution(std::move(coneAngles));
+		return metrics;
+	}
+
+	std::string to_string(const meshlet_metrics& aMetrics)
+	{
+		auto distribution = [](const meshlet_value_distribution& d, float aScale) {
+			return fmt::format("min {:.4f}, median {:.4f}, mean {:.4f}, p90 {:.4f}, max {:.4f}", d.mMin * aScale, d.mMedian * aScale, d.mMean * aScale, d.mPercentile90 * aScale, d.mMax * aScale);
+		};
+		return fmt::format(
+			"meshlets:               {}\n"
+			"triangles:              {}\n"
+			"vertex fill:            {:.1f}% of {}\n"
+			"triangle fill:          {:.1f}% of {}\n"
+			"vertex duplication:     {:.3f} ({} meshlet vertices / {} unique vertices)\n"
+			"bounding sphere radius: {}\n"
+			"normal cone half angle: {} [deg]\n"
+			"cullable by cone:       {:.1f}%\n"
+			"build time:             {:.3f} ms ({:.2f} Mtris/s)",
+			aMetrics.mNumMeshlets,
+			aMetrics.mNumTriangles,
+			100.0 * aMetrics.mVertexFill, aMetrics.mMaxVertices,
+			100.0 * aMetrics.mTriangleFill, aMetrics.mMaxIndices / 3u,
+			aMetrics.mVertexDuplicationFactor, aMetrics.mNumMeshletVertices, aMetrics.mNumUniqueVertices,
+			distribution(aMetrics.mBoundingSphereRadius, 1.0f),
+			distribution(aMetrics.mNormalConeAngle, glm::degrees(1.0f)),
+			100.0 * aMetrics.mCullableFraction,
+			aMetrics.mBuildSeconds * 1000.0, aMetrics.triangles_per_second() * 1e-6);
+	}
+}
@@ -0,0 +1,37 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	void meshlet_arena::append(const meshlet& aMeshlet)
+	{
+		auto& entry = mMeshlets.emplace_back();
+		entry.mVerticesOffset = static_cast<uint32_t>(mVertices.size());
+		entry.mIndicesOffset = static_cast<uint32_t>(mIndices.size());
+		entry.mVertexCount = aMeshlet.mVertexCount;
+		entry.mIndexCount = aMeshlet.mIndexCount;
+		entry.mMeshIndex = aMeshlet.mMeshIndex;
+		mVertices.insert(std::end(mVertices), std::begin(aMeshlet.mVertices), std::begin(aMeshlet.mVertices) + aMeshlet.mVertexCount);
+		mIndices.insert(std::end(mIndices), std::begin(aMeshlet.mIndices), std::begin(aMeshlet.mIndices) + aMeshlet.mIndexCount);
+	}
+
+	void meshlet_arena::append(const std::vector<meshlet>& aMeshlets)
+	{
+		for (const auto& ml : aMeshlets) {
+			append(ml);
+		}
+	}
+
+	meshlet meshlet_arena::to_meshlet(size_t aMeshletIndex) const
+	{
+		const auto& entry = mMeshlets[aMeshletIndex];
+		meshlet result{};
+		result.mMeshIndex = entry.mMeshIndex;
+		result.mVertexCount = entry.mVertexCount;
+		result.mIndexCount = entry.mIndexCount;
+		auto vertices = vertices_of(aMeshletIndex);
+		auto indices = indices_of(aMeshletIndex);
+		result.mVertices.assign(std::begin(vertices), std::end(vertices));
+		result.mIndices.assign(std::begin(indices), std::end(indices));
+		return result;
+	}
+}
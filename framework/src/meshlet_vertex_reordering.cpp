@@ -0,0 +1,60 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	namespace
+	{
+		// Assigns new indices in order of first use and rewrites the references in place
+		uint32_t remap_vertex_reference(vertex_remap& aRemap, uint32_t aOldIndex)
+		{
+			if (aOldIndex >= aRemap.mOldToNew.size()) {
+				throw gvk::runtime_error(fmt::format("Meshlet references vertex {}, but the vertex buffer only contains {} vertices.", aOldIndex, aRemap.mOldToNew.size()));
+			}
+			auto& newIndex = aRemap.mOldToNew[aOldIndex];
+			if (newIndex == vertex_remap::sNotReferenced) {
+				newIndex = static_cast<uint32_t>(aRemap.mNewToOld.size());
+				aRemap.mNewToOld.push_back(aOldIndex);
+			}
+			return newIndex;
+		}
+	}
+
+	void vertex_remap::apply_to_indices(std::vector<uint32_t>& aIndices) const
+	{
+		for (auto& index : aIndices) {
+			if (index >= mOldToNew.size() || mOldToNew[index] == sNotReferenced) {
+				throw gvk::runtime_error(fmt::format("Index {} refers to a vertex which is not part of the reordered vertices.", index));
+			}
+			index = mOldToNew[index];
+		}
+	}
+
+	vertex_remap reorder_vertices_for_meshlets(std::vector<meshlet>& aMeshlets, size_t aNumVertices)
+	{
+		vertex_remap remap;
+		remap.mOldToNew.resize(aNumVertices, vertex_remap::sNotReferenced);
+		remap.mNewToOld.reserve(aNumVertices);
+		for (auto& ml : aMeshlets) {
+			for (uint32_t i = 0; i < ml.mVertexCount; ++i) {
+				ml.mVertices[i] = remap_vertex_reference(remap, ml.mVertices[i]);
+			}
+		}
+		remap.mNewToOld.shrink_to_fit();
+		return remap;
+	}
+
+	vertex_remap reorder_vertices_for_meshlets(meshlet_arena& aMeshlets, size_t aNumVertices)
+	{
+		vertex_remap remap;
+		remap.mOldToNew.resize(aNumVertices, vertex_remap::sNotReferenced);
+		remap.mNewToOld.reserve(aNumVertices);
+		for (const auto& entry : aMeshlets.mMeshlets) {
+			for (uint32_t i = 0; i < entry.mVertexCount; ++i) {
+				auto& v = aMeshlets.mVertices[entry.mVerticesOffset + i];
+				v = remap_vertex_reference(remap, v);
+			}
+		}
+		remap.mNewToOld.shrink_to_fit();
+		return remap;
+	}
+}
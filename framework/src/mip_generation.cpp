@@ -0,0 +1,423 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	namespace
+	{
+		struct texel_layout
+		{
+			uint32_t mComponents;
+			bool mIsFloat;
+			bool mIsSrgb;
+		};
+
+		std::optional<texel_layout> texel_layout_of(vk::Format aFormat)
+		{
+			switch (aFormat) {
+			case vk::Format::eR8Unorm:				return texel_layout{ 1, false, false };
+			case vk::Format::eR8Srgb:				return texel_layout{ 1, false, true };
+			case vk::Format::eR8G8Unorm:			return texel_layout{ 2, false, false };
+			case vk::Format::eR8G8Srgb:				return texel_layout{ 2, false, true };
+			case vk::Format::eR8G8B8Unorm:
+			case vk::Format::eB8G8R8Unorm:			return texel_layout{ 3, false, false };
+			case vk::Format::eR8G8B8Srgb:
+			case vk::Format::eB8G8R8Srgb:			return texel_layout{ 3, false, true };
+			case vk::Format::eR8G8B8A8Unorm:
+			case vk::Format::eB8G8R8A8Unorm:		return texel_layout{ 4, false, false };
+			case vk::Format::eR8G8B8A8Srgb:
+			case vk::Format::eB8G8R8A8Srgb:			return texel_layout{ 4, false, true };
+			case vk::Format::eR32Sfloat:			return texel_layout{ 1, true, false };
+			case vk::Format::eR32G32Sfloat:			return texel_layout{ 2, true, false };
+			case vk::Format::eR32G32B32Sfloat:		return texel_layout{ 3, true, false };
+			case vk::Format::eR32G32B32A32Sfloat:	return texel_layout{ 4, true, false };
+			default:								return {};
+			}
+		}
+
+		const std::array<float, 256>& srgb_to_linear_table()
+		{
+			static const auto sTable = []() {
+				std::array<float, 256> table;
+				for (size_t i = 0; i < table.size(); ++i) {
+					const auto c = static_cast<float>(i) / 255.0f;
+					table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+				}
+				return table;
+			}();
+			return sTable;
+		}
+
+		const std::array<float, 256>& unorm_to_float_table()
+		{
+			static const auto sTable = []() {
+				std::array<float, 256> table;
+				for (size_t i = 0; i < table.size(); ++i) {
+					table[i] = static_cast<float>(i) / 255.0f;
+				}
+				return table;
+			}();
+			return sTable;
+		}
+
+		// Linear values are quantized to 14 bits before the lookup, which is precise enough to hit the right 8-bit sRGB value also for dark values
+		constexpr size_t sLinearToSrgbTableSize = 16384;
+
+		const std::vector<uint8_t>& linear_to_srgb_table()
+		{
+			static const auto sTable = []() {
+				std::vector<uint8_t> table(sLinearToSrgbTableSize);
+				for (size_t i = 0; i < table.size(); ++i) {
+					const auto l = static_cast<float>(i) / static_cast<float>(sLinearToSrgbTableSize - 1);
+					const auto c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+					table[i] = static_cast<uint8_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+				}
+				return table;
+			}();
+			return sTable;
+		}
+
+		// Width (in texels of the smaller level) and shape of the Kaiser window:
+		constexpr float sKaiserWidth = 3.0f;
+		constexpr float sKaiserAlpha = 4.0f;
+
+		// Modified Bessel function of the first kind, order 0
+		double bessel_i0(double aX)
+		{
+			double sum = 1.0;
+			double term = 1.0;
+			for (int k = 1; k < 64; ++k) {
+				const auto factor = aX / (2.0 * k);
+				term *= factor * factor;
+				sum += term;
+				if (term < 1e-12 * sum) {
+					break;
+				}
+			}
+			return sum;
+		}
+
+		float kaiser(float aT)
+		{
+			const auto t = std::abs(aT);
+			if (t >= sKaiserWidth) {
+				return 0.0f;
+			}
+			const auto pit = glm::pi<float>() * t;
+			const auto sinc = t < 1e-6f ? 1.0f : std::sin(pit) / pit;
+			const auto x = t / sKaiserWidth;
+			const auto window = bessel_i0(sKaiserAlpha * std::sqrt(1.0 - x * x)) / bessel_i0(sKaiserAlpha);
+			return sinc * static_cast<float>(window);
+		}
+
+		struct filter_tap
+		{
+			uint32_t mSource;
+			float mWeight;
+		};
+
+		// The taps of all texels of the smaller level along one axis; the taps of texel i are mTaps[mFirstTap[i]] to mTaps[mFirstTap[i + 1] - 1]
+		struct axis_filter
+		{
+			std::vector<uint32_t> mFirstTap;
+			std::vector<filter_tap> mTaps;
+		};
+
+		axis_filter compute_axis_filter(uint32_t aSourceSize, uint32_t aDestinationSize, mip_filter aFilter)
+		{
+			axis_filter result;
+			result.mFirstTap.reserve(aDestinationSize + 1);
+			const auto scale = static_cast<float>(aSourceSize) / static_cast<float>(aDestinationSize);
+
+			for (uint32_t d = 0; d < aDestinationSize; ++d) {
+				result.mFirstTap.push_back(static_cast<uint32_t>(result.mTaps.size()));
+
+				if (aSourceSize == aDestinationSize) {
+					result.mTaps.push_back({ d, 1.0f });
+					continue;
+				}
+
+				switch (aFilter) {
+				case mip_filter::box:
+				{
+					// Weight every source texel by how much of it is covered by the destination texel
+					const auto lo = static_cast<float>(d) * scale;
+					const auto hi = static_cast<float>(d + 1) * scale;
+					for (auto s = static_cast<uint32_t>(lo); static_cast<float>(s) < hi && s < aSourceSize; ++s) {
+						const auto weight = std::min(hi, static_cast<float>(s + 1)) - std::max(lo, static_cast<float>(s));
+						if (weight > 0.0f) {
+							result.mTaps.push_back({ s, weight });
+						}
+					}
+					break;
+				}
+				case mip_filter::kaiser:
+				{
+					// Sample the filter at the source texel centers, and clamp source texels outside of the image to the edge
+					const auto center = (static_cast<float>(d) + 0.5f) * scale;
+					const auto radius = sKaiserWidth * scale;
+					const auto first = static_cast<int64_t>(std::floor(center - radius));
+					const auto last = static_cast<int64_t>(std::ceil(center + radius));
+					for (auto s = first; s <= last; ++s) {
+						const auto weight = kaiser((static_cast<float>(s) + 0.5f - center) / scale);
+						if (weight != 0.0f) {
+							result.mTaps.push_back({ static_cast<uint32_t>(std::clamp<int64_t>(s, 0, aSourceSize - 1)), weight });
+						}
+					}
+					break;
+				}
+				}
+
+				// Normalize the weights:
+				const auto firstTap = result.mFirstTap.back();
+				float sum = 0.0f;
+				for (auto t = firstTap; t < result.mTaps.size(); ++t) {
+					sum += result.mTaps[t].mWeight;
+				}
+				for (auto t = firstTap; t < result.mTaps.size(); ++t) {
+					result.mTaps[t].mWeight /= sum;
+				}
+			}
+
+			result.mFirstTap.push_back(static_cast<uint32_t>(result.mTaps.size()));
+			return result;
+		}
+
+		// Filters every row of aSource horizontally, from aSourceWidth to aFilter.mFirstTap.size() - 1 texels
+		template <uint32_t C>
+		void filter_rows(const std::vector<float>& aSource, uint32_t aSourceWidth, uint32_t aHeight, const axis_filter& aFilter, std::vector<float>& aDestination)
+		{
+			const auto destinationWidth = static_cast<uint32_t>(aFilter.mFirstTap.size() - 1);
+			aDestination.assign(static_cast<size_t>(destinationWidth) * aHeight * C, 0.0f);
+			for (uint32_t y = 0; y < aHeight; ++y) {
+				const float* sourceRow = aSource.data() + static_cast<size_t>(y) * aSourceWidth * C;
+				float* destinationRow = aDestination.data() + static_cast<size_t>(y) * destinationWidth * C;
+				for (uint32_t x = 0; x < destinationWidth; ++x) {
+					std::array<float, C> sum{};
+					for (auto t = aFilter.mFirstTap[x]; t < aFilter.mFirstTap[x + 1]; ++t) {
+						const auto& tap = aFilter.mTaps[t];
+						const float* texel = sourceRow + static_cast<size_t>(tap.mSource) * C;
+						for (uint32_t c = 0; c < C; ++c) {
+							sum[c] += tap.mWeight * texel[c];
+						}
+					}
+					for (uint32_t c = 0; c < C; ++c) {
+						destinationRow[static_cast<size_t>(x) * C + c] = sum[c];
+					}
+				}
+			}
+		}
+
+		// Filters aSource vertically by accumulating whole weighted rows, which compilers vectorize well
+		void filter_columns(const std::vector<float>& aSource, size_t aRowLength, const axis_filter& aFilter, std::vector<float>& aDestination)
+		{
+			const auto destinationHeight = aFilter.mFirstTap.size() - 1;
+			aDestination.assign(destinationHeight * aRowLength, 0.0f);
+			for (size_t y = 0; y < destinationHeight; ++y) {
+				float* destinationRow = aDestination.data() + y * aRowLength;
+				for (auto t = aFilter.mFirstTap[y]; t < aFilter.mFirstTap[y + 1]; ++t) {
+					const auto weight = aFilter.mTaps[t].mWeight;
+					const float* sourceRow = aSource.data() + static_cast<size_t>(aFilter.mTaps[t].mSource) * aRowLength;
+					for (size_t i = 0; i < aRowLength; ++i) {
+						destinationRow[i] += weight * sourceRow[i];
+					}
+				}
+			}
+		}
+
+		// Averages 2x2 blocks of texels. This is what the box filter boils down to for even extents, but in one pass.
+		template <uint32_t C>
+		void filter_2x2_box(const std::vector<float>& aSource, uint32_t aSourceWidth, uint32_t aDestinationWidth, uint32_t aDestinationHeight, std::vector<float>& aDestination)
+		{
+			aDestination.resize(static_cast<size_t>(aDestinationWidth) * aDestinationHeight * C);
+			for (uint32_t y = 0; y < aDestinationHeight; ++y) {
+				const float* row0 = aSource.data() + static_cast<size_t>(2 * y) * aSourceWidth * C;
+				const float* row1 = row0 + static_cast<size_t>(aSourceWidth) * C;
+				float* destinationRow = aDestination.data() + static_cast<size_t>(y) * aDestinationWidth * C;
+				for (uint32_t x = 0; x < aDestinationWidth; ++x) {
+					for (uint32_t c = 0; c < C; ++c) {
+						const auto i = static_cast<size_t>(2 * x) * C + c;
+						destinationRow[static_cast<size_t>(x) * C + c] = 0.25f * (row0[i] + row0[i + C] + row1[i] + row1[i + C]);
+					}
+				}
+			}
+		}
+
+		// Fraction of texels whose scaled alpha value passes the alpha test against aReference
+		float alpha_coverage(const std::vector<float>& aTexels, float aReference, float aScale)
+		{
+			const auto numTexels = aTexels.size() / 4;
+			size_t passed = 0;
+			for (size_t i = 0; i < numTexels; ++i) {
+				if (std::min(aTexels[i * 4 + 3] * aScale, 1.0f) > aReference) {
+					++passed;
+				}
+			}
+			return static_cast<float>(passed) / static_cast<float>(numTexels);
+		}
+
+		// Finds the factor for the alpha values of aTexels which yields the desired coverage
+		float find_alpha_scale(const std::vector<float>& aTexels, float aReference, float aDesiredCoverage)
+		{
+			// The coverage grows monotonically with the scale => binary search
+			float lo = 0.0f;
+			float hi = 4.0f;
+			for (int i = 0; i < 12; ++i) {
+				const auto mid = 0.5f * (lo + hi);
+				if (alpha_coverage(aTexels, aReference, mid) < aDesiredCoverage) {
+					lo = mid;
+				}
+				else {
+					hi = mid;
+				}
+			}
+			return hi;
+		}
+
+		// Alpha is always stored linearly, also in sRGB formats:
+		uint32_t number_of_srgb_components(const texel_layout& aLayout)
+		{
+			return aLayout.mIsSrgb ? (4 == aLayout.mComponents ? 3u : aLayout.mComponents) : 0u;
+		}
+
+		// Converts tightly packed texels into linear float values
+		std::vector<float> to_linear_values(const void* aTexels, size_t aNumValues, const texel_layout& aLayout)
+		{
+			std::vector<float> result(aNumValues);
+			if (aLayout.mIsFloat) {
+				std::memcpy(result.data(), aTexels, aNumValues * sizeof(float));
+				return result;
+			}
+			// Look up every component in a table, which is the sRGB or the plain unorm one, depending on the component:
+			const auto components = aLayout.mComponents;
+			const auto numSrgbComponents = number_of_srgb_components(aLayout);
+			std::array<const float*, 4> tables;
+			for (uint32_t c = 0; c < components; ++c) {
+				tables[c] = c < numSrgbComponents ? srgb_to_linear_table().data() : unorm_to_float_table().data();
+			}
+			const auto* bytes = static_cast<const uint8_t*>(aTexels);
+			for (size_t i = 0; i < aNumValues; i += components) {
+				for (uint32_t c = 0; c < components; ++c) {
+					result[i + c] = tables[c][bytes[i + c]];
+				}
+			}
+			return result;
+		}
+
+		// Converts linear float values back into tightly packed texels, and scales the alpha values if aAlphaScale is set
+		std::vector<std::byte> from_linear_values(const std::vector<float>& aValues, const texel_layout& aLayout, std::optional<float> aAlphaScale)
+		{
+			const auto components = aLayout.mComponents;
+			const auto hasAlpha = 4 == components;
+			std::vector<std::byte> result;
+			if (aLayout.mIsFloat) {
+				result.resize(aValues.size() * sizeof(float));
+				auto* values = reinterpret_cast<float*>(result.data());
+				for (size_t i = 0; i < aValues.size(); ++i) {
+					values[i] = aAlphaScale.has_value() && 3 == i % 4 ? std::min(aValues[i] * *aAlphaScale, 1.0f) : aValues[i];
+				}
+				return result;
+			}
+			const auto numSrgbComponents = number_of_srgb_components(aLayout);
+			const auto alphaScale = aAlphaScale.value_or(1.0f);
+			const auto& toSrgb = linear_to_srgb_table();
+			result.resize(aValues.size());
+			auto* bytes = reinterpret_cast<uint8_t*>(result.data());
+			for (size_t i = 0; i < aValues.size(); i += components) {
+				for (uint32_t c = 0; c < components; ++c) {
+					const auto value = std::clamp(hasAlpha && 3 == c ? aValues[i + c] * alphaScale : aValues[i + c], 0.0f, 1.0f);
+					bytes[i + c] = c < numSrgbComponents
+						? toSrgb[static_cast<size_t>(value * static_cast<float>(sLinearToSrgbTableSize - 1) + 0.5f)]
+						: static_cast<uint8_t>(value * 255.0f + 0.5f);
+				}
+			}
+			return result;
+		}
+
+		// Filters the texels of aSource into aDestination, which has a different extent, first horizontally, then vertically
+		void filter_separable(const std::vector<float>& aSource, vk::Extent3D aExtent, vk::Extent3D aDestinationExtent, uint32_t aComponents, mip_filter aFilter, std::vector<float>& aRowsFiltered, std::vector<float>& aDestination)
+		{
+			const auto horizontal = compute_axis_filter(aExtent.width, aDestinationExtent.width, aFilter);
+			const auto vertical = compute_axis_filter(aExtent.height, aDestinationExtent.height, aFilter);
+			switch (aComponents) {
+			case 1: filter_rows<1>(aSource, aExtent.width, aExtent.height, horizontal, aRowsFiltered); break;
+			case 2: filter_rows<2>(aSource, aExtent.width, aExtent.height, horizontal, aRowsFiltered); break;
+			case 3: filter_rows<3>(aSource, aExtent.width, aExtent.height, horizontal, aRowsFiltered); break;
+			default: filter_rows<4>(aSource, aExtent.width, aExtent.height, horizontal, aRowsFiltered); break;
+			}
+			filter_columns(aRowsFiltered, static_cast<size_t>(aDestinationExtent.width) * aComponents, vertical, aDestination);
+		}
+	}
+
+	bool can_generate_mip_chain_on_cpu(vk::Format aFormat)
+	{
+		return texel_layout_of(aFormat).has_value();
+	}
+
+	std::vector<mip_level> generate_mip_chain(const void* aLevel0, vk::Extent3D aExtent, vk::Format aFormat, const mip_generation_config& aConfig)
+	{
+		const auto layout = texel_layout_of(aFormat);
+		if (!layout.has_value()) {
+			throw gvk::runtime_error(fmt::format("MIP-maps can not be generated on the CPU for format {}.", vk::to_string(aFormat)));
+		}
+		if (aExtent.depth != 1) {
+			throw gvk::runtime_error("MIP-maps can only be generated on the CPU for 2D images.");
+		}
+
+		const auto components = layout->mComponents;
+		const auto hasAlpha = 4 == components;
+
+		// Convert level 0 into linear float values:
+		std::vector<float> current = to_linear_values(aLevel0, static_cast<size_t>(aExtent.width) * aExtent.height * components, *layout);
+
+		const auto alphaReference = hasAlpha ? aConfig.mAlphaCoverageReference : std::optional<float>{};
+		const auto desiredCoverage = alphaReference.has_value() ? alpha_coverage(current, *alphaReference, 1.0f) : 0.0f;
+
+		std::vector<mip_level> result;
+		std::vector<float> rowsFiltered;
+		std::vector<float> next;
+		auto extent = aExtent;
+		while (extent.width > 1 || extent.height > 1) {
+			const vk::Extent3D nextExtent{ std::max(extent.width / 2, 1u), std::max(extent.height / 2, 1u), 1u };
+
+			// Every level is filtered from the previous one, in linear space and without quantization in between
+			if (mip_filter::box == aConfig.mFilter && extent.width == 2 * nextExtent.width && extent.height == 2 * nextExtent.height) {
+				switch (components) {
+				case 1: filter_2x2_box<1>(current, extent.width, nextExtent.width, nextExtent.height, next); break;
+				case 2: filter_2x2_box<2>(current, extent.width, nextExtent.width, nextExtent.height, next); break;
+				case 3: filter_2x2_box<3>(current, extent.width, nextExtent.width, nextExtent.height, next); break;
+				default: filter_2x2_box<4>(current, extent.width, nextExtent.width, nextExtent.height, next); break;
+				}
+			}
+			else {
+				filter_separable(current, extent, nextExtent, components, aConfig.mFilter, rowsFiltered, next);
+			}
+
+			// The alpha coverage is only adjusted in the stored level, the next level is filtered from the unscaled values
+			const auto alphaScale = alphaReference.has_value() ? find_alpha_scale(next, *alphaReference, desiredCoverage) : 1.0f;
+
+			result.push_back(mip_level{ nextExtent, from_linear_values(next, *layout, alphaReference.has_value() ? std::optional<float>{ alphaScale } : std::optional<float>{}) });
+
+			std::swap(current, next);
+			extent = nextExtent;
+		}
+
+		return result;
+	}
+
+	std::vector<std::byte> resample_image(const void* aTexels, vk::Extent3D aExtent, vk::Format aFormat, vk::Extent3D aTargetExtent, mip_filter aFilter)
+	{
+		const auto layout = texel_layout_of(aFormat);
+		if (!layout.has_value()) {
+			throw gvk::runtime_error(fmt::format("Images can not be resampled on the CPU in format {}.", vk::to_string(aFormat)));
+		}
+		if (aExtent.depth != 1 || aTargetExtent.depth != 1) {
+			throw gvk::runtime_error("Only 2D images can be resampled on the CPU.");
+		}
+
+		const auto values = to_linear_values(aTexels, static_cast<size_t>(aExtent.width) * aExtent.height * layout->mComponents, *layout);
+		std::vector<float> rowsFiltered;
+		std::vector<float> resampled;
+		filter_separable(values, aExtent, aTargetExtent, layout->mComponents, aFilter, rowsFiltered, resampled);
+		return from_linear_values(resampled, *layout, {});
+	}
+}
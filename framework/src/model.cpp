@@ -33,11 +33,9 @@ namespace gvk
 	
 	void model_t::initialize_materials()
 	{
-		auto n = static_cast<size_t>(mScene->mNumMeshes);
-		mMaterialConfigPerMesh.reserve(n);
-		for (size_t i = 0; i < n; ++i) {
-			mMaterialConfigPerMesh.emplace_back();
-		}
+		// Materials are extracted from Assimp lazily, see material_id_for_mesh
+		mMaterialIdPerMesh.resize(static_cast<size_t>(mScene->mNumMeshes));
+		mMaterialIdPerAssimpMaterial.resize(static_cast<size_t>(mScene->mNumMaterials));
 	}
 
 	aiNode* model_t::find_mesh_root_node(unsigned int aMeshIndexToFind) const
@@ -175,11 +173,39 @@ namespace gvk
 
 	material_config model_t::material_config_for_mesh(mesh_index_t aMeshIndex)
 	{
-		assert (mMaterialConfigPerMesh.size() > aMeshIndex);
-		if (mMaterialConfigPerMesh[aMeshIndex].has_value()) {
-			return mMaterialConfigPerMesh[aMeshIndex].value();
+		return material_config_for_id(material_id_for_mesh(aMeshIndex));
+	}
+
+	material_id_t model_t::material_id_for_mesh(mesh_index_t aMeshIndex)
+	{
+		assert(mMaterialIdPerMesh.size() > aMeshIndex);
+		if (mMaterialIdPerMesh[aMeshIndex].has_value()) {
+			return mMaterialIdPerMesh[aMeshIndex].value();
 		}
-		
+
+		// Every Assimp material is extracted only once, no matter how many meshes it is assigned to:
+		const auto materialIndex = material_index_for_mesh(aMeshIndex);
+		assert(mMaterialIdPerAssimpMaterial.size() > materialIndex);
+		if (!mMaterialIdPerAssimpMaterial[materialIndex].has_value()) {
+			mMaterialIdPerAssimpMaterial[materialIndex] = intern_material_config(material_config_from_assimp(materialIndex));
+		}
+		mMaterialIdPerMesh[aMeshIndex] = mMaterialIdPerAssimpMaterial[materialIndex];
+		return mMaterialIdPerMesh[aMeshIndex].value();
+	}
+
+	material_config model_t::material_config_for_id(material_id_t aMaterialId) const
+	{
+		assert(mMaterials.size() > aMaterialId);
+		return mMaterials[aMaterialId].mConfig;
+	}
+
+	size_t model_t::number_of_material_ids() const
+	{
+		return mMaterials.size();
+	}
+
+	material_config model_t::material_config_from_assimp(size_t aMaterialIndex) const
+	{
 		material_config result;
 
 		aiString strVal;
@@ -202,9 +228,8 @@ namespace gvk
 			}
 		};
 		
-		auto materialIndex = material_index_for_mesh(aMeshIndex);
-		assert(materialIndex <= mScene->mNumMaterials);
-		aiMaterial* aimat = mScene->mMaterials[materialIndex];
+		assert(aMaterialIndex < mScene->mNumMaterials);
+		aiMaterial* aimat = mScene->mMaterials[aMaterialIndex];
 
 		// CPU-only parameters:
 		if (AI_SUCCESS == aimat->Get(AI_MATKEY_NAME, strVal)) {
@@ -531,26 +556,99 @@ namespace gvk
 			}
 		}
 
-		mMaterialConfigPerMesh[aMeshIndex] = result; // save
 		return result;
 	}
 
+	namespace
+	{
+		// Compares like the keys of distinct_material_configs, independent of the comparands' mIgnoreCpuOnlyDataForEquality members
+		bool are_equal_materials(material_config aLeft, material_config aRight, bool aAlsoConsiderCpuOnlyData)
+		{
+			aLeft.mIgnoreCpuOnlyDataForEquality = !aAlsoConsiderCpuOnlyData;
+			aRight.mIgnoreCpuOnlyDataForEquality = !aAlsoConsiderCpuOnlyData;
+			return aLeft == aRight;
+		}
+	}
+
+	material_id_t model_t::intern_material_config(const material_config& aMaterialConfig)
+	{
+		// The hashes are computed once per material, for both kinds of equality which distinct_material_ids supports:
+		auto gpuConfig = aMaterialConfig;
+		gpuConfig.mIgnoreCpuOnlyDataForEquality = true;
+		auto cpuConfig = aMaterialConfig;
+		cpuConfig.mIgnoreCpuOnlyDataForEquality = false;
+		interned_material material{ aMaterialConfig, std::hash<material_config>{}(gpuConfig), std::hash<material_config>{}(cpuConfig) };
+
+		// Materials are only interned if they are identical in everything that material_config_for_mesh returns, i.e. also
+		// in their names, which the equality operator of material_config does not compare:
+		auto key = material.mHashWithCpuOnlyData;
+		avk::hash_combine(key, aMaterialConfig.mName, aMaterialConfig.mIgnoreCpuOnlyDataForEquality);
+		const auto [first, last] = mMaterialIdsByHash.equal_range(key);
+		for (auto it = first; it != last; ++it) {
+			const auto& existing = mMaterials[it->second].mConfig;
+			if (existing.mName == aMaterialConfig.mName
+				&& existing.mIgnoreCpuOnlyDataForEquality == aMaterialConfig.mIgnoreCpuOnlyDataForEquality
+				&& are_equal_materials(existing, aMaterialConfig, true)) {
+				return it->second;
+			}
+		}
+
+		const auto id = static_cast<material_id_t>(mMaterials.size());
+		mMaterials.push_back(std::move(material));
+		mMaterialIdsByHash.emplace(key, id);
+		return id;
+	}
+
 	void model_t::set_material_config_for_mesh(mesh_index_t aMeshIndex, const material_config& aMaterialConfig)
 	{
-		assert(aMeshIndex < mMaterialConfigPerMesh.size());
-		mMaterialConfigPerMesh[aMeshIndex] = aMaterialConfig;
+		assert(aMeshIndex < mMaterialIdPerMesh.size());
+		mMaterialIdPerMesh[aMeshIndex] = intern_material_config(aMaterialConfig);
 	}
 
-	std::unordered_map<material_config, std::vector<size_t>> model_t::distinct_material_configs(bool aAlsoConsiderCpuOnlyDataForDistinctMaterials)
+	std::vector<std::tuple<material_id_t, std::vector<mesh_index_t>>> model_t::distinct_material_ids(bool aAlsoConsiderCpuOnlyDataForDistinctMaterials)
 	{
 		assert(mScene);
-		std::unordered_map<material_config, std::vector<size_t>> result;
+		std::vector<std::tuple<material_id_t, std::vector<mesh_index_t>>> result;
+		// Material IDs which are equal for the requested kind of equality are grouped together. Since there are far fewer
+		// IDs than meshes, materials are only compared once per ID, not once per mesh:
+		std::vector<std::optional<size_t>> groupOfId(mMaterials.size());
+		std::unordered_multimap<size_t, size_t> groupsByHash;
 		auto n = mScene->mNumMeshes;
 		for (decltype(n) i = 0; i < n; ++i) {
-			const aiMesh* paiMesh = mScene->mMeshes[i];
-			auto matConf = material_config_for_mesh(i);
+			const auto id = material_id_for_mesh(i);
+			if (groupOfId.size() <= id) {
+				groupOfId.resize(mMaterials.size());
+			}
+			if (!groupOfId[id].has_value()) {
+				const auto& material = mMaterials[id];
+				const auto hash = aAlsoConsiderCpuOnlyDataForDistinctMaterials ? material.mHashWithCpuOnlyData : material.mHash;
+				const auto [first, last] = groupsByHash.equal_range(hash);
+				for (auto it = first; it != last; ++it) {
+					const auto& representative = mMaterials[std::get<material_id_t>(result[it->second])];
+					if (are_equal_materials(representative.mConfig, material.mConfig, aAlsoConsiderCpuOnlyDataForDistinctMaterials)) {
+						groupOfId[id] = it->second;
+						break;
+					}
+				}
+				if (!groupOfId[id].has_value()) {
+					groupOfId[id] = result.size();
+					groupsByHash.emplace(hash, result.size());
+					result.emplace_back(id, std::vector<mesh_index_t>{});
+				}
+			}
+			std::get<std::vector<mesh_index_t>>(result[groupOfId[id].value()]).push_back(i);
+		}
+		return result;
+	}
+
+	std::unordered_map<material_config, std::vector<size_t>> model_t::distinct_material_configs(bool aAlsoConsiderCpuOnlyDataForDistinctMaterials)
+	{
+		std::unordered_map<material_config, std::vector<size_t>> result;
+		for (auto& [id, meshIndices] : distinct_material_ids(aAlsoConsiderCpuOnlyDataForDistinctMaterials)) {
+			auto matConf = material_config_for_id(id);
 			matConf.mIgnoreCpuOnlyDataForEquality = !aAlsoConsiderCpuOnlyDataForDistinctMaterials;
-			result[matConf].emplace_back(i);
+			auto& meshes = result[matConf];
+			meshes.insert(std::end(meshes), std::begin(meshIndices), std::end(meshIndices));
 		}
 		return result;
 	}
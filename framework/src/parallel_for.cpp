@@ -0,0 +1,52 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	worker_pool& worker_pool::instance()
+	{
+		static worker_pool sPool(std::max(1u, std::thread::hardware_concurrency()) - 1u);
+		return sPool;
+	}
+
+	worker_pool::worker_pool(size_t aNumWorkers)
+	{
+		for (size_t i = 0; i < aNumWorkers; ++i) {
+			mWorkers.emplace_back([this]() {
+				for (;;) {
+					std::function<void()> task;
+					{
+						std::unique_lock lock(mMutex);
+						mTaskAvailable.wait(lock, [this]() { return mStop || !mTasks.empty(); });
+						if (mTasks.empty()) {
+							return;
+						}
+						task = std::move(mTasks.front());
+						mTasks.pop_front();
+					}
+					task();
+				}
+			});
+		}
+	}
+
+	worker_pool::~worker_pool()
+	{
+		{
+			std::scoped_lock lock(mMutex);
+			mStop = true;
+		}
+		mTaskAvailable.notify_all();
+		for (auto& worker : mWorkers) {
+			worker.join();
+		}
+	}
+
+	void worker_pool::submit(std::function<void()> aTask)
+	{
+		{
+			std::scoped_lock lock(mMutex);
+			mTasks.push_back(std::move(aTask));
+		}
+		mTaskAvailable.notify_one();
+	}
+}
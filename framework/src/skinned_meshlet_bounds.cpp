@@ -0,0 +1,237 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	namespace
+	{
+		glm::vec3 skin_position(const glm::vec3& aPosition, const glm::uvec4& aBoneIndices, const glm::vec4& aBoneWeights, const std::vector<glm::mat4>& aBoneMatrices)
+		{
+			glm::vec4 result{ 0.0f };
+			for (int i = 0; i < 4; ++i) {
+				if (aBoneWeights[i] != 0.0f) {
+					result += aBoneWeights[i] * (aBoneMatrices[aBoneIndices[i]] * glm::vec4(aPosition, 1.0f));
+				}
+			}
+			return glm::vec3(result);
+		}
+
+		// The maximum number of times the interval between two samples is halved, see compute_skinned_meshlet_bounds
+		constexpr uint32_t cMaxSampleSubdivisions = 8u;
+
+		// Sample times in seconds: evenly distributed samples plus the times of all keys of all animated nodes within the clip
+		std::vector<double> sample_times_for_clip(const animation& aAnimation, const animation_clip_data& aClip, uint32_t aSamplesPerClip)
+		{
+			const auto start = aClip.start_ticks();
+			const auto end = aClip.end_ticks();
+			std::vector<double> ticks{ start, end };
+			for (uint32_t s = 0; s < aSamplesPerClip; ++s) {
+				ticks.push_back(aSamplesPerClip > 1 ? start + (end - start) * static_cast<double>(s) / static_cast<double>(aSamplesPerClip - 1) : start);
+			}
+			for (auto t : aAnimation.animation_key_times_for_clip_in_ticks(aClip)) {
+				if (t >= start && t <= end) {
+					ticks.push_back(t);
+				}
+			}
+			std::sort(std::begin(ticks), std::end(ticks));
+			ticks.erase(std::unique(std::begin(ticks), std::end(ticks)), std::end(ticks));
+
+			std::vector<double> times;
+			times.reserve(ticks.size());
+			for (auto t : ticks) {
+				times.push_back(t / aClip.mTicksPerSecond);
+			}
+			return times;
+		}
+	}
+
+	std::vector<skinned_meshlet_bounds> compute_skinned_meshlet_bounds(
+		const std::vector<meshlet>& aMeshlets,
+		const std::vector<glm::vec3>& aPositions,
+		const std::vector<glm::uvec4>& aBoneIndices,
+		const std::vector<glm::vec4>& aBoneWeights,
+		animation& aAnimation,
+		const std::vector<animation_clip_data>& aClips,
+		uint32_t aSamplesPerClip,
+		float aMaxRelativeSampleDistance)
+	{
+		if (aBoneIndices.size() != aPositions.size() || aBoneWeights.size() != aPositions.size()) {
+			throw gvk::runtime_error(fmt::format("Number of positions[{}], bone indices[{}], and bone weights[{}] passed to compute_skinned_meshlet_bounds do not match.", aPositions.size(), aBoneIndices.size(), aBoneWeights.size()));
+		}
+
+		std::vector<skinned_meshlet_bounds> result(aMeshlets.size());
+
+		// Bone sets and per-bone bind pose bounds:
+		uint32_t maxBoneIndex = 0;
+		for (size_t m = 0; m < aMeshlets.size(); ++m) {
+			auto& ml = aMeshlets[m];
+			auto& bounds = result[m];
+			std::map<uint32_t, meshlet_bounding_box> perBone;
+			for (uint32_t i = 0; i < ml.mVertexCount; ++i) {
+				const auto v = ml.mVertices[i];
+				for (int b = 0; b < 4; ++b) {
+					if (aBoneWeights[v][b] != 0.0f) {
+						perBone[aBoneIndices[v][b]].extend(aPositions[v]);
+						maxBoneIndex = std::max(maxBoneIndex, aBoneIndices[v][b]);
+					}
+				}
+			}
+			for (auto& [bone, box] : perBone) {
+				bounds.mBones.push_back(bone);
+				bounds.mPerBoneBounds.push_back(box);
+			}
+			bounds.mPerClipBounds.resize(aClips.size());
+		}
+
+		if (aClips.empty()) {
+			return result;
+		}
+
+		// Sampled bounds per clip:
+		meshlet_bounding_box bindPoseBounds;
+		for (const auto& pos : aPositions) {
+			bindPoseBounds.extend(pos);
+		}
+		const auto maxSampleDistance = glm::length(bindPoseBounds.mMax - bindPoseBounds.mMin) * aMaxRelativeSampleDistance;
+
+		std::vector<glm::mat4> boneMatrices(static_cast<size_t>(maxBoneIndex) + 1, glm::mat4{ 1.0f });
+		std::vector<float> maxDisplacement(aMeshlets.size());
+		for (size_t c = 0; c < aClips.size(); ++c) {
+			// Skins all meshlet vertices at the given time, extends the clip's bounds, and returns the skinned positions:
+			auto sample = [&](double aTime) {
+				aAnimation.animate(aClips[c], aTime, [&boneMatrices](mesh_bone_info aInfo, const glm::mat4& aInverseMeshRootMatrix, const glm::mat4& aTransformMatrix, const glm::mat4& aInverseBindPoseMatrix) {
+					const auto target = aInfo.mGlobalBoneIndexOffset + aInfo.mMeshLocalBoneIndex;
+					if (target < boneMatrices.size()) {
+						boneMatrices[target] = aInverseMeshRootMatrix * aTransformMatrix * aInverseBindPoseMatrix;
+					}
+				});
+
+				std::vector<glm::vec3> skinnedPositions;
+				for (size_t m = 0; m < aMeshlets.size(); ++m) {
+					auto& ml = aMeshlets[m];
+					auto& box = result[m].mPerClipBounds[c];
+					for (uint32_t i = 0; i < ml.mVertexCount; ++i) {
+						const auto v = ml.mVertices[i];
+						box.extend(skinnedPositions.emplace_back(skin_position(aPositions[v], aBoneIndices[v], aBoneWeights[v], boneMatrices)));
+					}
+				}
+				return skinnedPositions;
+			};
+
+			// Subdivides the interval between two samples until no vertex moves further than maxSampleDistance within it,
+			// and records the largest displacement per meshlet between two consecutive samples:
+			std::function<void(double, const std::vector<glm::vec3>&, double, const std::vector<glm::vec3>&, uint32_t)> refine;
+			refine = [&](double aTime0, const std::vector<glm::vec3>& aPositions0, double aTime1, const std::vector<glm::vec3>& aPositions1, uint32_t aDepth) {
+				float maxDisplacementInInterval = 0.0f;
+				for (size_t p = 0; p < aPositions0.size(); ++p) {
+					maxDisplacementInInterval = std::max(maxDisplacementInInterval, glm::length(aPositions1[p] - aPositions0[p]));
+				}
+				if (maxDisplacementInInterval > maxSampleDistance && aDepth < cMaxSampleSubdivisions) {
+					const auto timeMid = (aTime0 + aTime1) * 0.5;
+					const auto positionsMid = sample(timeMid);
+					refine(aTime0, aPositions0, timeMid, positionsMid, aDepth + 1);
+					refine(timeMid, positionsMid, aTime1, aPositions1, aDepth + 1);
+					return;
+				}
+				size_t p = 0;
+				for (size_t m = 0; m < aMeshlets.size(); ++m) {
+					for (uint32_t i = 0; i < aMeshlets[m].mVertexCount; ++i, ++p) {
+						maxDisplacement[m] = std::max(maxDisplacement[m], glm::length(aPositions1[p] - aPositions0[p]));
+					}
+				}
+			};
+
+			std::fill(std::begin(maxDisplacement), std::end(maxDisplacement), 0.0f);
+			const auto times = sample_times_for_clip(aAnimation, aClips[c], aSamplesPerClip);
+			auto previousPositions = sample(times.front());
+			for (size_t t = 1; t < times.size(); ++t) {
+				auto positions = sample(times[t]);
+				refine(times[t - 1], previousPositions, times[t], positions, 0u);
+				previousPositions = std::move(positions);
+			}
+
+			// Account for motion between the samples:
+			for (size_t m = 0; m < aMeshlets.size(); ++m) {
+				auto& box = result[m].mPerClipBounds[c];
+				if (!box.empty()) {
+					box.mMin -= glm::vec3{ maxDisplacement[m] };
+					box.mMax += glm::vec3{ maxDisplacement[m] };
+				}
+			}
+		}
+
+		return result;
+	}
+
+	std::vector<skinned_meshlet_bounds> compute_skinned_meshlet_bounds_cached(
+		serializer& aSerializer,
+		const std::vector<meshlet>& aMeshlets,
+		const std::vector<glm::vec3>& aPositions,
+		const std::vector<glm::uvec4>& aBoneIndices,
+		const std::vector<glm::vec4>& aBoneWeights,
+		animation& aAnimation,
+		const std::vector<animation_clip_data>& aClips,
+		uint32_t aSamplesPerClip,
+		float aMaxRelativeSampleDistance)
+	{
+		std::vector<skinned_meshlet_bounds> result;
+		if (aSerializer.mode() == serializer::mode::serialize) {
+			result = compute_skinned_meshlet_bounds(aMeshlets, aPositions, aBoneIndices, aBoneWeights, aAnimation, aClips, aSamplesPerClip, aMaxRelativeSampleDistance);
+		}
+		aSerializer.archive(result);
+		return result;
+	}
+
+	std::tuple<std::vector<skinned_meshlet_bounds_gpu_data>, std::vector<uint32_t>, std::vector<glm::vec4>> convert_for_gpu_usage(const std::vector<skinned_meshlet_bounds>& aBounds, std::optional<size_t> aClipIndex)
+	{
+		std::vector<skinned_meshlet_bounds_gpu_data> gpuBounds;
+		std::vector<uint32_t> boneIndices;
+		std::vector<glm::vec4> boneBoxes;
+		gpuBounds.reserve(aBounds.size());
+
+		for (const auto& bounds : aBounds) {
+			meshlet_bounding_box box;
+			if (bounds.mPerClipBounds.empty()) {
+				for (const auto& boneBox : bounds.mPerBoneBounds) {
+					box.extend(boneBox);
+				}
+			}
+			else if (aClipIndex.has_value()) {
+				if (aClipIndex.value() >= bounds.mPerClipBounds.size()) {
+					throw gvk::runtime_error(fmt::format("Clip index {} is out of range, bounds have been computed for {} clips.", aClipIndex.value(), bounds.mPerClipBounds.size()));
+				}
+				box = bounds.mPerClipBounds[aClipIndex.value()];
+			}
+			else {
+				box = bounds.animated_bounds();
+			}
+
+			auto& newEntry = gpuBounds.emplace_back();
+			newEntry.mBoundingSphere = glm::vec4(box.center(), box.radius());
+			newEntry.mMin = glm::vec4(box.mMin, 0.0f);
+			newEntry.mMax = glm::vec4(box.mMax, 0.0f);
+			newEntry.mBoneDataOffset = static_cast<uint32_t>(boneIndices.size());
+			newEntry.mBoneCount = static_cast<uint32_t>(bounds.mBones.size());
+			newEntry.mPadding[0] = newEntry.mPadding[1] = 0u;
+
+			boneIndices.insert(std::end(boneIndices), std::begin(bounds.mBones), std::end(bounds.mBones));
+			for (const auto& boneBox : bounds.mPerBoneBounds) {
+				boneBoxes.emplace_back(boneBox.mMin, 0.0f);
+				boneBoxes.emplace_back(boneBox.mMax, 0.0f);
+			}
+		}
+
+		return std::make_tuple(std::move(gpuBounds), std::move(boneIndices), std::move(boneBoxes));
+	}
+
+	std::tuple<std::vector<skinned_meshlet_bounds_gpu_data>, std::vector<uint32_t>, std::vector<glm::vec4>> convert_for_gpu_usage_cached(serializer& aSerializer, const std::vector<skinned_meshlet_bounds>& aBounds, std::optional<size_t> aClipIndex)
+	{
+		std::tuple<std::vector<skinned_meshlet_bounds_gpu_data>, std::vector<uint32_t>, std::vector<glm::vec4>> result;
+		if (aSerializer.mode() == serializer::mode::serialize) {
+			result = convert_for_gpu_usage(aBounds, aClipIndex);
+		}
+		aSerializer.archive(std::get<0>(result));
+		aSerializer.archive(std::get<1>(result));
+		aSerializer.archive(std::get<2>(result));
+		return result;
+	}
+}
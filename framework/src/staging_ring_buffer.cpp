@@ -0,0 +1,188 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	struct staging_ring_buffer::region
+	{
+		size_t mBegin;
+		size_t mEnd;
+		std::weak_ptr<void> mLease;
+		bool mReleased = false;
+	};
+
+	struct staging_ring_buffer::state
+	{
+		using mapping_type = decltype(std::declval<avk::buffer_t&>().map_memory(avk::mapping_access::write));
+
+		avk::buffer mBuffer;
+		std::optional<mapping_type> mMapping;
+		std::byte* mMemory = nullptr;
+		size_t mCapacity = 0;
+
+		mutable std::mutex mMutex;
+		// The regions which have not been released yet, in allocation order
+		std::deque<region> mRegions;
+
+		// Must be invoked while mMutex is locked
+		void release(size_t aBegin)
+		{
+			const auto it = std::find_if(std::begin(mRegions), std::end(mRegions), [aBegin](const region& r) { return r.mBegin == aBegin && !r.mReleased; });
+			assert(std::end(mRegions) != it);
+			it->mReleased = true;
+			while (!mRegions.empty() && mRegions.front().mReleased) {
+				mRegions.pop_front();
+			}
+		}
+	};
+
+	namespace
+	{
+		size_t align_up(size_t aOffset, size_t aAlignment)
+		{
+			return (aOffset + aAlignment - 1) / aAlignment * aAlignment;
+		}
+	}
+
+	staging_ring_buffer::staging_ring_buffer(size_t aCapacity)
+		: mState{ std::make_shared<state>() }
+	{
+		mState->mBuffer = context().create_buffer(
+			AVK_STAGING_BUFFER_MEMORY_USAGE,
+			vk::BufferUsageFlagBits::eTransferSrc,
+			avk::generic_buffer_meta::create_from_size(aCapacity)
+		);
+		// The mapping stays alive as long as the buffer:
+		mState->mMapping.emplace(mState->mBuffer->map_memory(avk::mapping_access::write));
+		mState->mMemory = static_cast<std::byte*>(mState->mMapping->get());
+		mState->mCapacity = aCapacity;
+	}
+
+	std::optional<staging_allocation> staging_ring_buffer::allocate(size_t aSize, size_t aAlignment)
+	{
+		if (0 == aSize || aSize > mState->mCapacity) {
+			return {};
+		}
+
+		std::scoped_lock lock(mState->mMutex);
+		auto& regions = mState->mRegions;
+		std::optional<size_t> begin;
+		if (regions.empty()) {
+			begin = 0;
+		}
+		else {
+			const auto oldest = regions.front().mBegin;
+			const auto newest = align_up(regions.back().mEnd, aAlignment);
+			const bool wrapped = regions.back().mBegin < oldest;
+			if (wrapped) {
+				// Free memory is between the newest and the oldest region:
+				if (newest + aSize <= oldest) {
+					begin = newest;
+				}
+			}
+			else if (newest + aSize <= mState->mCapacity) {
+				// Free memory is after the newest region...
+				begin = newest;
+			}
+			else if (aSize <= oldest) {
+				// ...and before the oldest region:
+				begin = 0;
+			}
+		}
+		if (!begin.has_value()) {
+			return {};
+		}
+
+		// The lease releases the region when its last copy is destroyed. It holds the state, so that the buffer stays
+		// alive while regions are in use, even if this staging_ring_buffer has been destroyed in the meantime.
+		std::shared_ptr<void> lease(mState.get(), [lState = mState, lBegin = *begin](void*) {
+			std::scoped_lock lock(lState->mMutex);
+			lState->release(lBegin);
+		});
+		regions.push_back(region{ *begin, *begin + aSize, lease });
+		return staging_allocation{ std::span<std::byte>(mState->mMemory + *begin, aSize), static_cast<vk::DeviceSize>(*begin), std::move(lease) };
+	}
+
+	std::optional<staging_allocation> staging_ring_buffer::find(const void* aData, size_t aSize) const
+	{
+		const auto* data = static_cast<const std::byte*>(aData);
+		if (data < mState->mMemory || data + aSize > mState->mMemory + mState->mCapacity) {
+			return {};
+		}
+		const auto begin = static_cast<size_t>(data - mState->mMemory);
+
+		std::scoped_lock lock(mState->mMutex);
+		for (const auto& r : mState->mRegions) {
+			if (r.mReleased || begin < r.mBegin || begin + aSize > r.mEnd) {
+				continue;
+			}
+			auto lease = r.mLease.lock();
+			if (!lease) {
+				return {};
+			}
+			return staging_allocation{ std::span<std::byte>(mState->mMemory + begin, aSize), static_cast<vk::DeviceSize>(begin), std::move(lease) };
+		}
+		return {};
+	}
+
+	image_data_output_allocator staging_ring_buffer::output_allocator()
+	{
+		return [this](size_t aSize, size_t aAlignment) -> std::optional<image_data_output_region> {
+			auto allocation = allocate(aSize, aAlignment);
+			if (!allocation.has_value()) {
+				return {};
+			}
+			return image_data_output_region{ allocation->mMemory, std::move(allocation->mLease) };
+		};
+	}
+
+	const avk::buffer_t& staging_ring_buffer::buffer() const
+	{
+		return mState->mBuffer.get();
+	}
+
+	size_t staging_ring_buffer::capacity() const
+	{
+		return mState->mCapacity;
+	}
+
+	size_t staging_ring_buffer::used() const
+	{
+		std::scoped_lock lock(mState->mMutex);
+		const auto& regions = mState->mRegions;
+		if (regions.empty()) {
+			return 0;
+		}
+		const auto oldest = regions.front().mBegin;
+		const auto newest = regions.back().mEnd;
+		return newest > oldest ? newest - oldest : mState->mCapacity - oldest + newest;
+	}
+
+	void staging_ring_buffer::record_copy_to_image_layer_mip_level(avk::command_buffer_t& aCommandBuffer, const staging_allocation& aAllocation, avk::image_t& aImage, uint32_t aLayer, uint32_t aLevel) const
+	{
+		const auto& imgExtent = aImage.create_info().extent;
+		const auto copyRegion = vk::BufferImageCopy()
+			.setBufferOffset(aAllocation.mOffset)
+			// The texels are tightly packed:
+			.setBufferRowLength(0)
+			.setBufferImageHeight(0)
+			.setImageSubresource(vk::ImageSubresourceLayers()
+				.setAspectMask(vk::ImageAspectFlagBits::eColor)
+				.setMipLevel(aLevel)
+				.setBaseArrayLayer(aLayer)
+				.setLayerCount(1u))
+			.setImageOffset({ 0u, 0u, 0u })
+			.setImageExtent(vk::Extent3D{ std::max(imgExtent.width >> aLevel, 1u), std::max(imgExtent.height >> aLevel, 1u), std::max(imgExtent.depth >> aLevel, 1u) });
+
+		aCommandBuffer.handle().copyBufferToImage(mState->mBuffer->handle(), aImage.handle(), vk::ImageLayout::eTransferDstOptimal, { copyRegion });
+	}
+
+	size_t texel_block_size(vk::Format aFormat, vk::Extent3D aExtent, size_t aSize)
+	{
+		size_t numBlocks = static_cast<size_t>(aExtent.width) * aExtent.height * aExtent.depth;
+		if (avk::is_block_compressed_format(aFormat)) {
+			// All block-compressed formats which are used for textures have blocks of 4x4 texels:
+			numBlocks = static_cast<size_t>((aExtent.width + 3) / 4) * ((aExtent.height + 3) / 4) * aExtent.depth;
+		}
+		return std::max<size_t>(aSize / std::max<size_t>(numBlocks, 1), 1);
+	}
+}
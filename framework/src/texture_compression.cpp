@@ -0,0 +1,331 @@
+#include <gvk.hpp>
+#include <stb_dxt.h>
+
+namespace gvk
+{
+	namespace
+	{
+		bool is_bgra(vk::Format aFormat)
+		{
+			return vk::Format::eB8G8R8A8Unorm == aFormat || vk::Format::eB8G8R8A8Srgb == aFormat;
+		}
+
+		bool is_srgb(vk::Format aFormat)
+		{
+			return vk::Format::eR8G8B8A8Srgb == aFormat || vk::Format::eB8G8R8A8Srgb == aFormat;
+		}
+
+		size_t block_size_of(texture_compression aCompression)
+		{
+			return texture_compression::bc1 == aCompression || texture_compression::bc4 == aCompression ? 8 : 16;
+		}
+
+		// Interpolation weights of BC7's 4-bit indices, in 1/64ths
+		constexpr std::array<int, 16> sBc7Weights = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		// Writes bit fields into a 128-bit block, starting at the least significant bit
+		struct block_bit_writer
+		{
+			void write(uint64_t aValue, uint32_t aNumBits)
+			{
+				const auto word = mPosition / 64;
+				const auto shift = mPosition % 64;
+				mWords[word] |= aValue << shift;
+				if (shift + aNumBits > 64) {
+					mWords[word + 1] |= aValue >> (64 - shift);
+				}
+				mPosition += aNumBits;
+			}
+
+			std::array<uint64_t, 2> mWords = {};
+			uint32_t mPosition = 0;
+		};
+
+		// A BC7 mode 6 encoding of a block: one subset, RGBA endpoints with 7 bits plus one p-bit each, and 4-bit indices
+		struct bc7_mode6_block
+		{
+			std::array<std::array<int, 4>, 2> mEndpoints; // 7-bit values
+			std::array<int, 2> mPBits;
+			std::array<int, 16> mIndices;
+			int mError = std::numeric_limits<int>::max();
+		};
+
+		// Quantizes the endpoints with all combinations of p-bits, assigns the closest palette entries to the texels, and returns the best encoding
+		bc7_mode6_block encode_bc7_mode6(const uint8_t* aTexels, const std::array<float, 4>& aEndpoint0, const std::array<float, 4>& aEndpoint1)
+		{
+			bc7_mode6_block best;
+			for (int p0 = 0; p0 < 2; ++p0) {
+				for (int p1 = 0; p1 < 2; ++p1) {
+					bc7_mode6_block candidate;
+					candidate.mPBits = { p0, p1 };
+					std::array<std::array<int, 4>, 2> values;
+					for (int c = 0; c < 4; ++c) {
+						candidate.mEndpoints[0][c] = std::clamp(static_cast<int>(std::round((aEndpoint0[c] - p0) * 0.5f)), 0, 127);
+						candidate.mEndpoints[1][c] = std::clamp(static_cast<int>(std::round((aEndpoint1[c] - p1) * 0.5f)), 0, 127);
+						values[0][c] = candidate.mEndpoints[0][c] * 2 + p0;
+						values[1][c] = candidate.mEndpoints[1][c] * 2 + p1;
+					}
+
+					std::array<std::array<int, 4>, 16> palette;
+					for (int i = 0; i < 16; ++i) {
+						for (int c = 0; c < 4; ++c) {
+							palette[i][c] = (values[0][c] * (64 - sBc7Weights[i]) + values[1][c] * sBc7Weights[i] + 32) >> 6;
+						}
+					}
+
+					// The closest palette entry is next to the projection of the texel onto the line between the endpoints
+					std::array<int, 4> direction;
+					int lengthSquared = 0;
+					for (int c = 0; c < 4; ++c) {
+						direction[c] = values[1][c] - values[0][c];
+						lengthSquared += direction[c] * direction[c];
+					}
+					candidate.mError = 0;
+					for (int t = 0; t < 16; ++t) {
+						const uint8_t* texel = aTexels + t * 4;
+						int guess = 0;
+						if (lengthSquared > 0) {
+							int projection = 0;
+							for (int c = 0; c < 4; ++c) {
+								projection += (texel[c] - values[0][c]) * direction[c];
+							}
+							guess = std::clamp(static_cast<int>(std::round(15.0f * static_cast<float>(projection) / static_cast<float>(lengthSquared))), 0, 15);
+						}
+						int bestIndex = guess;
+						int bestError = std::numeric_limits<int>::max();
+						for (int i = std::max(guess - 1, 0); i <= std::min(guess + 1, 15); ++i) {
+							int error = 0;
+							for (int c = 0; c < 4; ++c) {
+								const auto d = texel[c] - palette[i][c];
+								error += d * d;
+							}
+							if (error < bestError) {
+								bestError = error;
+								bestIndex = i;
+							}
+						}
+						candidate.mIndices[t] = bestIndex;
+						candidate.mError += bestError;
+					}
+
+					if (candidate.mError < best.mError) {
+						best = candidate;
+					}
+				}
+			}
+			return best;
+		}
+
+		void compress_bc7_block(const uint8_t* aTexels, uint8_t* aBlock)
+		{
+			// Find the principal axis of the texels' colors by power iteration on their covariance matrix
+			std::array<float, 4> mean = {};
+			for (int t = 0; t < 16; ++t) {
+				for (int c = 0; c < 4; ++c) {
+					mean[c] += aTexels[t * 4 + c] / 16.0f;
+				}
+			}
+			std::array<std::array<float, 4>, 4> covariance = {};
+			for (int t = 0; t < 16; ++t) {
+				for (int r = 0; r < 4; ++r) {
+					for (int c = 0; c < 4; ++c) {
+						covariance[r][c] += (aTexels[t * 4 + r] - mean[r]) * (aTexels[t * 4 + c] - mean[c]);
+					}
+				}
+			}
+			std::array<float, 4> axis = { 1.0f, 1.0f, 1.0f, 1.0f };
+			for (int iteration = 0; iteration < 8; ++iteration) {
+				std::array<float, 4> next = {};
+				for (int r = 0; r < 4; ++r) {
+					for (int c = 0; c < 4; ++c) {
+						next[r] += covariance[r][c] * axis[c];
+					}
+				}
+				const auto length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+				if (length < 1e-6f) {
+					break;
+				}
+				for (int c = 0; c < 4; ++c) {
+					axis[c] = next[c] / length;
+				}
+			}
+
+			// The initial endpoints are the extremes of the texels' projections onto the axis
+			float minProjection = std::numeric_limits<float>::max();
+			float maxProjection = std::numeric_limits<float>::lowest();
+			for (int t = 0; t < 16; ++t) {
+				float projection = 0.0f;
+				for (int c = 0; c < 4; ++c) {
+					projection += (aTexels[t * 4 + c] - mean[c]) * axis[c];
+				}
+				minProjection = std::min(minProjection, projection);
+				maxProjection = std::max(maxProjection, projection);
+			}
+			std::array<float, 4> endpoint0, endpoint1;
+			for (int c = 0; c < 4; ++c) {
+				endpoint0[c] = std::clamp(mean[c] + axis[c] * minProjection, 0.0f, 255.0f);
+				endpoint1[c] = std::clamp(mean[c] + axis[c] * maxProjection, 0.0f, 255.0f);
+			}
+			auto best = encode_bc7_mode6(aTexels, endpoint0, endpoint1);
+
+			// Refine the endpoints by a least squares fit to the chosen indices
+			float a = 0.0f, b = 0.0f, d = 0.0f;
+			std::array<float, 4> rhs0 = {}, rhs1 = {};
+			for (int t = 0; t < 16; ++t) {
+				const auto w = sBc7Weights[best.mIndices[t]] / 64.0f;
+				a += (1.0f - w) * (1.0f - w);
+				b += (1.0f - w) * w;
+				d += w * w;
+				for (int c = 0; c < 4; ++c) {
+					rhs0[c] += (1.0f - w) * aTexels[t * 4 + c];
+					rhs1[c] += w * aTexels[t * 4 + c];
+				}
+			}
+			const auto determinant = a * d - b * b;
+			if (std::abs(determinant) > 1e-6f) {
+				for (int c = 0; c < 4; ++c) {
+					endpoint0[c] = std::clamp((d * rhs0[c] - b * rhs1[c]) / determinant, 0.0f, 255.0f);
+					endpoint1[c] = std::clamp((a * rhs1[c] - b * rhs0[c]) / determinant, 0.0f, 255.0f);
+				}
+				auto refined = encode_bc7_mode6(aTexels, endpoint0, endpoint1);
+				if (refined.mError < best.mError) {
+					best = refined;
+				}
+			}
+
+			// The most significant bit of the first index is implicitly 0 => swap the endpoints if necessary
+			if (best.mIndices[0] >= 8) {
+				std::swap(best.mEndpoints[0], best.mEndpoints[1]);
+				std::swap(best.mPBits[0], best.mPBits[1]);
+				for (auto& index : best.mIndices) {
+					index = 15 - index;
+				}
+			}
+
+			block_bit_writer writer;
+			writer.write(1 << 6, 7); // mode 6
+			for (int c = 0; c < 4; ++c) {
+				writer.write(best.mEndpoints[0][c], 7);
+				writer.write(best.mEndpoints[1][c], 7);
+			}
+			writer.write(best.mPBits[0], 1);
+			writer.write(best.mPBits[1], 1);
+			writer.write(best.mIndices[0], 3);
+			for (int t = 1; t < 16; ++t) {
+				writer.write(best.mIndices[t], 4);
+			}
+			std::memcpy(aBlock, writer.mWords.data(), 16);
+		}
+
+		// Compresses a block of 4x4 RGBA texels
+		void compress_block(const std::array<uint8_t, 64>& aTexels, texture_compression aCompression, uint8_t* aBlock)
+		{
+			switch (aCompression) {
+			case texture_compression::bc1:
+				stb_compress_dxt_block(aBlock, aTexels.data(), 0, STB_DXT_HIGHQUAL);
+				break;
+			case texture_compression::bc3:
+				stb_compress_dxt_block(aBlock, aTexels.data(), 1, STB_DXT_HIGHQUAL);
+				break;
+			case texture_compression::bc4:
+			{
+				std::array<uint8_t, 16> red;
+				for (int t = 0; t < 16; ++t) {
+					red[t] = aTexels[t * 4];
+				}
+				stb_compress_bc4_block(aBlock, red.data());
+				break;
+			}
+			case texture_compression::bc5:
+			{
+				std::array<uint8_t, 32> redGreen;
+				for (int t = 0; t < 16; ++t) {
+					redGreen[t * 2 + 0] = aTexels[t * 4 + 0];
+					redGreen[t * 2 + 1] = aTexels[t * 4 + 1];
+				}
+				stb_compress_bc5_block(aBlock, redGreen.data());
+				break;
+			}
+			case texture_compression::bc7:
+				compress_bc7_block(aTexels.data(), aBlock);
+				break;
+			default:
+				throw gvk::logic_error("Invalid texture_compression");
+			}
+		}
+	}
+
+	bool can_compress_texture(vk::Format aFormat)
+	{
+		switch (aFormat) {
+		case vk::Format::eR8G8B8A8Unorm:
+		case vk::Format::eR8G8B8A8Srgb:
+		case vk::Format::eB8G8R8A8Unorm:
+		case vk::Format::eB8G8R8A8Srgb:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	vk::Format compressed_format_for(texture_compression aCompression, vk::Format aUncompressedFormat)
+	{
+		const auto srgb = is_srgb(aUncompressedFormat);
+		switch (aCompression) {
+		case texture_compression::bc1:
+			return srgb ? vk::Format::eBc1RgbaSrgbBlock : vk::Format::eBc1RgbaUnormBlock;
+		case texture_compression::bc3:
+			return srgb ? vk::Format::eBc3SrgbBlock : vk::Format::eBc3UnormBlock;
+		case texture_compression::bc7:
+			return srgb ? vk::Format::eBc7SrgbBlock : vk::Format::eBc7UnormBlock;
+		case texture_compression::bc4:
+		case texture_compression::bc5:
+			if (srgb) {
+				throw gvk::runtime_error(fmt::format("There is no sRGB variant of BC{}, textures in format {} can not be compressed with it.",
+					texture_compression::bc4 == aCompression ? 4 : 5, vk::to_string(aUncompressedFormat)));
+			}
+			return texture_compression::bc4 == aCompression ? vk::Format::eBc4UnormBlock : vk::Format::eBc5UnormBlock;
+		default:
+			throw gvk::logic_error("texture_compression::none has no compressed format.");
+		}
+	}
+
+	std::vector<std::byte> compress_texture(const void* aTexels, vk::Extent3D aExtent, vk::Format aFormat, texture_compression aCompression)
+	{
+		if (!can_compress_texture(aFormat)) {
+			throw gvk::runtime_error(fmt::format("Textures in format {} can not be block-compressed on the CPU.", vk::to_string(aFormat)));
+		}
+		if (aExtent.depth != 1) {
+			throw gvk::runtime_error("Only 2D textures can be block-compressed on the CPU.");
+		}
+		compressed_format_for(aCompression, aFormat); // throws for invalid combinations
+
+		const auto blocksX = (aExtent.width + 3) / 4;
+		const auto blocksY = (aExtent.height + 3) / 4;
+		const auto blockSize = block_size_of(aCompression);
+		const auto bgra = is_bgra(aFormat);
+		const auto* texels = static_cast<const uint8_t*>(aTexels);
+
+		std::vector<std::byte> result(static_cast<size_t>(blocksX) * blocksY * blockSize);
+		parallel_for(blocksY, [&](size_t aBlockY) {
+			std::array<uint8_t, 64> block;
+			for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+				// Gather the block's texels in RGBA order, repeating the edge texels for blocks which are not fully covered
+				for (uint32_t y = 0; y < 4; ++y) {
+					const auto sourceY = std::min(static_cast<uint32_t>(aBlockY) * 4 + y, aExtent.height - 1);
+					for (uint32_t x = 0; x < 4; ++x) {
+						const auto sourceX = std::min(blockX * 4 + x, aExtent.width - 1);
+						const uint8_t* texel = texels + (static_cast<size_t>(sourceY) * aExtent.width + sourceX) * 4;
+						uint8_t* target = block.data() + (y * 4 + x) * 4;
+						target[0] = texel[bgra ? 2 : 0];
+						target[1] = texel[1];
+						target[2] = texel[bgra ? 0 : 2];
+						target[3] = texel[3];
+					}
+				}
+				compress_block(block, aCompression, reinterpret_cast<uint8_t*>(result.data() + (aBlockY * blocksX + blockX) * blockSize));
+			}
+		});
+		return result;
+	}
+}
@@ -0,0 +1,280 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	namespace
+	{
+		uint32_t align_up(uint32_t aValue, uint32_t aAlignment)
+		{
+			return (aValue + aAlignment - 1u) / aAlignment * aAlignment;
+		}
+
+		uint32_t full_mip_chain_levels(uint32_t aWidth, uint32_t aHeight)
+		{
+			return 1u + static_cast<uint32_t>(std::floor(std::log2(static_cast<double>(std::max({ aWidth, aHeight, 1u })))));
+		}
+
+		// Fills atlases with shelves of textures of the same format. Textures which do not end up in an atlas together with
+		// another texture are added to aNotInAtlas.
+		void plan_atlases(std::span<const texture_packing_candidate> aCandidates, std::vector<size_t> aIndices, const texture_packing_config& aConfig, std::vector<texture_atlas_plan>& aAtlases, std::vector<size_t>& aNotInAtlas)
+		{
+			// Textures are aligned to the texels of the coarsest level, which still contains one texel of padding around every texture:
+			const uint32_t coarsestLevel = 0u == aConfig.mPadding ? 0u : static_cast<uint32_t>(std::floor(std::log2(static_cast<double>(aConfig.mPadding))));
+			const uint32_t alignment = 1u << coarsestLevel;
+			const uint32_t maxExtent = aConfig.mAtlasExtent / alignment * alignment;
+
+			std::stable_sort(std::begin(aIndices), std::end(aIndices), [&aCandidates](size_t a, size_t b) {
+				const auto& ea = aCandidates[a].mExtent;
+				const auto& eb = aCandidates[b].mExtent;
+				return ea.height != eb.height ? ea.height > eb.height : ea.width > eb.width;
+			});
+
+			const auto format = aCandidates[aIndices.front()].mFormat;
+			texture_atlas_plan atlas{ format, {}, 1u, aConfig.mPadding, {} };
+			uint32_t x = 0, y = 0, shelfHeight = 0, width = 0;
+			auto finishAtlas = [&]() {
+				if (atlas.mPlacements.size() < 2) {
+					// A single texture is not worth an atlas:
+					for (const auto& placement : atlas.mPlacements) {
+						aNotInAtlas.push_back(placement.mCandidate);
+					}
+				}
+				else {
+					atlas.mExtent = vk::Extent3D{ width, y + shelfHeight, 1u };
+					atlas.mLevels = std::min(coarsestLevel + 1u, full_mip_chain_levels(atlas.mExtent.width, atlas.mExtent.height));
+					aAtlases.push_back(std::move(atlas));
+				}
+				atlas = texture_atlas_plan{ format, {}, 1u, aConfig.mPadding, {} };
+				x = y = shelfHeight = width = 0;
+			};
+
+			for (auto i : aIndices) {
+				const auto& extent = aCandidates[i].mExtent;
+				const uint32_t slotWidth = align_up(extent.width + 2u * aConfig.mPadding, alignment);
+				const uint32_t slotHeight = align_up(extent.height + 2u * aConfig.mPadding, alignment);
+				if (slotWidth > maxExtent || slotHeight > maxExtent) {
+					aNotInAtlas.push_back(i);
+					continue;
+				}
+				if (x + slotWidth > maxExtent) {
+					// Start the next shelf:
+					x = 0;
+					y += shelfHeight;
+					shelfHeight = 0;
+				}
+				if (y + slotHeight > maxExtent) {
+					finishAtlas();
+				}
+				atlas.mPlacements.push_back(texture_atlas_placement{ i, x + aConfig.mPadding, y + aConfig.mPadding });
+				x += slotWidth;
+				width = std::max(width, x);
+				shelfHeight = std::max(shelfHeight, slotHeight);
+			}
+			finishAtlas();
+		}
+
+		// Writes aSize bytes into staging memory and records their copy into one layer and level of the image. The staging
+		// memory is taken from the context's ring buffer, and only if it is full, from a dedicated staging buffer.
+		void upload_layer_level(avk::sync& aSyncHandler, avk::command_buffer_t& aCommandBuffer, avk::image& aImage, uint32_t aLayer, uint32_t aLevel, size_t aSize, size_t aBlockSize, const std::function<void(std::span<std::byte>)>& aWrite, std::vector<std::shared_ptr<void>>& aStagingLeases, std::vector<avk::buffer>& aStagingBuffers)
+		{
+			auto& stagingRing = context().staging_ring();
+			if (auto staging = stagingRing.allocate(aSize, std::lcm<size_t>(16, aBlockSize))) {
+				aWrite(staging->mMemory);
+				// Memory writes are not overlapping => no barriers should be fine.
+				stagingRing.record_copy_to_image_layer_mip_level(aCommandBuffer, *staging, aImage.get(), aLayer, aLevel);
+				aStagingLeases.push_back(std::move(staging->mLease));
+				return;
+			}
+
+			std::vector<std::byte> data(aSize);
+			aWrite(data);
+			auto& sb = aStagingBuffers.emplace_back(context().create_buffer(
+				AVK_STAGING_BUFFER_MEMORY_USAGE,
+				vk::BufferUsageFlagBits::eTransferSrc,
+				avk::generic_buffer_meta::create_from_size(aSize)
+			));
+			sb->fill(data.data(), 0, avk::sync::not_required());
+			// Memory writes are not overlapping => no barriers should be fine.
+			avk::copy_buffer_to_image_layer_mip_level(avk::const_referenced(sb), avk::referenced(aImage), aLayer, aLevel, {}, avk::sync::auxiliary_with_barriers(aSyncHandler, {}, {}));
+		}
+	}
+
+	texture_packing_plan plan_texture_packing(std::span<const texture_packing_candidate> aCandidates, const texture_packing_config& aConfig)
+	{
+		texture_packing_plan result;
+
+		// Small textures which clamp to the edge are packed into atlases, grouped by their formats:
+		std::map<vk::Format, std::vector<size_t>> atlasCandidates;
+		std::vector<size_t> arrayCandidates;
+		for (size_t i = 0; i < aCandidates.size(); ++i) {
+			const auto& c = aCandidates[i];
+			if (!c.mPackable) {
+				result.mUnpacked.push_back(i);
+			}
+			else if (c.mClampsToEdge && !avk::is_block_compressed_format(c.mFormat)
+				&& c.mExtent.width <= aConfig.mMaxAtlasTextureExtent && c.mExtent.height <= aConfig.mMaxAtlasTextureExtent) {
+				atlasCandidates[c.mFormat].push_back(i);
+			}
+			else {
+				arrayCandidates.push_back(i);
+			}
+		}
+		for (auto& [format, indices] : atlasCandidates) {
+			plan_atlases(aCandidates, std::move(indices), aConfig, result.mAtlases, arrayCandidates);
+		}
+
+		// The remaining textures are packed into array textures if requested, and if there are enough with the same format, size, and number of levels:
+		if (!aConfig.mMinArrayLayers.has_value()) {
+			result.mUnpacked.insert(std::end(result.mUnpacked), std::begin(arrayCandidates), std::end(arrayCandidates));
+			std::sort(std::begin(result.mUnpacked), std::end(result.mUnpacked));
+			return result;
+		}
+		std::map<std::tuple<vk::Format, uint32_t, uint32_t, uint32_t>, std::vector<size_t>> arrayGroups;
+		std::sort(std::begin(arrayCandidates), std::end(arrayCandidates));
+		for (auto i : arrayCandidates) {
+			const auto& c = aCandidates[i];
+			arrayGroups[std::make_tuple(c.mFormat, c.mExtent.width, c.mExtent.height, c.mLevels)].push_back(i);
+		}
+		const size_t minLayers = std::max(*aConfig.mMinArrayLayers, 2u);
+		const size_t maxLayers = std::clamp(aConfig.mMaxArrayLayers, 2u, 0x7FFEu); // The layer must fit into a texture index, see array_texture_index
+		for (const auto& [key, indices] : arrayGroups) {
+			for (size_t first = 0; first < indices.size(); first += maxLayers) {
+				const auto last = std::min(first + maxLayers, indices.size());
+				if (last - first < minLayers) {
+					result.mUnpacked.insert(std::end(result.mUnpacked), std::begin(indices) + first, std::begin(indices) + last);
+					continue;
+				}
+				result.mArrays.push_back(texture_array_plan{ std::vector<size_t>(std::begin(indices) + first, std::begin(indices) + last) });
+			}
+		}
+
+		std::sort(std::begin(result.mUnpacked), std::end(result.mUnpacked));
+		return result;
+	}
+
+	glm::vec4 atlas_offset_tiling(const glm::vec4& aOffsetTiling, const texture_atlas_plan& aAtlas, const texture_atlas_placement& aPlacement, vk::Extent3D aTextureExtent)
+	{
+		const glm::vec2 atlasExtent{ static_cast<float>(aAtlas.mExtent.width), static_cast<float>(aAtlas.mExtent.height) };
+		const glm::vec2 scale = glm::vec2{ static_cast<float>(aTextureExtent.width), static_cast<float>(aTextureExtent.height) } / atlasExtent;
+		const glm::vec2 bias = glm::vec2{ static_cast<float>(aPlacement.mX), static_cast<float>(aPlacement.mY) } / atlasExtent;
+		// (uv * tiling + offset) * scale + bias == uv * (tiling * scale) + (offset * scale + bias)
+		return glm::vec4{
+			glm::vec2{ aOffsetTiling.x, aOffsetTiling.y } * scale + bias,
+			glm::vec2{ aOffsetTiling.z, aOffsetTiling.w } * scale
+		};
+	}
+
+	avk::image create_texture_atlas(const texture_atlas_plan& aAtlas, std::span<image_data> aTextures, avk::image_usage aImageUsage, avk::sync aSyncHandler)
+	{
+		assert(!aAtlas.mPlacements.empty());
+		auto& firstTexture = aTextures[aAtlas.mPlacements.front().mCandidate];
+		const size_t texelSize = texel_block_size(aAtlas.mFormat, firstTexture.extent(0), firstTexture.size(0));
+		const size_t rowSize = static_cast<size_t>(aAtlas.mExtent.width) * texelSize;
+
+		auto& commandBuffer = aSyncHandler.get_or_create_command_buffer();
+		aSyncHandler.establish_barrier_before_the_operation(avk::pipeline_stage::transfer, avk::read_memory_access{ avk::memory_access::transfer_read_access });
+
+		auto img = context().create_image(aAtlas.mExtent.width, aAtlas.mExtent.height, aAtlas.mFormat, 1, avk::memory_usage::device, aImageUsage, [&aAtlas](avk::image_t& image) {
+			// Coarser levels would blend neighboring textures:
+			image.create_info().mipLevels = std::min(image.create_info().mipLevels, aAtlas.mLevels);
+		});
+		auto finalTargetLayout = img->target_layout(); // save for later, because first, we need to transfer something into it
+		img->transition_to_layout(vk::ImageLayout::eTransferDstOptimal, avk::sync::auxiliary_with_barriers(aSyncHandler, {}, {}));
+
+		std::vector<std::shared_ptr<void>> stagingLeases;
+		std::vector<avk::buffer> stagingBuffers;
+		upload_layer_level(aSyncHandler, commandBuffer, img, 0, 0, rowSize * aAtlas.mExtent.height, texelSize, [&](std::span<std::byte> bAtlas) {
+			// The space between the textures is never sampled, but it should not contain garbage either:
+			std::memset(bAtlas.data(), 0, bAtlas.size());
+			const auto padding = static_cast<int64_t>(aAtlas.mPadding);
+			for (const auto& placement : aAtlas.mPlacements) {
+				auto& texture = aTextures[placement.mCandidate];
+				const auto width = static_cast<int64_t>(texture.extent(0).width);
+				const auto height = static_cast<int64_t>(texture.extent(0).height);
+				const auto* texels = static_cast<const std::byte*>(texture.get_data(0, 0, 0));
+				assert(texel_block_size(aAtlas.mFormat, texture.extent(0), texture.size(0)) == texelSize);
+
+				// Every texel of the padding repeats the nearest edge texel of the texture:
+				for (int64_t y = -padding; y < height + padding; ++y) {
+					const auto* srcRow = texels + std::clamp<int64_t>(y, 0, height - 1) * width * texelSize;
+					auto* dstRow = bAtlas.data() + (static_cast<int64_t>(placement.mY) + y) * rowSize + placement.mX * texelSize;
+					for (int64_t x = -padding; x < 0; ++x) {
+						std::memcpy(dstRow + x * static_cast<int64_t>(texelSize), srcRow, texelSize);
+					}
+					std::memcpy(dstRow, srcRow, width * texelSize);
+					for (int64_t x = width; x < width + padding; ++x) {
+						std::memcpy(dstRow + x * texelSize, srcRow + (width - 1) * texelSize, texelSize);
+					}
+				}
+			}
+		}, stagingLeases, stagingBuffers);
+
+		if (img->create_info().mipLevels > 1) {
+			// The textures' own levels are not used, because the atlas' levels must contain the padding as well:
+			img->generate_mip_maps(avk::sync::auxiliary_with_barriers(aSyncHandler, {}, {}));
+		}
+
+		// The ring buffer's regions are recycled when the leases are destroyed along with the command buffer:
+		commandBuffer.set_custom_deleter([lOwnedStagingBuffers = std::move(stagingBuffers), lStagingLeases = std::move(stagingLeases)](){});
+
+		img->transition_to_layout(finalTargetLayout, avk::sync::auxiliary_with_barriers(aSyncHandler, {}, {}));
+		aSyncHandler.establish_barrier_after_the_operation(avk::pipeline_stage::transfer, avk::write_memory_access{ avk::memory_access::transfer_write_access });
+		auto result = aSyncHandler.submit_and_sync();
+		assert(!result.has_value());
+		return img;
+	}
+
+	avk::image create_texture_array(const texture_array_plan& aArray, std::span<image_data> aTextures, avk::image_usage aImageUsage, avk::sync aSyncHandler)
+	{
+		assert(!aArray.mCandidates.empty());
+		auto& firstTexture = aTextures[aArray.mCandidates.front()];
+		const auto format = firstTexture.get_format();
+		const auto extent = firstTexture.extent(0);
+		const auto numLevels = firstTexture.levels();
+		const auto numLayers = static_cast<uint32_t>(aArray.mCandidates.size());
+
+		auto& commandBuffer = aSyncHandler.get_or_create_command_buffer();
+		aSyncHandler.establish_barrier_before_the_operation(avk::pipeline_stage::transfer, avk::read_memory_access{ avk::memory_access::transfer_read_access });
+
+		auto img = context().create_image(extent.width, extent.height, format, static_cast<int>(numLayers), avk::memory_usage::device, aImageUsage, [&](avk::image_t& image) {
+			if (avk::is_block_compressed_format(format)) {
+				// Levels of compressed formats cannot be generated on the GPU => use the provided levels only
+				image.create_info().mipLevels = numLevels;
+			}
+			else if (numLevels > 1 && image.create_info().mipLevels > 1) {
+				image.create_info().mipLevels = numLevels;
+			}
+		});
+		auto finalTargetLayout = img->target_layout(); // save for later, because first, we need to transfer something into it
+		img->transition_to_layout(vk::ImageLayout::eTransferDstOptimal, avk::sync::auxiliary_with_barriers(aSyncHandler, {}, {}));
+
+		const auto uploadedLevels = std::min(numLevels, img->create_info().mipLevels);
+		std::vector<std::shared_ptr<void>> stagingLeases;
+		std::vector<avk::buffer> stagingBuffers;
+		for (uint32_t layer = 0; layer < numLayers; ++layer) {
+			auto& texture = aTextures[aArray.mCandidates[layer]];
+			assert(texture.get_format() == format && texture.extent(0) == extent && texture.levels() == numLevels);
+			for (uint32_t level = 0; level < uploadedLevels; ++level) {
+				const auto size = texture.size(level);
+				upload_layer_level(aSyncHandler, commandBuffer, img, layer, level, size, texel_block_size(format, texture.extent(level), size), [&](std::span<std::byte> bMemory) {
+					std::memcpy(bMemory.data(), texture.get_data(0, 0, level), size);
+				}, stagingLeases, stagingBuffers);
+			}
+		}
+
+		if (uploadedLevels == 1 && img->create_info().mipLevels > 1) {
+			// can't create MIP-maps for compressed formats
+			assert(!avk::is_block_compressed_format(format));
+			img->generate_mip_maps(avk::sync::auxiliary_with_barriers(aSyncHandler, {}, {}));
+		}
+
+		// The ring buffer's regions are recycled when the leases are destroyed along with the command buffer:
+		commandBuffer.set_custom_deleter([lOwnedStagingBuffers = std::move(stagingBuffers), lStagingLeases = std::move(stagingLeases)](){});
+
+		img->transition_to_layout(finalTargetLayout, avk::sync::auxiliary_with_barriers(aSyncHandler, {}, {}));
+		aSyncHandler.establish_barrier_after_the_operation(avk::pipeline_stage::transfer, avk::write_memory_access{ avk::memory_access::transfer_write_access });
+		auto result = aSyncHandler.submit_and_sync();
+		assert(!result.has_value());
+		return img;
+	}
+}
@@ -0,0 +1,103 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	uint64_t texture_registry::key(const std::string& aPath, bool aLoadSrgbIfApplicable, bool aFlip, int aPreferredNumberOfTextureComponents, avk::image_usage aImageUsage, texture_compression aCompression, std::optional<uint32_t> aMaxExtent)
+	{
+		return content_hash{}
+			.add(file_contents_hash(aPath))
+			.add(aLoadSrgbIfApplicable)
+			.add(aFlip)
+			.add(aPreferredNumberOfTextureComponents)
+			.add(aImageUsage)
+			.add(aCompression)
+			.add(aMaxExtent.value_or(0))
+			.value();
+	}
+
+	uint64_t texture_registry::file_contents_hash(const std::string& aPath)
+	{
+		std::error_code timeError, sizeError;
+		const auto lastWriteTime = std::filesystem::last_write_time(aPath, timeError);
+		const auto size = std::filesystem::file_size(aPath, sizeError);
+		if (timeError || sizeError) {
+			// Let content_hash report why the file cannot be hashed:
+			return content_hash{}.add_file(aPath).value();
+		}
+		{
+			std::scoped_lock lock(mMutex);
+			const auto it = mFileHashes.find(aPath);
+			if (mFileHashes.end() != it && it->second.mLastWriteTime == lastWriteTime && it->second.mSize == size) {
+				return it->second.mHash;
+			}
+		}
+		// The file is read without holding the lock, so that multiple files can be hashed in parallel:
+		const auto hash = content_hash{}.add_file(aPath).value();
+		std::scoped_lock lock(mMutex);
+		mFileHashes.insert_or_assign(aPath, file_hash{ lastWriteTime, size, hash });
+		return hash;
+	}
+
+	std::optional<avk::image_view> texture_registry::acquire(uint64_t aKey)
+	{
+		std::scoped_lock lock(mMutex);
+		const auto it = mTextures.find(aKey);
+		if (mTextures.end() == it) {
+			return {};
+		}
+		++mNumHits;
+		mBytesSaved += it->second.mSize;
+		return it->second.mImageView;
+	}
+
+	avk::image_view texture_registry::add(uint64_t aKey, avk::image_view aImageView, size_t aSize)
+	{
+		std::scoped_lock lock(mMutex);
+		aImageView.enable_shared_ownership();
+		const auto [it, inserted] = mTextures.try_emplace(aKey, registered_texture{ std::move(aImageView), aSize });
+		return it->second.mImageView;
+	}
+
+	size_t texture_registry::release_unused()
+	{
+		std::scoped_lock lock(mMutex);
+		size_t releasedBytes = 0;
+		for (auto it = std::begin(mTextures); it != std::end(mTextures);) {
+			if (0 == references_outside(it->second)) {
+				releasedBytes += it->second.mSize;
+				it = mTextures.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+		return releasedBytes;
+	}
+
+	void texture_registry::clear()
+	{
+		std::scoped_lock lock(mMutex);
+		mTextures.clear();
+	}
+
+	texture_registry_statistics texture_registry::statistics() const
+	{
+		std::scoped_lock lock(mMutex);
+		texture_registry_statistics result;
+		result.mNumTextures = mTextures.size();
+		for (const auto& [key, texture] : mTextures) {
+			result.mNumReferences += references_outside(texture);
+			result.mRegisteredBytes += texture.mSize;
+		}
+		result.mNumHits = mNumHits;
+		result.mBytesSaved = mBytesSaved;
+		return result;
+	}
+
+	size_t texture_registry::references_outside(const registered_texture& aTexture)
+	{
+		// Shared ownership is always enabled for registered image_views, and one reference is held by the registry itself:
+		const auto& sharedImageView = std::get<std::shared_ptr<avk::image_view_t>>(aTexture.mImageView);
+		return static_cast<size_t>(sharedImageView.use_count()) - 1;
+	}
+}
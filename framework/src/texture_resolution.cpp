@@ -0,0 +1,79 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	namespace
+	{
+		uint32_t longer_side(const vk::Extent3D& aExtent)
+		{
+			return std::max(aExtent.width, aExtent.height);
+		}
+
+		// The estimated GPU memory of a texture if its width and height do not exceed aMaxExtent
+		double estimated_size(const texture_resolution_request& aTexture, std::optional<uint32_t> aMaxExtent, bool aMipMapped)
+		{
+			const auto side = longer_side(aTexture.mExtent);
+			const auto scale = aMaxExtent.has_value() && side > *aMaxExtent ? static_cast<double>(*aMaxExtent) / side : 1.0;
+			const auto texels = static_cast<double>(aTexture.mExtent.width) * scale * static_cast<double>(aTexture.mExtent.height) * scale;
+			return texels * aTexture.mBytesPerTexel * (aMipMapped ? 4.0 / 3.0 : 1.0);
+		}
+
+		std::optional<uint32_t> min_extent(std::optional<uint32_t> a, std::optional<uint32_t> b)
+		{
+			if (!a.has_value()) {
+				return b;
+			}
+			return b.has_value() ? std::min(*a, *b) : a;
+		}
+	}
+
+	std::vector<std::optional<uint32_t>> fit_texture_resolutions(std::span<const texture_resolution_request> aTextures, std::optional<size_t> aMemoryBudget, uint32_t aMinExtent, bool aMipMapped)
+	{
+		auto totalSize = [&](std::optional<uint32_t> bGlobalMaxExtent) {
+			double total = 0.0;
+			for (const auto& texture : aTextures) {
+				total += estimated_size(texture, min_extent(texture.mMaxExtent, bGlobalMaxExtent), aMipMapped);
+			}
+			return total;
+		};
+
+		std::optional<uint32_t> globalMaxExtent;
+		if (aMemoryBudget.has_value() && totalSize({}) > static_cast<double>(*aMemoryBudget)) {
+			// Start at the largest texture, rounded up to a power of two, and halve until everything fits:
+			uint32_t largest = 1;
+			for (const auto& texture : aTextures) {
+				largest = std::max(largest, longer_side(texture.mExtent));
+			}
+			globalMaxExtent = std::bit_ceil(largest);
+			while (*globalMaxExtent / 2 >= std::max(aMinExtent, 1u) && totalSize(globalMaxExtent) > static_cast<double>(*aMemoryBudget)) {
+				*globalMaxExtent /= 2;
+			}
+			if (totalSize(globalMaxExtent) > static_cast<double>(*aMemoryBudget)) {
+				LOG_WARNING(fmt::format("The textures exceed the memory budget of {} bytes even with a maximum extent of {}.", *aMemoryBudget, *globalMaxExtent));
+			}
+		}
+
+		std::vector<std::optional<uint32_t>> result;
+		result.reserve(aTextures.size());
+		for (const auto& texture : aTextures) {
+			const auto maxExtent = min_extent(texture.mMaxExtent, globalMaxExtent);
+			result.push_back(maxExtent.has_value() && longer_side(texture.mExtent) > *maxExtent ? maxExtent : std::optional<uint32_t>{});
+		}
+		return result;
+	}
+
+	float bytes_per_texel(texture_compression aCompression)
+	{
+		switch (aCompression) {
+		case texture_compression::bc1:
+		case texture_compression::bc4:
+			return 0.5f;
+		case texture_compression::bc3:
+		case texture_compression::bc5:
+		case texture_compression::bc7:
+			return 1.0f;
+		default:
+			return 4.0f;
+		}
+	}
+}
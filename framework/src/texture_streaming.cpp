@@ -0,0 +1,233 @@
+#include <gvk.hpp>
+
+namespace gvk
+{
+	texture_streamer::texture_streamer(texture_streaming_config aConfig)
+		: invokee("texture_streamer")
+		, mConfig{ aConfig }
+	{
+	}
+
+	size_t texture_streamer::add_texture(image_data aImageData, avk::sampler aSampler, avk::image_usage aImageUsage)
+	{
+		aImageData.load();
+		if (aImageData.target() != vk::ImageType::e2D || aImageData.faces() != 1 || aImageData.layers() != 1) {
+			throw gvk::runtime_error(fmt::format("Only 2D textures can be streamed, but the image loaded from '{}' is not one.", aImageData.path()));
+		}
+		// Does nothing if the image data already contains MIP-maps or if they cannot be generated for its format:
+		aImageData.generate_mip_chain();
+
+		// The resident levels are copied from an image to the next one whenever the resident levels change:
+		streamed_texture texture{ std::move(aImageData), std::move(aSampler), aImageUsage | avk::image_usage::transfer_source };
+		texture.mSampler.enable_shared_ownership(); // The sampler is shared by all image_samplers of the texture
+
+		const auto numLevels = std::max(texture.mImageData.levels(), 1u);
+		for (uint32_t level = 0; level < numLevels; ++level) {
+			texture.mLevelSizes.push_back(texture.mImageData.size(level));
+		}
+		texture.mTailLevel = numLevels - 1;
+		while (texture.mTailLevel > 0) {
+			const auto e = texture.mImageData.extent(texture.mTailLevel - 1);
+			if (e.width > mConfig.mTailExtent || e.height > mConfig.mTailExtent) {
+				break;
+			}
+			--texture.mTailLevel;
+		}
+
+		// Nothing is resident yet:
+		texture.mFirstResidentLevel = numLevels;
+		make_resident_from_level(texture, texture.mTailLevel);
+
+		mTextures.push_back(std::move(texture));
+		return mTextures.size() - 1;
+	}
+
+	void texture_streamer::report_screen_coverage(size_t aTexture, float aCoveredPixels)
+	{
+		auto& texture = mTextures[aTexture];
+		texture.mCoveredPixels = 0 == texture.mUpdatesSinceReport ? std::max(texture.mCoveredPixels, aCoveredPixels) : aCoveredPixels;
+		texture.mUpdatesSinceReport = 0;
+	}
+
+	uint32_t texture_streamer::requested_level(size_t aTexture) const
+	{
+		const auto& texture = mTextures[aTexture];
+		if (texture.mCoveredPixels <= 0.0f) {
+			return texture.mTailLevel;
+		}
+		// Every level has a quarter of the texels of the previous one:
+		const auto e = texture.mImageData.extent(0);
+		const float texelsPerPixel = static_cast<float>(e.width) * static_cast<float>(e.height) / texture.mCoveredPixels;
+		const float level = std::floor(0.5f * std::log2(std::max(texelsPerPixel, 1.0f)) + mConfig.mLevelBias);
+		return std::min(static_cast<uint32_t>(std::max(level, 0.0f)), texture.mTailLevel);
+	}
+
+	void texture_streamer::update()
+	{
+		// Textures which need finer levels than they have, those covering most of the screen first:
+		std::vector<std::tuple<size_t, uint32_t>> requests;
+		for (size_t i = 0; i < mTextures.size(); ++i) {
+			if (const auto level = requested_level(i); level < mTextures[i].mFirstResidentLevel) {
+				requests.emplace_back(i, level);
+			}
+		}
+		std::sort(std::begin(requests), std::end(requests), [this](const auto& a, const auto& b) {
+			return mTextures[std::get<0>(a)].mCoveredPixels > mTextures[std::get<0>(b)].mCoveredPixels;
+		});
+
+		if (mResidentBytes > mConfig.mResidencyBudget) {
+			// The budget has been lowered => evict regardless of screen coverage
+			make_room(0, std::numeric_limits<float>::max(), nullptr);
+		}
+
+		size_t uploadedBytes = 0;
+		for (const auto& [index, requestedLevel] : requests) {
+			if (uploadedBytes >= mConfig.mMaxUploadBytesPerUpdate) {
+				break;
+			}
+			auto& texture = mTextures[index];
+
+			// Stream in as many levels as fit into the remaining upload budget, but at least one. Only the levels which are
+			// not resident yet are uploaded, the others are copied on the GPU:
+			auto level = requestedLevel;
+			while (level + 1 < texture.mFirstResidentLevel && uploadedBytes + bytes_from_level(texture, level) - bytes_from_level(texture, texture.mFirstResidentLevel) > mConfig.mMaxUploadBytesPerUpdate) {
+				++level;
+			}
+			const auto additionalBytes = bytes_from_level(texture, level) - bytes_from_level(texture, texture.mFirstResidentLevel);
+			if (!make_room(additionalBytes, texture.mCoveredPixels, &texture)) {
+				continue;
+			}
+			uploadedBytes += make_resident_from_level(texture, level);
+		}
+
+		// Forget the screen coverage of textures which have not been seen for a while
+		for (auto& texture : mTextures) {
+			if (++texture.mUpdatesSinceReport > mConfig.mCoverageRetentionUpdates) {
+				texture.mCoveredPixels = 0.0f;
+			}
+		}
+	}
+
+	size_t texture_streamer::bytes_from_level(const streamed_texture& aTexture, uint32_t aFirstLevel)
+	{
+		size_t bytes = 0;
+		for (auto level = static_cast<size_t>(aFirstLevel); level < aTexture.mLevelSizes.size(); ++level) {
+			bytes += aTexture.mLevelSizes[level];
+		}
+		return bytes;
+	}
+
+	bool texture_streamer::make_room(size_t aBytes, float aCoveredPixels, const streamed_texture* aExcluded)
+	{
+		while (mResidentBytes + aBytes > mConfig.mResidencyBudget) {
+			// Evict from textures which have finer levels than requested first, then from those with the lowest screen coverage.
+			// Tails are never evicted.
+			streamed_texture* victim = nullptr;
+			uint32_t victimLevel = 0;
+			bool victimHasUnrequestedLevels = false;
+			for (size_t i = 0; i < mTextures.size(); ++i) {
+				auto& texture = mTextures[i];
+				if (&texture == aExcluded || texture.mFirstResidentLevel >= texture.mTailLevel) {
+					continue;
+				}
+				const auto requested = requested_level(i);
+				const bool hasUnrequestedLevels = texture.mFirstResidentLevel < requested;
+				if (!hasUnrequestedLevels && texture.mCoveredPixels >= aCoveredPixels) {
+					continue;
+				}
+				if (nullptr == victim
+					|| (hasUnrequestedLevels && !victimHasUnrequestedLevels)
+					|| (hasUnrequestedLevels == victimHasUnrequestedLevels && texture.mCoveredPixels < victim->mCoveredPixels)) {
+					victim = &texture;
+					victimLevel = hasUnrequestedLevels ? requested : texture.mFirstResidentLevel + 1;
+					victimHasUnrequestedLevels = hasUnrequestedLevels;
+				}
+			}
+			if (nullptr == victim) {
+				return false;
+			}
+			// Evicting uploads nothing, the remaining levels are copied on the GPU:
+			make_resident_from_level(*victim, victimLevel);
+		}
+		return true;
+	}
+
+	size_t texture_streamer::make_resident_from_level(streamed_texture& aTexture, uint32_t aFirstLevel)
+	{
+		auto& imageData = aTexture.mImageData;
+		const auto numTotalLevels = static_cast<uint32_t>(aTexture.mLevelSizes.size());
+		const auto numLevels = numTotalLevels - aFirstLevel;
+		const auto extent = imageData.extent(aFirstLevel);
+		// The levels which are resident already are copied from the previous image, only the finer ones are uploaded:
+		const auto firstRetainedLevel = std::max(aFirstLevel, aTexture.mFirstResidentLevel);
+
+		auto sync = avk::sync::with_barriers(context().main_window()->command_buffer_lifetime_handler());
+		auto& commandBuffer = sync.get_or_create_command_buffer();
+		sync.establish_barrier_before_the_operation(avk::pipeline_stage::transfer, avk::read_memory_access{ avk::memory_access::transfer_read_access });
+
+		// The image has only the resident levels, its level 0 is aFirstLevel of the image data
+		auto img = context().create_image(extent.width, extent.height, imageData.get_format(), 1, avk::memory_usage::device, aTexture.mImageUsage, [numLevels](avk::image_t& image) {
+			image.create_info().mipLevels = numLevels;
+		});
+		auto finalTargetLayout = img->target_layout(); // save for later, because first, we need to transfer something into it
+		img->transition_to_layout(vk::ImageLayout::eTransferDstOptimal, avk::sync::auxiliary_with_barriers(sync, {}, {}));
+
+		if (firstRetainedLevel < numTotalLevels) {
+			auto& previousImage = aTexture.mImageSampler->get_image_view()->get_image();
+			const auto previousLayout = previousImage.current_layout();
+			previousImage.transition_to_layout(vk::ImageLayout::eTransferSrcOptimal, avk::sync::auxiliary_with_barriers(sync, {}, {}));
+			std::vector<vk::ImageCopy> copyRegions;
+			for (auto level = firstRetainedLevel; level < numTotalLevels; ++level) {
+				copyRegions.push_back(vk::ImageCopy()
+					.setSrcSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level - aTexture.mFirstResidentLevel, 0u, 1u))
+					.setSrcOffset({ 0, 0, 0 })
+					.setDstSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level - aFirstLevel, 0u, 1u))
+					.setDstOffset({ 0, 0, 0 })
+					.setExtent(imageData.extent(level)));
+			}
+			commandBuffer.handle().copyImage(previousImage.handle(), vk::ImageLayout::eTransferSrcOptimal, img->handle(), vk::ImageLayout::eTransferDstOptimal, copyRegions);
+			// Frames which have been recorded before may still sample the previous image:
+			previousImage.transition_to_layout(previousLayout, avk::sync::auxiliary_with_barriers(sync, {}, {}));
+		}
+
+		// The staging memory is taken from the context's ring buffer, and only if it is full, from dedicated staging buffers:
+		auto& stagingRing = context().staging_ring();
+		std::vector<std::shared_ptr<void>> stagingLeases;
+		std::vector<avk::buffer> stagingBuffers;
+		size_t uploadedBytes = 0;
+		for (auto level = aFirstLevel; level < firstRetainedLevel; ++level) {
+			const auto size = aTexture.mLevelSizes[level];
+			const auto* data = imageData.get_data(0, 0, level);
+			uploadedBytes += size;
+			// Memory writes are not overlapping => no barriers should be fine.
+			if (auto staging = stagingRing.allocate(size, std::lcm<size_t>(16, texel_block_size(imageData.get_format(), imageData.extent(level), size)))) {
+				std::memcpy(staging->mMemory.data(), data, size);
+				stagingRing.record_copy_to_image_layer_mip_level(commandBuffer, *staging, img.get(), 0, level - aFirstLevel);
+				stagingLeases.push_back(std::move(staging->mLease));
+			}
+			else {
+				auto& sb = stagingBuffers.emplace_back(context().create_buffer(
+					AVK_STAGING_BUFFER_MEMORY_USAGE,
+					vk::BufferUsageFlagBits::eTransferSrc,
+					avk::generic_buffer_meta::create_from_size(size)
+				));
+				sb->fill(data, 0, avk::sync::not_required());
+				avk::copy_buffer_to_image_layer_mip_level(avk::const_referenced(sb), avk::referenced(img), 0, level - aFirstLevel, {}, avk::sync::auxiliary_with_barriers(sync, {}, {}));
+			}
+		}
+
+		img->transition_to_layout(finalTargetLayout, avk::sync::auxiliary_with_barriers(sync, {}, {}));
+		sync.establish_barrier_after_the_operation(avk::pipeline_stage::transfer, avk::write_memory_access{ avk::memory_access::transfer_write_access });
+
+		// Frames in flight may still sample the previous image => keep it alive along with the command buffer, which is
+		// handled by the main window, i.e. destroyed after the current frame has been rendered.
+		commandBuffer.set_custom_deleter([lOwnedStagingBuffers = std::move(stagingBuffers), lStagingLeases = std::move(stagingLeases), lPreviousImageSampler = std::move(aTexture.mImageSampler)](){});
+		auto result = sync.submit_and_sync();
+		assert(!result.has_value());
+
+		aTexture.mImageSampler = context().create_image_sampler(avk::owned(context().create_image_view(avk::owned(img))), avk::shared(aTexture.mSampler));
+		mResidentBytes = mResidentBytes - bytes_from_level(aTexture, aTexture.mFirstResidentLevel) + bytes_from_level(aTexture, aFirstLevel);
+		aTexture.mFirstResidentLevel = aFirstLevel;
+		return uploadedBytes;
+	}
+}